@@ -1,7 +1,7 @@
 /*
  * Data serialization, deserialization, etc. for communication purpose.
  *
- * Copyright (c) 2022-2025 Man Hung-Coeng <udc577@126.com>
+ * Copyright (c) 2022-2026 Man Hung-Coeng <udc577@126.com>
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -24,6 +24,14 @@
 #include <string.h> /* For memset(). */
 #include <stdlib.h> /* For exit(). */
 
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+#include <errno.h>
+#include <fcntl.h> /* For open(). */
+#include <unistd.h> /* For close(). */
+#include <sys/stat.h> /* For fstat(). */
+#include <sys/mman.h> /* For mmap() and munmap(). */
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -43,6 +51,9 @@ enum
     , COMMPROTO_ERR_STRUCT_PTR_EXCEEDS
     , COMMPROTO_ERR_INCOMPLETE_BUF_CONTENTS
     , COMMPROTO_ERR_STRUCT_ARRAY_TOO_BIG
+    , COMMPROTO_ERR_NULL_CONTEXT
+    , COMMPROTO_ERR_FIELD_OUT_OF_RANGE
+    , COMMPROTO_ERR_FIELD_TYPE_MISMATCHED
 
     , COMMPROTO_ERR_END /* NOTE: All error codes should be defined ahead of this. */
 };
@@ -61,6 +72,9 @@ static const char* const S_ERRORS[] = {
     , "Structure pointer exceeds"
     , "Incomplete buffer contents"
     , "Structure array too big"
+    , "Null context"
+    , "Field index out of range"
+    , "Field type mismatched"
 };
 
 const char* commproto_error(int error_code)
@@ -76,7 +90,7 @@ const char* commproto_error(int error_code)
 
 static bool s_is_initialized = false;
 
-int commproto_init(void)
+static void check_byte_order(void)
 {
     union
     {
@@ -98,6 +112,11 @@ int commproto_init(void)
             " __ORDER_BIG_ENDIAN__ and __ORDER_LITTLE_ENDIAN__, then recompile this file!\n", __LINE__);
         exit(EXIT_FAILURE);
     }
+}
+
+int commproto_init(void)
+{
+    check_byte_order();
 
     s_is_initialized = true;
 
@@ -233,6 +252,7 @@ static int general_serialization(int16_t fields, int32_t loops, bool can_have_in
     uint8_t *struct_ptr_start = *struct_pptr;
 #endif
     uint8_t *new_buf = NULL;
+    uint32_t new_capacity = 0;
     int err = 0;
     int32_t loop = 1;
 
@@ -323,19 +343,20 @@ static int general_serialization(int16_t fields, int32_t loops, bool can_have_in
                     continue;
                 }
 
-                *buf_capacity_ptr = COMMPROTO_EXPAND_BUFSIZE(*buf_capacity_ptr);
-                if (*buf_capacity_ptr > max_buf_len || *handled_len_ptr + data_offset > *buf_capacity_ptr)
+                new_capacity = COMMPROTO_EXPAND_BUFSIZE(*buf_capacity_ptr);
+                if (new_capacity > max_buf_len || *handled_len_ptr + data_offset > new_capacity)
                 {
                     err = -COMMPROTO_ERR_PACKET_TOO_BIG;
                     continue;
                 }
 
-                if (NULL == (new_buf = (uint8_t *)realloc(*buf_pptr, *buf_capacity_ptr)))
+                if (NULL == (new_buf = (uint8_t *)realloc(*buf_pptr, new_capacity)))
                 {
                     err = -COMMPROTO_ERR_MEM_ALLOC;
                     continue;
                 }
                 *buf_pptr = new_buf;
+                *buf_capacity_ptr = new_capacity; /* NOTE: Keep the old capacity on failure for a reusable buffer. */
                 COMMPROTO_DPRINT("Expanded new_buf addr = %p, buf_capacity = %u\n", new_buf, *buf_capacity_ptr);
             }
 
@@ -825,11 +846,13 @@ static int general_clear(int16_t fields, int32_t loops, bool can_have_inner_stru
                         (is_dynamic_struct_array ? &inner_struct_ptr : struct_pptr));
                 if (is_dynamic_struct_array && err >= 0)
                 {
+                    bool is_skipped = (0 == struct_array_len || NULL == (uint8_t *)**(ptrdiff_t **)struct_pptr);
+
                     free((uint8_t *)**(ptrdiff_t **)struct_pptr); /* NOTE: DO NOT: free(inner_struct_ptr); */
                     COMMPROTO_DPRINT("Freed a struct array: %p\n", (uint8_t *)**(ptrdiff_t **)struct_pptr);
                     **(ptrdiff_t **)struct_pptr = (ptrdiff_t)NULL;
                     *struct_pptr += sizeof(ptrdiff_t);
-                    if (0 == struct_array_len)
+                    if (is_skipped) /* NOTE: The array may have been cleared before, with its length field kept. */
                         calc_struct_size_or_move_meta_ptr(struct_field_count, *meta_pptr, meta_len, meta_pptr);
                 }
             }
@@ -945,6 +968,542 @@ void commproto_dump_buffer(const uint8_t *buf, uint32_t size, FILE *nullable_str
         *nullable_holder = '\0';
 }
 
+int commproto_ctx_init(commproto_ctx_t *ctx, uint32_t max_buf_len)
+{
+    if (NULL == ctx)
+        return -COMMPROTO_ERR_NULL_CONTEXT;
+
+    check_byte_order();
+
+    memset(ctx, 0, sizeof(commproto_ctx_t));
+    ctx->max_buf_len = (0 == max_buf_len) ? COMMPROTO_MAX_BUFSIZE : max_buf_len;
+    ctx->is_initialized = 1;
+
+    return 0;
+}
+
+void commproto_ctx_release(commproto_ctx_t *ctx)
+{
+    if (NULL == ctx)
+        return;
+
+    if (NULL != ctx->out_buf)
+        free(ctx->out_buf);
+
+    memset(ctx, 0, sizeof(commproto_ctx_t));
+}
+
+static int32_t ctx_struct_size(commproto_ctx_t *ctx, const uint8_t *struct_meta_data, uint32_t meta_len)
+{
+    commproto_plan_t *plan = NULL;
+    uint32_t i = 0;
+
+    for (; i < COMMPROTO_CTX_PLAN_SLOTS; ++i)
+    {
+        plan = &ctx->plans[i];
+        if (struct_meta_data == plan->meta_data && meta_len == plan->meta_len)
+        {
+            ctx->stats.plan_hits += 1;
+
+            return plan->struct_size;
+        }
+    }
+
+    plan = &ctx->plans[ctx->plan_cursor];
+    ctx->plan_cursor = (ctx->plan_cursor + 1) % COMMPROTO_CTX_PLAN_SLOTS; /* Round-robin replacement. */
+    plan->meta_data = struct_meta_data;
+    plan->meta_len = meta_len;
+    plan->struct_size = calc_struct_size_or_move_meta_ptr(0xffff / 2, struct_meta_data, meta_len, NULL);
+    ctx->stats.plan_misses += 1;
+
+    return plan->struct_size;
+}
+
+commproto_result_t commproto_ctx_serialize(commproto_ctx_t *ctx, const uint8_t *struct_meta_data, uint32_t meta_len,
+    const void *one_byte_aligned_struct)
+{
+    uint8_t *meta_ptr = (uint8_t *)struct_meta_data;
+    uint8_t *struct_ptr = (uint8_t *)one_byte_aligned_struct;
+    uint32_t old_capacity = 0;
+    commproto_result_t result = { 0 };
+
+    if (NULL == ctx || !ctx->is_initialized)
+    {
+        result.error_code = (NULL == ctx) ? -COMMPROTO_ERR_NULL_CONTEXT : -COMMPROTO_ERR_NOT_INITIALIZED;
+
+        return result;
+    }
+
+    if (NULL == ctx->out_buf)
+    {
+        if (NULL == (ctx->out_buf = (uint8_t *)malloc(COMMPROTO_INITIAL_BUFSIZE)))
+        {
+            result.error_code = -COMMPROTO_ERR_MEM_ALLOC;
+            goto CTX_SERIALIZE_END;
+        }
+        ctx->out_capacity = COMMPROTO_INITIAL_BUFSIZE;
+    }
+    old_capacity = ctx->out_capacity;
+
+    result.error_code = general_serialization(
+        /* fields = */0xffff / 2, /* loops = */1, /* can_have_inner_struct = */true,
+        struct_meta_data, meta_len, &meta_ptr,
+        &struct_ptr, /* is_static_buf = */false, ctx->max_buf_len,
+        &ctx->out_buf, &ctx->out_capacity, &result.handled_len
+    );
+    result.buf_ptr = ctx->out_buf;
+    result.buf_len = ctx->out_capacity;
+
+    if (ctx->out_capacity != old_capacity)
+        ctx->stats.buf_expansions += 1;
+
+CTX_SERIALIZE_END:
+
+    if (result.error_code < 0)
+        ctx->stats.failures += 1;
+    else
+    {
+        ctx->stats.serializations += 1;
+        ctx->stats.bytes_serialized += result.handled_len;
+    }
+
+    return result;
+}
+
+commproto_result_t commproto_ctx_parse(commproto_ctx_t *ctx, const uint8_t *struct_meta_data, uint32_t meta_len,
+    const uint8_t *buf_ptr, uint32_t buf_len, void *one_byte_aligned_struct)
+{
+    uint8_t *meta_ptr = (uint8_t *)struct_meta_data;
+    uint8_t *struct_ptr = (uint8_t *)one_byte_aligned_struct;
+    int32_t struct_size = 0;
+    commproto_result_t result = { 0 };
+
+    result.buf_ptr = (uint8_t *)buf_ptr;
+    result.buf_len = buf_len;
+
+    if (NULL == ctx || !ctx->is_initialized)
+    {
+        result.error_code = (NULL == ctx) ? -COMMPROTO_ERR_NULL_CONTEXT : -COMMPROTO_ERR_NOT_INITIALIZED;
+
+        return result;
+    }
+
+    struct_size = ctx_struct_size(ctx, struct_meta_data, meta_len);
+    result.error_code = (struct_size < 0)
+        ? struct_size
+        : (
+            (0 == result.buf_len)
+            ? -COMMPROTO_ERR_ZERO_LENGTH
+            : general_deserialization(
+                /* fields = */0xffff / 2, /* loops = */1, /* can_have_inner_struct = */true,
+                struct_meta_data, meta_len, &meta_ptr, result.buf_ptr, result.buf_len,
+                &struct_ptr, struct_size, &result.handled_len
+            )
+        );
+
+    if (result.error_code < 0)
+        ctx->stats.failures += 1;
+    else
+    {
+        ctx->stats.parses += 1;
+        ctx->stats.bytes_parsed += result.handled_len;
+    }
+
+    return result;
+}
+
+void commproto_ctx_clear(commproto_ctx_t *ctx, const uint8_t *struct_meta_data, uint32_t meta_len,
+    void *one_byte_aligned_struct)
+{
+    if (NULL != ctx && ctx->is_initialized)
+    {
+        uint8_t *meta_ptr = (uint8_t *)struct_meta_data;
+        uint8_t *struct_ptr = (uint8_t *)one_byte_aligned_struct;
+
+        general_clear(/* fields = */0xffff / 2, /* loops = */1, /* can_have_inner_struct = */true,
+            struct_meta_data, meta_len, &meta_ptr, &struct_ptr);
+    }
+}
+
+#define IS_FLOAT_FIELD(type)        (COMMPROTO_FLOAT32 == (type) || COMMPROTO_FLOAT64 == (type) \
+    || COMMPROTO_FLOAT32_DYNAMIC_ARRAY == (type) || COMMPROTO_FLOAT64_DYNAMIC_ARRAY == (type) \
+    || COMMPROTO_FLOAT32_FIXED_ARRAY == (type) || COMMPROTO_FLOAT64_FIXED_ARRAY == (type))
+
+static int view_step(const uint8_t *meta_ptr, uint32_t meta_len, const uint8_t *buf_ptr, uint32_t buf_len,
+    bool can_have_inner_struct, commproto_view_mark_t *mark, commproto_field_t *field);
+
+static int view_skip_struct(const commproto_field_t *field, const uint8_t *buf_ptr, uint32_t buf_len,
+    commproto_view_mark_t *mark)
+{
+    commproto_field_t sub_field;
+    int16_t i = 0;
+    int err = 0;
+
+    mark->meta_offset = 0;
+
+    for (; i < field->sub_field_count && mark->meta_offset < field->sub_meta_len; ++i)
+    {
+        if ((err = view_step(field->sub_meta_data, field->sub_meta_len, buf_ptr, buf_len,
+            /* can_have_inner_struct = */false, mark, &sub_field)) < 0)
+        {
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+static int view_step(const uint8_t *meta_ptr, uint32_t meta_len, const uint8_t *buf_ptr, uint32_t buf_len,
+    bool can_have_inner_struct, commproto_view_mark_t *mark, commproto_field_t *field)
+{
+    const uint8_t *meta = meta_ptr + mark->meta_offset;
+    uint32_t meta_offset = sizeof(int8_t);
+    uint8_t type = 0;
+
+    if (mark->meta_offset >= meta_len)
+        return -COMMPROTO_ERR_FIELD_OUT_OF_RANGE;
+
+    type = *meta;
+    memset(field, 0, sizeof(commproto_field_t));
+    field->type = type;
+    field->count = 1;
+
+    switch (type) /* Step 1: Determine item sizes and array lengths. */
+    {
+    case COMMPROTO_INT8:
+    case COMMPROTO_INT16:
+    case COMMPROTO_INT32:
+    case COMMPROTO_INT64:
+    case COMMPROTO_FLOAT32:
+    case COMMPROTO_FLOAT64:
+    case COMMPROTO_ARRAY_LEN8:
+    case COMMPROTO_ARRAY_LEN16:
+    case COMMPROTO_ARRAY_LEN32:
+        field->item_size = (type % 10);
+        break;
+
+    case COMMPROTO_INT8_DYNAMIC_ARRAY:
+    case COMMPROTO_INT16_DYNAMIC_ARRAY:
+    case COMMPROTO_INT32_DYNAMIC_ARRAY:
+    case COMMPROTO_INT64_DYNAMIC_ARRAY:
+    case COMMPROTO_FLOAT32_DYNAMIC_ARRAY:
+    case COMMPROTO_FLOAT64_DYNAMIC_ARRAY:
+        if (mark->simple_array_len < 0)
+            return -COMMPROTO_ERR_META_ARRAY_LENGTH_MISSING;
+        field->item_size = (type % 10);
+        field->count = mark->simple_array_len;
+        break;
+
+    case COMMPROTO_INT8_FIXED_ARRAY:
+    case COMMPROTO_INT16_FIXED_ARRAY:
+    case COMMPROTO_INT32_FIXED_ARRAY:
+    case COMMPROTO_INT64_FIXED_ARRAY:
+    case COMMPROTO_FLOAT32_FIXED_ARRAY:
+    case COMMPROTO_FLOAT64_FIXED_ARRAY:
+        field->item_size = (type % 10);
+        field->count = mark->simple_array_len = *((uint16_t *)(meta + sizeof(int8_t)));
+        meta_offset += sizeof(uint16_t);
+        break;
+
+    case COMMPROTO_STRUCT_DYNAMIC_ARRAY:
+    case COMMPROTO_STRUCT_FIXED_ARRAY:
+        if (!can_have_inner_struct)
+            return -COMMPROTO_ERR_WRONG_META_DATA;
+        if (COMMPROTO_STRUCT_DYNAMIC_ARRAY == type && mark->struct_array_len < 0)
+            return -COMMPROTO_ERR_META_ARRAY_LENGTH_MISSING;
+        field->sub_field_count = *((int16_t *)(meta + sizeof(int8_t)));
+        meta_offset += sizeof(int16_t);
+        if (COMMPROTO_STRUCT_FIXED_ARRAY == type)
+        {
+            mark->struct_array_len = *((uint16_t *)(meta + meta_offset));
+            meta_offset += sizeof(uint16_t);
+        }
+        field->count = mark->struct_array_len;
+        break;
+
+    default:
+        return -COMMPROTO_ERR_UNKNOWN_FIELD_TYPE;
+    } /* switch (type) */
+
+    field->data = buf_ptr + mark->buf_offset;
+
+    if (type < COMMPROTO_SIMPLE_FIELD_TYPE_END) /* Step 2: Locate the end of this field. */
+    {
+        /* The count may come from an untrusted length prefix, so the product must not be trusted to fit 32 bits. */
+        if (mark->buf_offset > buf_len || field->count > (buf_len - mark->buf_offset) / field->item_size)
+            return -COMMPROTO_ERR_INCOMPLETE_BUF_CONTENTS;
+        field->size = field->item_size * field->count;
+
+        if (COMMPROTO_ARRAY_LEN8 == type)
+        {
+            uint8_t array_len = 0;
+
+            COMMPROTO_SET_INT8(field->data, &array_len);
+            mark->simple_array_len = mark->struct_array_len = array_len;
+        }
+        else if (COMMPROTO_ARRAY_LEN16 == type)
+        {
+            uint16_t array_len = 0;
+
+            COMMPROTO_SET_INT16(field->data, &array_len);
+            mark->simple_array_len = mark->struct_array_len = array_len;
+        }
+        else if (COMMPROTO_ARRAY_LEN32 == type)
+        {
+            uint32_t array_len = 0;
+
+            COMMPROTO_SET_INT32(field->data, &array_len);
+            mark->simple_array_len = mark->struct_array_len = array_len;
+        }
+    }
+    else
+    {
+        uint8_t *sub_meta_end = NULL;
+        commproto_view_mark_t sub_mark;
+        uint32_t i = 0;
+        int err = 0;
+
+        field->sub_meta_data = meta + meta_offset;
+        if (calc_struct_size_or_move_meta_ptr(field->sub_field_count, field->sub_meta_data,
+            meta_len - (field->sub_meta_data - meta_ptr), &sub_meta_end) < 0)
+        {
+            return -COMMPROTO_ERR_WRONG_META_DATA;
+        }
+        field->sub_meta_len = sub_meta_end - field->sub_meta_data;
+        meta_offset += field->sub_meta_len;
+
+        /*
+         * The count may come from an untrusted length prefix too, and an element of zero bytes
+         * would let a huge one spin without consuming anything, so take each element as one byte at least.
+         */
+        if (mark->buf_offset > buf_len || field->count > buf_len - mark->buf_offset)
+            return -COMMPROTO_ERR_INCOMPLETE_BUF_CONTENTS;
+
+        sub_mark.buf_offset = mark->buf_offset;
+        sub_mark.simple_array_len = sub_mark.struct_array_len = -1;
+        for (; i < field->count; ++i)
+        {
+            if ((err = view_skip_struct(field, buf_ptr, buf_len, &sub_mark)) < 0)
+                return err;
+        }
+        field->size = sub_mark.buf_offset - mark->buf_offset;
+    }
+
+    mark->meta_offset += meta_offset;
+    mark->buf_offset += field->size;
+
+    return 0;
+}
+
+int commproto_view_init(commproto_view_t *view, const uint8_t *struct_meta_data, uint32_t meta_len,
+    const uint8_t *buf_ptr, uint32_t buf_len)
+{
+    memset(view, 0, sizeof(commproto_view_t));
+    view->meta_data = struct_meta_data;
+    view->meta_len = meta_len;
+    view->buf_ptr = buf_ptr;
+    view->buf_len = buf_len;
+    view->field_limit = 0xffff / 2;
+    view->cursor.simple_array_len = view->cursor.struct_array_len = -1;
+    view->marks[0] = view->cursor;
+
+    return 0;
+}
+
+int commproto_view_field(commproto_view_t *view, int16_t field_index, commproto_field_t *field)
+{
+    bool can_have_inner_struct = (0xffff / 2 == view->field_limit);
+    commproto_view_mark_t mark;
+    int16_t index = 0;
+    int err = 0;
+
+    if (field_index < 0 || field_index >= view->field_limit)
+        return -COMMPROTO_ERR_FIELD_OUT_OF_RANGE;
+
+    if (field_index <= view->resolved_fields && field_index < COMMPROTO_VIEW_CACHED_FIELDS)
+    {
+        index = field_index;
+        mark = view->marks[index];
+    }
+    else if (field_index >= view->resolved_fields)
+    {
+        index = view->resolved_fields;
+        mark = view->cursor;
+    }
+    else
+    {
+        index = COMMPROTO_VIEW_CACHED_FIELDS - 1;
+        mark = view->marks[index];
+    }
+
+    while (1)
+    {
+        if ((err = view_step(view->meta_data, view->meta_len, view->buf_ptr, view->buf_len,
+            can_have_inner_struct, &mark, field)) < 0)
+        {
+            return err;
+        }
+
+        if (index + 1 > view->resolved_fields)
+        {
+            view->resolved_fields = index + 1;
+            view->cursor = mark;
+            if (index + 1 < COMMPROTO_VIEW_CACHED_FIELDS)
+                view->marks[index + 1] = mark;
+        }
+
+        if (index == field_index)
+            break;
+
+        ++index;
+    }
+
+    return 0;
+}
+
+int32_t commproto_view_size(commproto_view_t *view)
+{
+    commproto_field_t field;
+    int err = 0;
+
+    while (view->resolved_fields < view->field_limit && view->cursor.meta_offset < view->meta_len)
+    {
+        if ((err = commproto_view_field(view, view->resolved_fields, &field)) < 0)
+            return err;
+    }
+
+    return view->cursor.buf_offset;
+}
+
+int commproto_view_element(const commproto_field_t *field, uint32_t item_index, commproto_view_t *sub_view)
+{
+    commproto_view_mark_t mark;
+    uint32_t i = 0;
+    int err = 0;
+
+    if (COMMPROTO_STRUCT_DYNAMIC_ARRAY != field->type && COMMPROTO_STRUCT_FIXED_ARRAY != field->type)
+        return -COMMPROTO_ERR_FIELD_TYPE_MISMATCHED;
+
+    if (item_index >= field->count)
+        return -COMMPROTO_ERR_FIELD_OUT_OF_RANGE;
+
+    mark.buf_offset = 0;
+    mark.simple_array_len = mark.struct_array_len = -1;
+    for (; i < item_index; ++i)
+    {
+        if ((err = view_skip_struct(field, field->data, field->size, &mark)) < 0)
+            return err;
+    }
+
+    commproto_view_init(sub_view, field->sub_meta_data, field->sub_meta_len,
+        field->data + mark.buf_offset, field->size - mark.buf_offset);
+    sub_view->field_limit = field->sub_field_count;
+    sub_view->cursor.simple_array_len = mark.simple_array_len;
+    sub_view->cursor.struct_array_len = mark.struct_array_len;
+    sub_view->marks[0] = sub_view->cursor;
+
+    return 0;
+}
+
+const void* commproto_field_array(const commproto_field_t *field)
+{
+    if (0 == field->item_size)
+        return NULL;
+
+    if (1 == field->item_size)
+        return field->data;
+
+    if (IS_FLOAT_FIELD(field->type))
+        return COMMPROTO_FLOAT_IS_SAME_ENDIAN ? field->data : NULL;
+
+    return COMMPROTO_INT_IS_SAME_ENDIAN ? field->data : NULL;
+}
+
+int commproto_field_get(const commproto_field_t *field, uint32_t item_index, void *dest_ptr)
+{
+    const uint8_t *src_ptr = field->data + field->item_size * item_index;
+    bool is_float = IS_FLOAT_FIELD(field->type);
+
+    if (0 == field->item_size)
+        return -COMMPROTO_ERR_FIELD_TYPE_MISMATCHED;
+
+    if (item_index >= field->count)
+        return -COMMPROTO_ERR_FIELD_OUT_OF_RANGE;
+
+    switch (field->item_size)
+    {
+    case sizeof(int8_t):
+        COMMPROTO_SET_INT8(src_ptr, dest_ptr);
+        break;
+
+    case sizeof(int16_t):
+        COMMPROTO_SET_INT16(src_ptr, dest_ptr);
+        break;
+
+    case sizeof(int32_t):
+        if (is_float)
+            COMMPROTO_SET_FLOAT32(src_ptr, dest_ptr);
+        else
+            COMMPROTO_SET_INT32(src_ptr, dest_ptr);
+        break;
+
+    case sizeof(int64_t):
+        if (is_float)
+            COMMPROTO_SET_FLOAT64(src_ptr, dest_ptr);
+        else
+            COMMPROTO_SET_INT64(src_ptr, dest_ptr);
+        break;
+
+    default:
+        return -COMMPROTO_ERR_UNKNOWN_FIELD_TYPE;
+    }
+
+    return field->item_size;
+}
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+
+int commproto_map_file(const char *path, commproto_mapping_t *mapping)
+{
+    struct stat file_stat;
+    void *addr = NULL;
+    int fd = open(path, O_RDONLY);
+    int err = 0;
+
+    mapping->buf_ptr = NULL;
+    mapping->buf_len = 0;
+
+    if (fd < 0)
+        return -(errno + COMMPROTO_ERR_END);
+
+    if (fstat(fd, &file_stat) < 0)
+        err = -(errno + COMMPROTO_ERR_END);
+    else if (0 == file_stat.st_size)
+        err = -COMMPROTO_ERR_ZERO_LENGTH;
+    else if (MAP_FAILED == (addr = mmap(NULL, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0)))
+        err = -(errno + COMMPROTO_ERR_END);
+    else
+    {
+        mapping->buf_ptr = (const uint8_t *)addr;
+        mapping->buf_len = file_stat.st_size;
+    }
+
+    close(fd); /* NOTE: The mapping stays valid after the descriptor is closed. */
+
+    return err;
+}
+
+void commproto_unmap_file(commproto_mapping_t *mapping)
+{
+    if (NULL != mapping->buf_ptr)
+        munmap((void *)mapping->buf_ptr, mapping->buf_len);
+
+    mapping->buf_ptr = NULL;
+    mapping->buf_len = 0;
+}
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -1000,5 +1559,17 @@ void commproto_dump_buffer(const uint8_t *buf, uint32_t size, FILE *nullable_str
  *
  * >>> 2025-03-05, Man Hung-Coeng:
  *  01. Describe COMMPROTO_ERR_NOT_INITIALIZED more detailedly.
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Add commproto_ctx_t and commproto_ctx_*() for per-thread codec contexts
+ *      with reusable output buffers, cached struct sizes and statistics.
+ *  02. Keep the buffer capacity unchanged on reallocation failure
+ *      in general_serialization().
+ *  03. Fix the wrong meta pointer in general_clear() when a dynamic struct array
+ *      has been cleared before, which makes a second clear of the same struct crash.
+ *  04. Add commproto_view_*(), commproto_field_*() and commproto_{map,unmap}_file()
+ *      for zero-copy read-only access to serialized buffers.
+ *  05. Reject struct arrays of views whose counts exceed the rest of the buffer,
+ *      which would otherwise spin over empty elements.
  */
 
@@ -1,7 +1,7 @@
 /*
  * Data serialization, deserialization, etc. for communication purpose.
  *
- * Copyright (c) 2022-2023 Man Hung-Coeng <udc577@126.com>
+ * Copyright (c) 2022-2026 Man Hung-Coeng <udc577@126.com>
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -61,6 +61,15 @@
 #define COMMPROTO_CPP_CLEAR(struct_ptr)                         \
     commproto_clear((struct_ptr)->meta_data(), (struct_ptr)->meta_size(), struct_ptr)
 
+#define COMMPROTO_CPP_CTX_SERIALIZE(ctx, struct_ptr)            \
+    commproto_ctx_serialize(ctx, (struct_ptr)->meta_data(), (struct_ptr)->meta_size(), struct_ptr)
+
+#define COMMPROTO_CPP_CTX_PARSE(ctx, buf_ptr, buf_len, struct_ptr)  \
+    commproto_ctx_parse(ctx, (struct_ptr)->meta_data(), (struct_ptr)->meta_size(), buf_ptr, buf_len, struct_ptr)
+
+#define COMMPROTO_CPP_CTX_CLEAR(ctx, struct_ptr)                \
+    commproto_ctx_clear(ctx, (struct_ptr)->meta_data(), (struct_ptr)->meta_size(), struct_ptr)
+
 /* NOTE: These macros are only suitable for structs CONTAINING virtual functions! */
 
 #define COMMPROTO_CPP_VSERIALIZE(struct_ptr, buf_ptr, buf_len)  \
@@ -108,6 +117,159 @@ void commproto_clear(const uint8_t *struct_meta_data, uint32_t meta_len, void *o
 
 void commproto_dump_buffer(const uint8_t *buf, uint32_t size, FILE *nullable_stream, char *nullable_holder);
 
+/*
+ * ================
+ *  CONTEXT
+ * ================
+ */
+
+#ifndef COMMPROTO_CTX_PLAN_SLOTS
+#define COMMPROTO_CTX_PLAN_SLOTS                        8
+#endif
+
+#if COMMPROTO_CTX_PLAN_SLOTS < 1
+#error COMMPROTO_CTX_PLAN_SLOTS must be greater than 0!
+#endif
+
+typedef struct commproto_plan_t
+{
+    const uint8_t *meta_data; /* Identity of the plan, compared by address. */
+    uint32_t meta_len;
+    int32_t struct_size;
+} commproto_plan_t;
+
+typedef struct commproto_stats_t
+{
+    uint32_t serializations;
+    uint32_t parses;
+    uint32_t failures;
+    uint32_t buf_expansions;
+    uint32_t plan_hits;
+    uint32_t plan_misses;
+    uint64_t bytes_serialized;
+    uint64_t bytes_parsed;
+} commproto_stats_t;
+
+/*
+ * An explicit codec context which owns everything a serialization or deserialization needs,
+ * so that each thread can own one and run without any shared state or repeated buffer allocation.
+ * NOTE: A context itself is NOT thread-safe, do not share it among threads without a lock.
+ */
+typedef struct commproto_ctx_t
+{
+    int is_initialized;
+    uint32_t max_buf_len;
+    uint8_t *out_buf; /* Reused by every commproto_ctx_serialize(), released by commproto_ctx_release(). */
+    uint32_t out_capacity;
+    uint32_t plan_cursor;
+    commproto_plan_t plans[COMMPROTO_CTX_PLAN_SLOTS]; /* Struct sizes calculated from meta data previously. */
+    commproto_stats_t stats;
+} commproto_ctx_t;
+
+/* NOTE: max_buf_len = 0 means COMMPROTO_MAX_BUFSIZE. */
+int commproto_ctx_init(commproto_ctx_t *ctx, uint32_t max_buf_len);
+
+void commproto_ctx_release(commproto_ctx_t *ctx);
+
+/*
+ * NOTE: On success, result.buf_ptr points to ctx->out_buf, which MUST NOT be freed by the caller,
+ * and its contents remain valid only until the next commproto_ctx_serialize() on the same context.
+ */
+commproto_result_t commproto_ctx_serialize(commproto_ctx_t *ctx, const uint8_t *struct_meta_data, uint32_t meta_len,
+    const void *one_byte_aligned_struct);
+
+commproto_result_t commproto_ctx_parse(commproto_ctx_t *ctx, const uint8_t *struct_meta_data, uint32_t meta_len,
+    const uint8_t *buf_ptr, uint32_t buf_len, void *one_byte_aligned_struct);
+
+void commproto_ctx_clear(commproto_ctx_t *ctx, const uint8_t *struct_meta_data, uint32_t meta_len,
+    void *one_byte_aligned_struct);
+
+/*
+ * ================
+ *  VIEW
+ * ================
+ */
+
+#ifndef COMMPROTO_VIEW_CACHED_FIELDS
+#define COMMPROTO_VIEW_CACHED_FIELDS                    32
+#endif
+
+#if COMMPROTO_VIEW_CACHED_FIELDS < 1
+#error COMMPROTO_VIEW_CACHED_FIELDS must be greater than 0!
+#endif
+
+typedef struct commproto_field_t
+{
+    uint8_t type;
+    uint8_t item_size; /* 0 for struct arrays. */
+    uint32_t count; /* 1 for single fields, or length of an array. */
+    const uint8_t *data; /* Points into the viewed buffer directly. */
+    uint32_t size; /* Bytes occupied by this field in the viewed buffer. */
+    int16_t sub_field_count; /* For struct arrays only. */
+    const uint8_t *sub_meta_data; /* Same as above. */
+    uint32_t sub_meta_len; /* Same as above. */
+} commproto_field_t;
+
+typedef struct commproto_view_mark_t
+{
+    uint32_t meta_offset;
+    uint32_t buf_offset;
+    int32_t simple_array_len;
+    int32_t struct_array_len;
+} commproto_view_mark_t;
+
+/*
+ * A read-only view over a serialized buffer, which computes field offsets lazily
+ * and never copies or allocates anything, even for dynamic arrays.
+ * Fields are accessed by their (0-based) indexes in the meta data, nested fields excluded.
+ */
+typedef struct commproto_view_t
+{
+    const uint8_t *meta_data;
+    uint32_t meta_len;
+    const uint8_t *buf_ptr;
+    uint32_t buf_len;
+    int16_t field_limit;
+    int16_t resolved_fields; /* Fields in front of the cursor, whose offsets are known already. */
+    commproto_view_mark_t cursor;
+    commproto_view_mark_t marks[COMMPROTO_VIEW_CACHED_FIELDS];
+} commproto_view_t;
+
+int commproto_view_init(commproto_view_t *view, const uint8_t *struct_meta_data, uint32_t meta_len,
+    const uint8_t *buf_ptr, uint32_t buf_len);
+
+int commproto_view_field(commproto_view_t *view, int16_t field_index, commproto_field_t *field);
+
+/* For archives of concatenated messages: the next message starts at buf_ptr + the return value (if >= 0). */
+int32_t commproto_view_size(commproto_view_t *view);
+
+/* Makes a sub-view over an element of a struct array field, in which nested fields can be accessed. */
+int commproto_view_element(const commproto_field_t *field, uint32_t item_index, commproto_view_t *sub_view);
+
+/*
+ * Returns the array in place if its items have the same byte order as the host, or NULL otherwise.
+ * NOTE: The result may not be aligned, which causes alignment faults on some platforms if dereferenced directly.
+ */
+const void* commproto_field_array(const commproto_field_t *field);
+
+/* Copies an item into dest_ptr in the byte order of the host. */
+int commproto_field_get(const commproto_field_t *field, uint32_t item_index, void *dest_ptr);
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+
+typedef struct commproto_mapping_t
+{
+    const uint8_t *buf_ptr;
+    size_t buf_len;
+} commproto_mapping_t;
+
+/* Maps a file of serialized messages read-only, so as to be viewed without reading it into memory. */
+int commproto_map_file(const char *path, commproto_mapping_t *mapping);
+
+void commproto_unmap_file(commproto_mapping_t *mapping);
+
+#endif
+
 #define COMMPROTO_META_VAR(struct_name)                 META_DATA_##struct_name
 #define COMMPROTO_DECLARE_META_VAR(struct_name)         const uint8_t META_DATA_##struct_name[]
 
@@ -124,6 +286,15 @@ void commproto_dump_buffer(const uint8_t *buf, uint32_t size, FILE *nullable_str
 #define COMMPROTO_CLEAR(struct_name, struct_ptr)                                            \
     commproto_clear(COMMPROTO_META_VAR(struct_name), COMMPROTO_META_SIZE(struct_name), struct_ptr)
 
+#define COMMPROTO_CTX_SERIALIZE(ctx, struct_name, struct_ptr)                               \
+    commproto_ctx_serialize(ctx, COMMPROTO_META_VAR(struct_name), COMMPROTO_META_SIZE(struct_name), struct_ptr)
+
+#define COMMPROTO_CTX_PARSE(ctx, struct_name, buf_ptr, buf_len, struct_ptr)                 \
+    commproto_ctx_parse(ctx, COMMPROTO_META_VAR(struct_name), COMMPROTO_META_SIZE(struct_name), buf_ptr, buf_len, struct_ptr)
+
+#define COMMPROTO_CTX_CLEAR(ctx, struct_name, struct_ptr)                                   \
+    commproto_ctx_clear(ctx, COMMPROTO_META_VAR(struct_name), COMMPROTO_META_SIZE(struct_name), struct_ptr)
+
 enum
 {
     COMMPROTO_INT8 = 1
@@ -225,6 +396,8 @@ enum
 #if ((__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) && defined(COMMPROTO_LITTLE_ENDIAN)) \
     || ((__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__) && defined(COMMPROTO_BIG_ENDIAN))
 
+#define COMMPROTO_INT_IS_SAME_ENDIAN                            1
+
 #define COMMPROTO_SET_INT16(src_ptr, dest_ptr)                  do { \
     *((uint8_t *)(dest_ptr)) = *((uint8_t *)(src_ptr)); \
     *(((uint8_t *)(dest_ptr)) + 1) = *(((uint8_t *)(src_ptr)) + 1); \
@@ -242,6 +415,8 @@ enum
 
 #else
 
+#define COMMPROTO_INT_IS_SAME_ENDIAN                            0
+
 #define COMMPROTO_SET_INT16(src_ptr, dest_ptr)                  do { \
     *((uint8_t *)(dest_ptr)) = *(((uint8_t *)(src_ptr)) + 1); \
     *(((uint8_t *)(dest_ptr)) + 1) = *((uint8_t *)(src_ptr)); \
@@ -262,6 +437,8 @@ enum
 #if ((__FLOAT_WORD_ORDER__ == __ORDER_LITTLE_ENDIAN__) && defined(COMMPROTO_LITTLE_ENDIAN)) \
     || ((__FLOAT_WORD_ORDER__ == __ORDER_BIG_ENDIAN__) && defined(COMMPROTO_BIG_ENDIAN))
 
+#define COMMPROTO_FLOAT_IS_SAME_ENDIAN                          1
+
 #define COMMPROTO_SET_FLOAT32(src_ptr, dest_ptr)                COMMPROTO_SAME_ENDIAN_ASSIGN(float32_t, src_ptr, dest_ptr)
 
 #define COMMPROTO_SET_FLOAT32_ARRAY(count, src_ptr, dest_ptr)   COMMPROTO_SAME_ENDIAN_SET(float32_t, count, src_ptr, dest_ptr)
@@ -272,6 +449,8 @@ enum
 
 #else
 
+#define COMMPROTO_FLOAT_IS_SAME_ENDIAN                          0
+
 #define COMMPROTO_SET_FLOAT32(src_ptr, dest_ptr)                COMMPROTO_DIFF_ENDIAN_ASSIGN(float32_t, src_ptr, dest_ptr)
 
 #define COMMPROTO_SET_FLOAT32_ARRAY(count, src_ptr, dest_ptr)   COMMPROTO_DIFF_ENDIAN_SET(float32_t, count, src_ptr, dest_ptr)
@@ -948,10 +1127,304 @@ static bool check_buffer_differences(const uint8_t *buf1, const uint8_t *buf2, u
     return true;
 }
 
+static bool test_context(const demo_struct_main_t *src, const uint8_t *expected_buf)
+{
+    commproto_ctx_t ctx;
+    demo_struct_main_t dest = { 0 };
+    commproto_result_t result;
+    const uint8_t *first_buf = NULL;
+    int round = 0;
+    bool ok = true;
+
+    if ((result.error_code = commproto_ctx_init(&ctx, 0)) < 0)
+    {
+        fprintf(stderr, "*** Context initialization failed: %s!\n", commproto_error(result.error_code));
+
+        return false;
+    }
+
+    for (round = 1; ok && round <= 3; ++round)
+    {
+        result = COMMPROTO_CTX_SERIALIZE(&ctx, demo_struct_main_t, src);
+        if (result.error_code < 0)
+        {
+            fprintf(stderr, "*** Context serialization[%d] failed after %u bytes: %s!\n",
+                round, result.handled_len, commproto_error(result.error_code));
+            ok = false;
+            break;
+        }
+
+        if (NULL == first_buf)
+            first_buf = result.buf_ptr;
+        else if (first_buf != result.buf_ptr)
+        {
+            fprintf(stderr, "*** Context output buffer[%d] not reused: %p != %p!\n",
+                round, (void *)result.buf_ptr, (void *)first_buf);
+            ok = false;
+            break;
+        }
+
+        if (!(ok = check_buffer_differences(expected_buf, result.buf_ptr, result.handled_len)))
+            break;
+
+        result = COMMPROTO_CTX_PARSE(&ctx, demo_struct_main_t, result.buf_ptr, result.handled_len, &dest);
+        if (result.error_code < 0)
+        {
+            fprintf(stderr, "*** Context deserialization[%d] failed after %u bytes: %s!\n",
+                round, result.handled_len, commproto_error(result.error_code));
+            ok = false;
+            break;
+        }
+
+        ok = check_struct_differences(src, &dest);
+        COMMPROTO_CTX_CLEAR(&ctx, demo_struct_main_t, &dest);
+    }
+
+    if (ok && (3 != ctx.stats.parses || 1 != ctx.stats.plan_misses || 2 != ctx.stats.plan_hits))
+    {
+        fprintf(stderr, "*** Context statistics mismatched: parses = %u, plan misses = %u, plan hits = %u\n",
+            ctx.stats.parses, ctx.stats.plan_misses, ctx.stats.plan_hits);
+        ok = false;
+    }
+
+    printf("Context: %u serializations, %u parses, %u failures, %u buffer expansions, %u plan hits, %u plan misses.\n",
+        ctx.stats.serializations, ctx.stats.parses, ctx.stats.failures, ctx.stats.buf_expansions,
+        ctx.stats.plan_hits, ctx.stats.plan_misses);
+
+    COMMPROTO_CTX_CLEAR(&ctx, demo_struct_main_t, &dest);
+    commproto_ctx_release(&ctx);
+
+    return ok;
+}
+
+static bool check_view_field(commproto_view_t *view, int16_t field_index, uint32_t expected_count,
+    uint32_t item_index, double expected_value, commproto_field_t *field)
+{
+    uint8_t value[sizeof(float64_t)] = { 0 };
+    double actual_value = 0;
+    int err = commproto_view_field(view, field_index, field);
+
+    if (err < 0)
+    {
+        fprintf(stderr, "*** Failed to view field[%d]: %s!\n", field_index, commproto_error(err));
+
+        return false;
+    }
+
+    if (expected_count != field->count)
+    {
+        fprintf(stderr, "*** Count of field[%d] mismatched: %u != %u\n", field_index, field->count, expected_count);
+
+        return false;
+    }
+
+    if (0 == field->item_size)
+        return true;
+
+    if ((err = commproto_field_get(field, item_index, value)) < 0)
+    {
+        fprintf(stderr, "*** Failed to get item[%u] of field[%d]: %s!\n", item_index, field_index, commproto_error(err));
+
+        return false;
+    }
+
+    if (COMMPROTO_FLOAT32 == field->type || COMMPROTO_FLOAT32_DYNAMIC_ARRAY == field->type
+        || COMMPROTO_FLOAT32_FIXED_ARRAY == field->type)
+        actual_value = *((float32_t *)value);
+    else if (COMMPROTO_FLOAT64 == field->type || COMMPROTO_FLOAT64_DYNAMIC_ARRAY == field->type
+        || COMMPROTO_FLOAT64_FIXED_ARRAY == field->type)
+        actual_value = *((float64_t *)value);
+    else if (1 == field->item_size)
+        actual_value = *((int8_t *)value);
+    else if (2 == field->item_size)
+        actual_value = *((int16_t *)value);
+    else if (4 == field->item_size)
+        actual_value = *((int32_t *)value);
+    else
+        actual_value = (double)*((int64_t *)value);
+
+    if (actual_value != expected_value)
+    {
+        fprintf(stderr, "*** Item[%u] of field[%d] mismatched: %f != %f\n",
+            item_index, field_index, actual_value, expected_value);
+
+        return false;
+    }
+
+    return true;
+}
+
+/* A huge length prefix must not wrap the size calculation and let a view go past the buffer. */
+static bool test_malformed_view(const uint8_t *buf, uint32_t buf_len)
+{
+    uint8_t malformed[4096];
+    uint32_t huge_len = 0x20000001; /* Times sizeof(float64_t) wraps to 8 in 32 bits. */
+    commproto_view_t view;
+    commproto_field_t field;
+    int err = 0;
+
+    if (buf_len > sizeof(malformed))
+        return false;
+
+    memcpy(malformed, buf, buf_len);
+    commproto_view_init(&view, COMMPROTO_META_VAR(demo_struct_main_t), COMMPROTO_META_SIZE(demo_struct_main_t),
+        malformed, buf_len);
+    if ((err = commproto_view_field(&view, 22, &field)) < 0) /* f64_dynamic_array_len */
+    {
+        fprintf(stderr, "*** Failed to view f64_dynamic_array_len: %s!\n", commproto_error(err));
+
+        return false;
+    }
+    COMMPROTO_SET_INT32(&huge_len, (uint8_t *)field.data);
+
+    commproto_view_init(&view, COMMPROTO_META_VAR(demo_struct_main_t), COMMPROTO_META_SIZE(demo_struct_main_t),
+        malformed, buf_len);
+    if ((err = commproto_view_field(&view, 23, &field)) >= 0 || commproto_view_size(&view) >= 0)
+    {
+        fprintf(stderr, "*** f64_dynamic_array with a malformed length of %u is viewed as %u items!\n",
+            huge_len, field.count);
+
+        return false;
+    }
+
+    /* Nor may it make a struct array of empty elements loop without consuming anything. */
+    {
+        static const uint8_t EMPTY_ELEMENTS_META[] = {
+            COMMPROTO_ARRAY_LEN32
+            , COMMPROTO_STRUCT_DYNAMIC_ARRAY, COMMPROTO_STRUCT_FIELD_COUNT(1)
+                , COMMPROTO_INT8_FIXED_ARRAY, COMMPROTO_ARRAY_LEN_IS(0)
+        };
+
+        huge_len = 0x7fffffff;
+        COMMPROTO_SET_INT32(&huge_len, malformed);
+        commproto_view_init(&view, EMPTY_ELEMENTS_META, sizeof(EMPTY_ELEMENTS_META), malformed, sizeof(uint32_t));
+        if ((err = commproto_view_field(&view, 1, &field)) >= 0)
+        {
+            fprintf(stderr, "*** Struct array of %u empty elements is viewed!\n", huge_len);
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool test_view(const uint8_t *buf, uint32_t buf_len)
+{
+    const char *archive_path = "communication_protocol_test.bin";
+    FILE *archive = NULL;
+    commproto_mapping_t mapping;
+    commproto_view_t view;
+    commproto_view_t sub_view;
+    commproto_field_t field;
+    commproto_field_t sub_field;
+    uint32_t offset = 0;
+    int32_t size = 0;
+    int messages = 0;
+    int err = 0;
+    bool ok = true;
+
+    commproto_view_init(&view, COMMPROTO_META_VAR(demo_struct_main_t), COMMPROTO_META_SIZE(demo_struct_main_t),
+        buf, buf_len);
+
+    if (!check_view_field(&view, 11, 6, 5, (float64_t)64.64, &field) /* f64_fixed_array */
+        || !check_view_field(&view, 2, 1, 0, 32, &field) /* i32, with a cached offset */
+        || !check_view_field(&view, 21, 2, 1, (float32_t)32.32, &field) /* f32_dynamic_array */
+        || !check_view_field(&view, 6, 1, 0, 8, &field)) /* i8_fixed_array */
+        return false;
+
+    if (NULL == commproto_field_array(&field))
+    {
+        fprintf(stderr, "*** Failed to access i8_fixed_array in place!\n");
+
+        return false;
+    }
+
+    if (!check_view_field(&view, 14, 4, 0, 0, &field)) /* sub1_dynamic_array */
+        return false;
+
+    if ((err = commproto_view_element(&field, 3, &sub_view)) < 0)
+    {
+        fprintf(stderr, "*** Failed to view element[3] of sub1_dynamic_array: %s!\n", commproto_error(err));
+
+        return false;
+    }
+
+    if (!check_view_field(&sub_view, 3, 3, 2, 32, &sub_field) /* i32_dynamic_array */
+        || !check_view_field(&view, 26, 5, 0, 0, &field)) /* sub2_fixed_array */
+        return false;
+
+    if ((err = commproto_view_field(&view, 27, &field)) >= 0)
+    {
+        fprintf(stderr, "*** Field[27] is expected to be out of range!\n");
+
+        return false;
+    }
+
+    if ((size = commproto_view_size(&view)) != (int32_t)buf_len)
+    {
+        fprintf(stderr, "*** View size mismatched: %d != %u\n", size, buf_len);
+
+        return false;
+    }
+
+    if (!test_malformed_view(buf, buf_len))
+        return false;
+
+    if (NULL == (archive = fopen(archive_path, "wb")))
+    {
+        perror("*** Failed to create archive file");
+
+        return false;
+    }
+
+    ok = (1 == fwrite(buf, buf_len, 1, archive) && 1 == fwrite(buf, buf_len, 1, archive));
+    fclose(archive);
+
+    if (!ok || (err = commproto_map_file(archive_path, &mapping)) < 0)
+    {
+        fprintf(stderr, "*** Failed to write or map archive file: %s!\n", ok ? commproto_error(err) : "Write error");
+        remove(archive_path);
+
+        return false;
+    }
+
+    for (; offset < mapping.buf_len; offset += size, ++messages)
+    {
+        commproto_view_init(&view, COMMPROTO_META_VAR(demo_struct_main_t), COMMPROTO_META_SIZE(demo_struct_main_t),
+            mapping.buf_ptr + offset, mapping.buf_len - offset);
+
+        if ((ok = check_view_field(&view, 0, 1, 0, 8, &field)) /* i8 */
+            && (size = commproto_view_size(&view)) <= 0)
+        {
+            fprintf(stderr, "*** Failed to view message[%d] in archive: %s!\n", messages, commproto_error(size));
+            ok = false;
+        }
+
+        if (!ok)
+            break;
+    }
+
+    commproto_unmap_file(&mapping);
+    remove(archive_path);
+
+    if (ok && 2 != messages)
+    {
+        fprintf(stderr, "*** Message count of archive mismatched: %d != 2\n", messages);
+        ok = false;
+    }
+
+    if (ok)
+        printf("View: %d-byte message and %d-message archive viewed without copying.\n", buf_len, messages);
+
+    return ok;
+}
+
 int main(int argc, char **argv)
 {
     demo_struct_main_t src = { 0 };
     uint8_t buf[4096] = { 0 };
+    uint32_t buf_len = 0;
     demo_struct_main_t dest1 = { 0 };
     demo_struct_main_t dest2 = { 0 };
     commproto_result_t result;
@@ -987,6 +1460,7 @@ int main(int argc, char **argv)
         return -1;
     }
     printf("Serialized %u bytes to static buffer.\n", result.handled_len);
+    buf_len = result.handled_len;
     commproto_dump_buffer(buf, result.handled_len, stdout, NULL);
 
     result = COMMPROTO_PARSE(demo_struct_main_t, buf, result.handled_len, &dest1);
@@ -1058,9 +1532,17 @@ int main(int argc, char **argv)
         return -1;
     }
 
-    COMMPROTO_CLEAR(demo_struct_main_t, &src);
     COMMPROTO_CLEAR(demo_struct_main_t, &dest2);
 
+    if (!test_context(&src, buf) || !test_view(buf, buf_len))
+    {
+        COMMPROTO_CLEAR(demo_struct_main_t, &src);
+
+        return -1;
+    }
+
+    COMMPROTO_CLEAR(demo_struct_main_t, &src);
+
     printf("~ ~ ~ ~ Test finished successfully! ~ ~ ~ ~\n");
 
     return 0;
@@ -1125,5 +1607,11 @@ int main(int argc, char **argv)
  * >>> 2023-11-08, Man Hung-Coeng:
  *  01. Do type casting to results of malloc() to eliminate warnings
  *      reported by YouCompleteMe plugin.
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Add commproto_ctx_t, commproto_ctx_*() and COMMPROTO_[CPP_]CTX_*()
+ *      for per-thread codec contexts.
+ *  02. Add commproto_view_*(), commproto_field_*() and commproto_{map,unmap}_file()
+ *      for zero-copy read-only access to serialized buffers.
  */
 
@@ -0,0 +1,941 @@
+/*
+ * Binary compiled cache of an INI file, which is mapped and looked up in place
+ * instead of parsing the text on every launch.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "ini_cache.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum
+{
+    INI_CACHE_ERR_UNKNOWN = 1
+    , INI_CACHE_ERR_NOT_SUPPORTED
+    , INI_CACHE_ERR_MEM_ALLOC
+    , INI_CACHE_ERR_INVALID_PARAM
+    , INI_CACHE_ERR_PARSE
+    , INI_CACHE_ERR_TOO_LARGE
+
+    , INI_CACHE_ERR_END /* NOTE: All error codes should be defined ahead of this. */
+};
+
+static const char* const S_ERRORS[] = {
+    "Unknown error"
+    , "Not supported"
+    , "Failed to allocate memory"
+    , "Invalid parameter"
+    , "Failed to parse the source file"
+    , "Too large to be cached"
+};
+
+const char* ini_cache_error(int error_code)
+{
+    if (error_code >= 0)
+        return "OK";
+
+    if (error_code <= -INI_CACHE_ERR_END)
+        return strerror(-error_code - INI_CACHE_ERR_END);
+
+    return S_ERRORS[-error_code - 1];
+}
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+
+#define INI_CACHE_MAGIC         "INICACHE"
+#define INI_CACHE_VERSION       1
+#define INI_CACHE_SUFFIX        ".cache"
+
+typedef struct cache_header_t
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size; /* Detects layout changes between builds. */
+    uint64_t src_mtime;
+    uint64_t src_size;
+    uint64_t src_hash;
+    uint32_t parse_options;
+    uint32_t section_count;
+    uint32_t item_count;
+    uint32_t string_size;
+} cache_header_t;
+
+/* NOTE: The first two fields of both must be the hash and the name offset, see __find_entry(). */
+typedef struct cache_section_t
+{
+    uint32_t hash;
+    uint32_t name;
+    uint32_t first_item;
+    uint32_t item_count;
+} cache_section_t;
+
+typedef struct cache_item_t
+{
+    uint32_t hash;
+    uint32_t key;
+    uint32_t value;
+} cache_item_t;
+
+struct ini_cache_t
+{
+    char *image;
+    size_t size;
+    int is_mapped;
+    const cache_header_t *header;
+    const cache_section_t *sections;
+    const cache_item_t *items;
+    const char *strings;
+};
+
+typedef struct src_stamp_t
+{
+    uint64_t mtime;
+    uint64_t size;
+    uint64_t hash;
+} src_stamp_t;
+
+static uint32_t __hash_of(const char *str)
+{
+    uint32_t hash = 2166136261UL; /* FNV-1a, same as the hash index of ini_file.c. */
+
+    for (; '\0' != *str; ++str)
+    {
+        hash ^= (unsigned char)*str;
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+/* Stats and hashes the whole source file, which is much cheaper than parsing it. */
+static int __stamp_source(const char *path, src_stamp_t *stamp)
+{
+    const uint64_t FNV_PRIME = ((uint64_t)0x100 << 32) | 0x1b3;
+    struct stat st;
+    const unsigned char *data = NULL;
+    size_t i;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+        return -(errno + INI_CACHE_ERR_END);
+
+    if (fstat(fd, &st) < 0)
+    {
+        int err = -(errno + INI_CACHE_ERR_END);
+
+        close(fd);
+
+        return err;
+    }
+
+    stamp->mtime = (uint64_t)st.st_mtime;
+    stamp->size = (uint64_t)st.st_size;
+    stamp->hash = ((uint64_t)0xcbf29ce4 << 32) | 0x84222325; /* 64-bit FNV-1a */
+
+    if (st.st_size > 0 && MAP_FAILED == (data = (const unsigned char *)mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0)))
+    {
+        int err = -(errno + INI_CACHE_ERR_END);
+
+        close(fd);
+
+        return err;
+    }
+    close(fd);
+
+    for (i = 0; i < (size_t)st.st_size; ++i)
+    {
+        stamp->hash ^= data[i];
+        stamp->hash *= FNV_PRIME;
+    }
+
+    if (st.st_size > 0)
+        munmap((void *)data, st.st_size);
+
+    return 0;
+}
+
+/*
+ * ================
+ *  COMPILATION
+ * ================
+ */
+
+typedef struct entry_t
+{
+    uint32_t sec_hash;
+    uint32_t key_hash;
+    const char *sec_name;
+    const char *key; /* NULL for the section line itself. */
+    const char *value;
+    size_t seq;
+} entry_t;
+
+typedef struct collector_t
+{
+    entry_t *entries;
+    size_t count;
+    size_t capacity;
+} collector_t;
+
+static int __collect_entry(const char *sec_name, ini_node_t *cur_node, void *collector)
+{
+    collector_t *c = (collector_t *)collector;
+    entry_t *entry = NULL;
+    char type = ini_node_type(cur_node);
+
+    if (INI_NODE_SECTION != type && INI_NODE_ITEM != type)
+        return 0;
+
+    if (c->count == c->capacity)
+    {
+        size_t capacity = (0 == c->capacity) ? 256 : c->capacity * 2;
+        entry_t *entries = (entry_t *)realloc(c->entries, capacity * sizeof(entry_t));
+
+        if (NULL == entries)
+            return -INI_CACHE_ERR_MEM_ALLOC;
+
+        c->entries = entries;
+        c->capacity = capacity;
+    }
+
+    entry = &c->entries[c->count];
+    entry->sec_hash = __hash_of(sec_name);
+    entry->sec_name = sec_name;
+    entry->key = (INI_NODE_ITEM == type) ? ini_item_get_key(cur_node) : NULL;
+    entry->key_hash = (INI_NODE_ITEM == type) ? __hash_of(entry->key) : 0;
+    entry->value = (INI_NODE_ITEM == type) ? ini_item_get_value(cur_node) : NULL;
+    entry->seq = c->count++;
+
+    return 0;
+}
+
+/* Groups entries by section with the section line first, then by key in order of appearance. */
+static int __compare_entries(const void *a, const void *b)
+{
+    const entry_t *x = (const entry_t *)a;
+    const entry_t *y = (const entry_t *)b;
+    int ret;
+
+    if (x->sec_hash != y->sec_hash)
+        return (x->sec_hash < y->sec_hash) ? -1 : 1;
+
+    if (0 != (ret = strcmp(x->sec_name, y->sec_name)))
+        return ret;
+
+    if ((NULL == x->key) != (NULL == y->key))
+        return (NULL == x->key) ? -1 : 1;
+
+    if (NULL != x->key && x->key_hash != y->key_hash)
+        return (x->key_hash < y->key_hash) ? -1 : 1;
+
+    if (NULL != x->key && 0 != (ret = strcmp(x->key, y->key)))
+        return ret;
+
+    return (x->seq < y->seq) ? -1 : 1;
+}
+
+static int __is_new_section(const entry_t *entries, size_t i)
+{
+    return 0 == i || entries[i].sec_hash != entries[i - 1].sec_hash || 0 != strcmp(entries[i].sec_name, entries[i - 1].sec_name);
+}
+
+static int __is_new_item(const entry_t *entries, size_t i)
+{
+    return NULL != entries[i].key && (NULL == entries[i - 1].key || entries[i].key_hash != entries[i - 1].key_hash
+        || 0 != strcmp(entries[i].key, entries[i - 1].key) || __is_new_section(entries, i));
+}
+
+static char* __append_string(char *pos, const char *str, const char *strings, uint32_t *offset)
+{
+    size_t len = strlen(str) + 1;
+
+    *offset = (uint32_t)(pos - strings);
+    memcpy(pos, str, len);
+
+    return pos + len;
+}
+
+/* Returns a heap image of the cache file, with the source stamp left for the caller. */
+static char* __compile(ini_doc_t *doc, int parse_options, size_t *image_size, int *error)
+{
+    collector_t c = { NULL, 0, 0 };
+    cache_header_t *header = NULL;
+    cache_section_t *sections = NULL;
+    cache_section_t *sec = NULL;
+    cache_item_t *items = NULL;
+    char *image = NULL;
+    char *strings = NULL;
+    char *pos = NULL;
+    size_t section_count = 0, item_count = 0, string_size = 0;
+    size_t i;
+
+    if ((*error = ini_traverse_all_nodes(doc, __collect_entry, &c).error_code) < 0)
+        goto COMPILE_END;
+
+    qsort(c.entries, c.count, sizeof(entry_t), __compare_entries);
+
+    for (i = 0; i < c.count; ++i)
+    {
+        if (__is_new_section(c.entries, i))
+        {
+            ++section_count;
+            string_size += strlen(c.entries[i].sec_name) + 1;
+        }
+        else if (__is_new_item(c.entries, i))
+        {
+            ++item_count;
+            string_size += strlen(c.entries[i].key) + strlen(c.entries[i].value) + 2;
+        }
+    }
+
+    *image_size = sizeof(cache_header_t) + section_count * sizeof(cache_section_t) + item_count * sizeof(cache_item_t) + string_size;
+    if (string_size >= UINT32_MAX || item_count >= UINT32_MAX)
+    {
+        *error = -INI_CACHE_ERR_TOO_LARGE;
+        goto COMPILE_END;
+    }
+
+    if (NULL == (image = (char *)calloc(1, *image_size)))
+    {
+        *error = -INI_CACHE_ERR_MEM_ALLOC;
+        goto COMPILE_END;
+    }
+
+    header = (cache_header_t *)image;
+    memcpy(header->magic, INI_CACHE_MAGIC, sizeof(header->magic));
+    header->version = INI_CACHE_VERSION;
+    header->header_size = sizeof(cache_header_t);
+    header->parse_options = parse_options & INI_PARSE_STRIP_BLANKS;
+    header->section_count = (uint32_t)section_count;
+    header->item_count = (uint32_t)item_count;
+    header->string_size = (uint32_t)string_size;
+
+    sections = (cache_section_t *)(header + 1);
+    items = (cache_item_t *)(sections + section_count);
+    strings = (char *)(items + item_count);
+    pos = strings;
+    section_count = item_count = 0;
+    for (i = 0; i < c.count; ++i)
+    {
+        if (__is_new_section(c.entries, i))
+        {
+            sec = &sections[section_count++];
+            sec->hash = c.entries[i].sec_hash;
+            sec->first_item = (uint32_t)item_count;
+            pos = __append_string(pos, c.entries[i].sec_name, strings, &sec->name);
+        }
+        else if (__is_new_item(c.entries, i))
+        {
+            cache_item_t *item = &items[item_count++];
+
+            item->hash = c.entries[i].key_hash;
+            pos = __append_string(pos, c.entries[i].key, strings, &item->key);
+            pos = __append_string(pos, c.entries[i].value, strings, &item->value);
+            ++sec->item_count;
+        }
+    }
+
+COMPILE_END:
+
+    free(c.entries);
+
+    return image;
+}
+
+/* Writes a temporary file and renames it, so that readers never see a half-written cache. */
+static int __write_file(const char *path, const char *data, size_t size)
+{
+    size_t path_len = strlen(path);
+    char *tmp_path = (char *)malloc(path_len + 5);
+    size_t written = 0;
+    int err = 0;
+    int fd = -1;
+
+    if (NULL == tmp_path)
+        return -INI_CACHE_ERR_MEM_ALLOC;
+
+    memcpy(tmp_path, path, path_len);
+    memcpy(tmp_path + path_len, ".tmp", 5);
+
+    if ((fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+    {
+        err = -(errno + INI_CACHE_ERR_END);
+        goto WRITE_END;
+    }
+
+    while (written < size)
+    {
+        ssize_t ret = write(fd, data + written, size - written);
+
+        if (ret < 0 && EINTR != errno)
+        {
+            err = -(errno + INI_CACHE_ERR_END);
+            break;
+        }
+
+        written += (ret > 0) ? ret : 0;
+    }
+
+    if (close(fd) < 0 && 0 == err)
+        err = -(errno + INI_CACHE_ERR_END);
+
+    if (0 == err && rename(tmp_path, path) < 0)
+        err = -(errno + INI_CACHE_ERR_END);
+
+    if (err < 0)
+        unlink(tmp_path);
+
+WRITE_END:
+
+    free(tmp_path);
+
+    return err;
+}
+
+static void __stamp_image(char *image, const src_stamp_t *stamp)
+{
+    cache_header_t *header = (cache_header_t *)image;
+
+    header->src_mtime = stamp->mtime;
+    header->src_size = stamp->size;
+    header->src_hash = stamp->hash;
+}
+
+int ini_cache_save(ini_doc_t *doc, int parse_options, const char *src_path, const char *cache_path)
+{
+    src_stamp_t stamp;
+    size_t size = 0;
+    char *image = NULL;
+    int err;
+
+    if (NULL == doc || NULL == src_path || NULL == cache_path)
+        return -INI_CACHE_ERR_INVALID_PARAM;
+
+    if ((err = __stamp_source(src_path, &stamp)) < 0)
+        return err;
+
+    if (NULL == (image = __compile(doc, parse_options, &size, &err)))
+        return err;
+
+    __stamp_image(image, &stamp);
+    err = __write_file(cache_path, image, size);
+    free(image);
+
+    return err;
+}
+
+/*
+ * ================
+ *  LOADING
+ * ================
+ */
+
+static void __attach_image(ini_cache_t *cache, char *image, size_t size, int is_mapped)
+{
+    cache->image = image;
+    cache->size = size;
+    cache->is_mapped = is_mapped;
+    cache->header = (const cache_header_t *)image;
+    cache->sections = (const cache_section_t *)(cache->header + 1);
+    cache->items = (const cache_item_t *)(cache->sections + cache->header->section_count);
+    cache->strings = (const char *)(cache->items + cache->header->item_count);
+}
+
+/*
+ * Checks that all counts and offsets stay inside the image and the string table ends with a NUL,
+ * so that look-ups never go beyond the mapping even if the file is corrupted.
+ */
+static int __is_image_intact(const char *image, size_t size)
+{
+    const cache_header_t *header = (const cache_header_t *)image;
+    const cache_section_t *sections = (const cache_section_t *)(header + 1);
+    const cache_item_t *items = (const cache_item_t *)(sections + header->section_count);
+    const char *strings = (const char *)(items + header->item_count);
+    uint32_t string_size = header->string_size;
+    uint32_t i;
+
+    if ((uint64_t)size != sizeof(cache_header_t) + (uint64_t)header->section_count * sizeof(cache_section_t)
+        + (uint64_t)header->item_count * sizeof(cache_item_t) + string_size)
+        return 0;
+
+    if (string_size > 0 && '\0' != strings[string_size - 1])
+        return 0;
+
+    for (i = 0; i < header->section_count; ++i)
+    {
+        if (sections[i].name >= string_size || sections[i].first_item > header->item_count
+            || sections[i].item_count > header->item_count - sections[i].first_item)
+            return 0;
+    }
+
+    for (i = 0; i < header->item_count; ++i)
+    {
+        if (items[i].key >= string_size || items[i].value >= string_size)
+            return 0;
+    }
+
+    return 1;
+}
+
+/* Maps the cache file if it's intact and made from the same source with the same options. */
+static int __map_valid_cache(ini_cache_t *cache, const char *cache_path, const src_stamp_t *stamp, int parse_options)
+{
+    const cache_header_t *header = NULL;
+    struct stat st;
+    char *image = NULL;
+    int fd = open(cache_path, O_RDONLY);
+
+    if (fd < 0)
+        return 0;
+
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(cache_header_t)
+        || MAP_FAILED == (image = (char *)mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0)))
+    {
+        close(fd);
+
+        return 0;
+    }
+    close(fd); /* The mapping stays valid. */
+
+    header = (const cache_header_t *)image;
+    if (0 != memcmp(header->magic, INI_CACHE_MAGIC, sizeof(header->magic))
+        || INI_CACHE_VERSION != header->version || sizeof(cache_header_t) != header->header_size
+        || (uint32_t)(parse_options & INI_PARSE_STRIP_BLANKS) != header->parse_options
+        || stamp->mtime != header->src_mtime || stamp->size != header->src_size || stamp->hash != header->src_hash
+        || !__is_image_intact(image, st.st_size))
+    {
+        munmap(image, st.st_size);
+
+        return 0;
+    }
+
+    __attach_image(cache, image, st.st_size, 1);
+
+    return 1;
+}
+
+#ifdef TEST
+static void (*s_after_parsing_hook)(const char *src_path) = NULL; /* For changing the source at the worst time. */
+#endif
+
+static int __compile_source(ini_cache_t *cache, const char *src_path, const char *cache_path,
+    const src_stamp_t *stamp, int parse_options)
+{
+    src_stamp_t after;
+    size_t size = 0;
+    char *image = NULL;
+    int err = 0;
+    ini_doc_t *doc = ini_parse_from_file_mmap(src_path, parse_options & ~INI_PARSE_HASH_INDEX, NULL);
+
+    if (NULL == doc)
+        return -INI_CACHE_ERR_PARSE;
+
+#ifdef TEST
+    if (NULL != s_after_parsing_hook)
+        s_after_parsing_hook(src_path);
+#endif
+
+    image = __compile(doc, parse_options, &size, &err);
+    ini_destroy(doc);
+    if (NULL == image)
+        return err;
+
+    __attach_image(cache, image, size, 0);
+    __stamp_image(image, stamp);
+
+    /*
+     * The stamp was taken before parsing, so don't persist a cache of a file replaced in between,
+     * which is still good for this time, as if the source was read just before being replaced.
+     */
+    if (__stamp_source(src_path, &after) < 0
+        || after.mtime != stamp->mtime || after.size != stamp->size || after.hash != stamp->hash)
+        return 0;
+
+    __write_file(cache_path, image, size); /* A read-only file system is not an error. */
+
+    return 0;
+}
+
+ini_cache_t* ini_cache_load(const char *src_path, const char *nullable_cache_path, int parse_options, int *nullable_error)
+{
+    src_stamp_t stamp;
+    ini_cache_t *cache = NULL;
+    char *default_path = NULL;
+    const char *cache_path = nullable_cache_path;
+    int err = 0;
+
+    if (NULL == src_path)
+    {
+        err = -INI_CACHE_ERR_INVALID_PARAM;
+        goto LOAD_END;
+    }
+
+    if (NULL == (cache = (ini_cache_t *)calloc(1, sizeof(ini_cache_t))))
+    {
+        err = -INI_CACHE_ERR_MEM_ALLOC;
+        goto LOAD_END;
+    }
+
+    if (NULL == cache_path)
+    {
+        size_t len = strlen(src_path);
+
+        if (NULL == (default_path = (char *)malloc(len + sizeof(INI_CACHE_SUFFIX))))
+        {
+            err = -INI_CACHE_ERR_MEM_ALLOC;
+            goto LOAD_END;
+        }
+        memcpy(default_path, src_path, len);
+        memcpy(default_path + len, INI_CACHE_SUFFIX, sizeof(INI_CACHE_SUFFIX));
+        cache_path = default_path;
+    }
+
+    if ((err = __stamp_source(src_path, &stamp)) < 0)
+        goto LOAD_END;
+
+    if (!__map_valid_cache(cache, cache_path, &stamp, parse_options))
+        err = __compile_source(cache, src_path, cache_path, &stamp, parse_options);
+
+LOAD_END:
+
+    free(default_path);
+
+    if (NULL != nullable_error)
+        *nullable_error = err;
+
+    if (err < 0)
+    {
+        ini_cache_close(cache);
+
+        return NULL;
+    }
+
+    return cache;
+}
+
+void ini_cache_close(ini_cache_t *cache)
+{
+    if (NULL == cache)
+        return;
+
+    if (cache->is_mapped)
+        munmap(cache->image, cache->size);
+    else
+        free(cache->image);
+
+    free(cache);
+}
+
+int ini_cache_is_reparsed(const ini_cache_t *cache)
+{
+    return !cache->is_mapped;
+}
+
+size_t ini_cache_section_count(const ini_cache_t *cache)
+{
+    return cache->header->section_count;
+}
+
+/* Binary search on entries of either cache_section_t or cache_item_t, which begin with a hash and a name offset. */
+static const uint32_t* __find_entry(const void *base, size_t count, size_t stride, const char *strings, const char *name)
+{
+    uint32_t hash = __hash_of(name);
+    size_t low = 0, high = count;
+
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+
+        if (((const uint32_t *)((const char *)base + mid * stride))[0] < hash)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    for (; low < count; ++low)
+    {
+        const uint32_t *entry = (const uint32_t *)((const char *)base + low * stride);
+
+        if (hash != entry[0])
+            break;
+
+        if (0 == strcmp(strings + entry[1], name))
+            return entry;
+    }
+
+    return NULL;
+}
+
+const char* ini_cache_find_section(const ini_cache_t *cache, const char *section)
+{
+    const cache_section_t *sec = (NULL == section) ? NULL
+        : (const cache_section_t *)__find_entry(cache->sections, cache->header->section_count,
+            sizeof(cache_section_t), cache->strings, section);
+
+    return (NULL == sec) ? NULL : (cache->strings + sec->name);
+}
+
+const char* ini_cache_get(const ini_cache_t *cache, const char *section, const char *key)
+{
+    const cache_section_t *sec = (NULL == section || NULL == key) ? NULL
+        : (const cache_section_t *)__find_entry(cache->sections, cache->header->section_count,
+            sizeof(cache_section_t), cache->strings, section);
+    const cache_item_t *item = (NULL == sec) ? NULL
+        : (const cache_item_t *)__find_entry(cache->items + sec->first_item, sec->item_count,
+            sizeof(cache_item_t), cache->strings, key);
+
+    return (NULL == item) ? NULL : (cache->strings + item->value);
+}
+
+#else /* Windows */
+
+ini_cache_t* ini_cache_load(const char *src_path, const char *nullable_cache_path, int parse_options, int *nullable_error)
+{
+    if (NULL != nullable_error)
+        *nullable_error = -INI_CACHE_ERR_NOT_SUPPORTED;
+
+    return NULL;
+}
+
+int ini_cache_save(ini_doc_t *doc, int parse_options, const char *src_path, const char *cache_path)
+{
+    return -INI_CACHE_ERR_NOT_SUPPORTED;
+}
+
+void ini_cache_close(ini_cache_t *cache)
+{
+}
+
+int ini_cache_is_reparsed(const ini_cache_t *cache)
+{
+    return 1;
+}
+
+size_t ini_cache_section_count(const ini_cache_t *cache)
+{
+    return 0;
+}
+
+const char* ini_cache_find_section(const ini_cache_t *cache, const char *section)
+{
+    return NULL;
+}
+
+const char* ini_cache_get(const ini_cache_t *cache, const char *section, const char *key)
+{
+    return NULL;
+}
+
+#endif /* #if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS) */
+
+#ifdef TEST
+
+#include "sleeps.h"
+
+static int check_contents(const ini_cache_t *cache, const char *expected_a)
+{
+    const char *a = ini_cache_get(cache, "test", "a");
+
+    return (NULL != a && 0 == strcmp(a, expected_a) && 0 == strcmp(ini_cache_get(cache, "test", "b"), "2")
+        && 0 == strcmp(ini_cache_get(cache, "other", "c"), "x = y") && NULL != ini_cache_find_section(cache, "empty")
+        && NULL == ini_cache_get(cache, "other", "a") && NULL == ini_cache_get(cache, "missing", "a")
+        && NULL == ini_cache_find_section(cache, "missing") && 3 == ini_cache_section_count(cache));
+}
+
+/* Overwrites part of the cache file, leaving its header intact. */
+static int corrupt_cache(const char *path, long offset, int whence, const void *data, size_t size)
+{
+    FILE *stream = fopen(path, "r+b");
+    int ok = (NULL != stream && 0 == fseek(stream, offset, whence) && 1 == fwrite(data, size, 1, stream));
+
+    if (NULL != stream)
+        fclose(stream);
+
+    return ok;
+}
+
+static void change_source(const char *src_path)
+{
+    FILE *stream = fopen(src_path, "a");
+
+    if (NULL != stream)
+    {
+        fprintf(stream, "[late]\n");
+        fclose(stream);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *SRC_PATH = "ini_cache_test.ini";
+    const char *CACHE_PATH = "ini_cache_test.ini.cache";
+    const char *BIG_PATH = "ini_cache_bench.ini";
+    FILE *stream = NULL;
+    ini_cache_t *cache = NULL;
+    double begin = 0;
+    double ms[2];
+    static const uint32_t BAD_NUM = UINT32_MAX;
+    static const struct
+    {
+        const char *desc;
+        long offset;
+        int whence;
+        const void *data;
+    } CORRUPTIONS[] = {
+        { "a name beyond the string table", sizeof(cache_header_t) + sizeof(uint32_t), SEEK_SET, &BAD_NUM }
+        , { "items beyond the item table", sizeof(cache_header_t) + sizeof(uint32_t) * 3, SEEK_SET, &BAD_NUM }
+        , { "an unterminated string table", -1, SEEK_END, "x" }
+    };
+    int i, err = 0;
+
+    /* Repeated sections are merged, and the first one of repeated items wins. */
+    if (NULL == (stream = fopen(SRC_PATH, "w")))
+        return -1;
+    fprintf(stream, "[test]\na = 1\n; comment\n\n[other]\nc = x = y\n[test]\na = 3\nb = 2\n[empty]\n");
+    fclose(stream);
+
+    if (NULL == (cache = ini_cache_load(SRC_PATH, NULL, INI_PARSE_STRIP_BLANKS, &err))
+        || !ini_cache_is_reparsed(cache) || !check_contents(cache, "1"))
+    {
+        fprintf(stderr, "First loading should parse the source and give right contents: %s\n", ini_cache_error(err));
+        goto TEST_END;
+    }
+    ini_cache_close(cache);
+
+    if (NULL == (cache = ini_cache_load(SRC_PATH, NULL, INI_PARSE_STRIP_BLANKS, &err))
+        || ini_cache_is_reparsed(cache) || !check_contents(cache, "1"))
+    {
+        fprintf(stderr, "Second loading should use the cache file: %s\n", ini_cache_error(err));
+        goto TEST_END;
+    }
+    ini_cache_close(cache);
+
+    if (NULL == (cache = ini_cache_load(SRC_PATH, NULL, 0, &err)) || !ini_cache_is_reparsed(cache))
+    {
+        fprintf(stderr, "Loading with different parse options should parse the source again: %s\n", ini_cache_error(err));
+        goto TEST_END;
+    }
+    ini_cache_close(cache);
+
+    /* Same size and possibly same mtime, so only the content hash tells the difference. */
+    if (NULL == (stream = fopen(SRC_PATH, "r+")))
+        goto TEST_END;
+    fprintf(stream, "[test]\na = 9\n");
+    fclose(stream);
+    if (NULL == (cache = ini_cache_load(SRC_PATH, NULL, INI_PARSE_STRIP_BLANKS, &err))
+        || !ini_cache_is_reparsed(cache) || !check_contents(cache, "9"))
+    {
+        fprintf(stderr, "Changes of the source should invalidate the cache: %s\n", ini_cache_error(err));
+        goto TEST_END;
+    }
+    ini_cache_close(cache);
+    cache = NULL;
+
+    for (i = 0; i < (int)(sizeof(CORRUPTIONS) / sizeof(CORRUPTIONS[0])); ++i)
+    {
+        if (!corrupt_cache(CACHE_PATH, CORRUPTIONS[i].offset, CORRUPTIONS[i].whence, CORRUPTIONS[i].data,
+                (SEEK_END == CORRUPTIONS[i].whence) ? 1 : sizeof(uint32_t))
+            || NULL == (cache = ini_cache_load(SRC_PATH, NULL, INI_PARSE_STRIP_BLANKS, &err))
+            || !ini_cache_is_reparsed(cache) || !check_contents(cache, "9"))
+        {
+            fprintf(stderr, "A cache file with %s should be rebuilt: %s\n", CORRUPTIONS[i].desc, ini_cache_error(err));
+            goto TEST_END;
+        }
+        ini_cache_close(cache);
+        cache = NULL;
+    }
+
+    /* Contents parsed before the change are still served, but never saved with the stamp of the old file. */
+    remove(CACHE_PATH);
+    s_after_parsing_hook = change_source;
+    cache = ini_cache_load(SRC_PATH, NULL, INI_PARSE_STRIP_BLANKS, &err);
+    s_after_parsing_hook = NULL;
+    if (NULL == cache || !ini_cache_is_reparsed(cache) || !check_contents(cache, "9") || 0 == access(CACHE_PATH, F_OK))
+    {
+        fprintf(stderr, "A source changed during compilation should be served from memory only: %s\n", ini_cache_error(err));
+        goto TEST_END;
+    }
+    ini_cache_close(cache);
+    cache = NULL;
+
+    if (NULL == (stream = fopen(BIG_PATH, "w")))
+        goto TEST_END;
+    for (i = 0; i < 100000; ++i)
+    {
+        fprintf(stream, "[device%06d]\nid = %d\nname = device-%d\nenabled = yes\n\n", i, i, i);
+    }
+    fclose(stream);
+
+    for (i = 0; i < 2; ++i)
+    {
+        begin = monotonic_milliseconds();
+        cache = ini_cache_load(BIG_PATH, NULL, INI_PARSE_STRIP_BLANKS, &err);
+        ms[i] = monotonic_milliseconds() - begin;
+        if (NULL == cache || ini_cache_is_reparsed(cache) != !i || 100000 != ini_cache_section_count(cache)
+            || 0 != strcmp(ini_cache_get(cache, "device099999", "name"), "device-99999"))
+        {
+            fprintf(stderr, "Loading of a big file failed: %s\n", ini_cache_error(err));
+            goto TEST_END;
+        }
+        ini_cache_close(cache);
+        cache = NULL;
+    }
+
+    printf("Loading of 100000 sections: parsing and compiling: %.1f ms, from the cache: %.1f ms\n", ms[0], ms[1]);
+    printf("All tests passed.\n");
+    err = 1;
+
+TEST_END:
+
+    ini_cache_close(cache);
+    remove(SRC_PATH);
+    remove(CACHE_PATH);
+    remove(BIG_PATH);
+    remove("ini_cache_bench.ini.cache");
+
+    return (1 == err) ? 0 : -1;
+}
+
+#endif /* #ifdef TEST */
+
+#ifdef __cplusplus
+}
+#endif
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. Keep the in-memory cache of a source file changed during compilation,
+ *      and reject cache files whose sections, items or strings go beyond them.
+ */
+
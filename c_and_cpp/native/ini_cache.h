@@ -0,0 +1,91 @@
+/*
+ * Binary compiled cache of an INI file, which is mapped and looked up in place
+ * instead of parsing the text on every launch.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __INI_CACHE_H__
+#define __INI_CACHE_H__
+
+#include "ini_file.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Layout of a cache file, in native byte order since it's only meant for the local machine:
+ *
+ *  header | sections sorted by (hash, name) | items of each section sorted by (hash, key) | string table
+ *
+ * The header records the modification time, size and content hash of the source file,
+ * and the cache is used only if all of them still match.
+ * Repeated sections are merged and the first one of repeated items wins, same as ini_flat_map_c.
+ */
+typedef struct ini_cache_t ini_cache_t;
+
+const char* ini_cache_error(int error_code);
+
+/*
+ * Maps the cache file and validates it against the source file,
+ * or parses the source file and rewrites the cache file if the cache is missing or stale.
+ * The cache path is the source path plus ".cache" if not specified.
+ * A cache which fails to be written (e.g., on a read-only file system) is still usable in memory,
+ * and so is one whose source file changes while being compiled, which is not written then.
+ * A cache file which is corrupted is treated as stale.
+ * Only INI_PARSE_STRIP_BLANKS of parse_options makes a difference to the contents,
+ * and a cache built with a different setting of it is considered stale.
+ */
+ini_cache_t* ini_cache_load(const char *src_path, const char *nullable_cache_path,
+    int parse_options/* = 0 or INI_PARSE_* flags */, int *nullable_error);
+
+/*
+ * Compiles a document parsed from the source file with parse_options into the cache file,
+ * e.g., to prepare caches at build time. Returns 0 on success or a negative error code.
+ */
+int ini_cache_save(ini_doc_t *doc, int parse_options/* = the one for parsing doc */,
+    const char *src_path, const char *cache_path);
+
+void ini_cache_close(ini_cache_t *cache);
+
+/* Returns 1 if the source file was parsed by ini_cache_load(), or 0 if the cache file was used. */
+int ini_cache_is_reparsed(const ini_cache_t *cache);
+
+size_t ini_cache_section_count(const ini_cache_t *cache);
+
+/* Returns the name stored in the cache, or NULL if not found. */
+const char* ini_cache_find_section(const ini_cache_t *cache, const char *section);
+
+/* Returns the value, or NULL if the section or the key is not found. */
+const char* ini_cache_get(const ini_cache_t *cache, const char *section, const char *key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __INI_CACHE_H__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. Keep the in-memory cache of a source file changed during compilation,
+ *      and reject corrupted cache files.
+ */
+
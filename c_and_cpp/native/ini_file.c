@@ -1,7 +1,7 @@
 /*
  * APIs for Windows .ini file manipulation.
  *
- * Copyright (c) 2021-2022 Man Hung-Coeng <udc577@126.com>
+ * Copyright (c) 2021-2026 Man Hung-Coeng <udc577@126.com>
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -21,33 +21,96 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+#include <fcntl.h> /* For open(). */
+#include <unistd.h> /* For close(). */
+#include <sys/stat.h> /* For fstat(). */
+#include <sys/mman.h> /* For mmap() and munmap(). */
+#include <pthread.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define INI_IN_ARENA_NODE       0x01
+#define INI_IN_ARENA_DETAIL     0x02 /* Including the text of a comment node. */
+#define INI_IN_ARENA_NAME       0x04 /* Name of a section node, or key of an item node. */
+#define INI_IN_ARENA_VALUE      0x08
+#define INI_IN_ARENA_ALL        (INI_IN_ARENA_NODE | INI_IN_ARENA_DETAIL | INI_IN_ARENA_NAME | INI_IN_ARENA_VALUE)
+
 struct ini_node_t
 {
     char type;
+    unsigned char arena_mask; /* Tells which parts of this node are allocated from the arena of the document. */
     void *detail;
     struct ini_node_t *next;
 };
 
+typedef struct ini_change_log_t
+{
+    size_t trackers; /* Consumers which have turned tracking on, and not off yet. */
+    unsigned long base_seq; /* Sequence number of entries[0]. */
+    ini_change_t *entries;
+    size_t count;
+    size_t capacity;
+    char **retired_strs; /* Strings replaced since the last clearing, freed on clearing by the only tracker. */
+    size_t retired_count;
+    size_t retired_capacity;
+    struct ini_node_t *retired_nodes; /* Same as above, but for removed nodes, linked by their next pointers. */
+} ini_change_log_t;
+
+typedef struct ini_arena_t /* Header of a chunk, followed by the capacity bytes of the chunk. */
+{
+    struct ini_arena_t *prev;
+    size_t capacity;
+    size_t used;
+} ini_arena_t;
+
+typedef struct ini_index_t
+{
+    size_t bucket_count; /* Always a power of 2. */
+    size_t node_count;
+    struct ini_node_t **buckets;
+} ini_index_t;
+
+typedef struct ini_hash_link_t
+{
+    unsigned long hash;
+    struct ini_node_t *next; /* Next node in the same bucket. */
+    ini_index_t *owner; /* NULL if the node is not indexed. */
+} ini_hash_link_t;
+
 struct ini_doc_t
 {
     struct ini_node_t *preamble;
     struct ini_node_t *section;
+    ini_index_t *sec_index; /* NULL if INI_PARSE_HASH_INDEX is not specified. */
+    ini_arena_t *arena; /* NULL if INI_PARSE_ARENA is not specified. */
+    char *mapping; /* Non-NULL if parsed by ini_parse_from_file_mmap(). */
+    size_t mapping_len;
+    char *last_line; /* Copy of the last line of the mapping if it has no newline. */
+    ini_change_log_t changes;
 };
 
 typedef struct ini_section_t
 {
     char *name;
+    size_t name_len;
     struct ini_node_t *sub;
+    ini_hash_link_t link;
+    ini_index_t *item_index; /* Same as ini_doc_t::sec_index. */
+    struct ini_doc_t *doc; /* NULL if not attached to a document yet. */
 } ini_section_t;
 
 typedef struct ini_item_t
 {
     char *key;
     char *val;
+    size_t key_len;
+    size_t val_len;
+    ini_hash_link_t link;
+    struct ini_node_t *sec; /* NULL if not attached to a section yet. */
 } ini_item_t;
 
 enum
@@ -110,6 +173,7 @@ const char* ini_error(int error_code)
 }
 
 static const char *s_newline = "\n";
+static size_t s_newline_len = 1;
 
 void ini_set_newline(const char* const newline)
 {
@@ -121,10 +185,12 @@ void ini_set_newline(const char* const newline)
     )
     {
         s_newline = newline;
+        s_newline_len = strlen(newline);
     }
 }
 
 static char *s_indent_spaces = NULL;
+static size_t s_indent_width = 0;
 
 static void free_indent_spaces(void)
 {
@@ -132,6 +198,7 @@ static void free_indent_spaces(void)
     {
         free(s_indent_spaces);
         s_indent_spaces = NULL;
+        s_indent_width = 0;
     }
 }
 
@@ -147,10 +214,22 @@ void ini_set_item_indent_width(size_t width)
         s_indent_spaces = tmp;
         memset(s_indent_spaces, ' ', width);
         s_indent_spaces[width] = '\0';
+        s_indent_width = width;
         atexit(free_indent_spaces);
     }
 }
 
+#ifndef INI_PARSE_THREADS_MAX
+#define INI_PARSE_THREADS_MAX   64
+#endif
+
+static int s_parse_threads = 0;
+
+void ini_set_parse_threads(int count/* = 0 for the number of online CPUs */)
+{
+    s_parse_threads = (count < 0) ? 0 : ((count > INI_PARSE_THREADS_MAX) ? INI_PARSE_THREADS_MAX : count);
+}
+
 char ini_node_type(const ini_node_t *node)
 {
     return node->type;
@@ -161,30 +240,536 @@ char ini_node_type(const ini_node_t *node)
 #define IS_NEWLINE(ch)          ('\n' == (ch) || '\r' == (ch))
 #define IS_COMMENT_TAG(ch)      (';' == (ch) || '#' == (ch))
 
+/*
+ * ================
+ *  SCANNER
+ * ================
+ */
+
+#if !defined(INI_NO_SIMD) && defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#define INI_SIMD_NAME           "SSE2"
+#define INI_SIMD_SSE2
+#elif !defined(INI_NO_SIMD) && defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define INI_SIMD_NAME           "NEON"
+#define INI_SIMD_NEON
+#else
+#define INI_SIMD_NAME           "scalar"
+#endif
+
+/*
+ * Returns the first position in [pos, end) holding any of the 3 characters, or end if there is none.
+ * Classifies 16 bytes at a time if SIMD is available, and never reads beyond end.
+ */
+static const char* __scan_for(const char *pos, const char *end, char c1, char c2, char c3)
+{
+#if defined(INI_SIMD_SSE2)
+    const __m128i v1 = _mm_set1_epi8(c1);
+    const __m128i v2 = _mm_set1_epi8(c2);
+    const __m128i v3 = _mm_set1_epi8(c3);
+
+    for (; end - pos >= 16; pos += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)pos);
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, v1), _mm_cmpeq_epi8(block, v2)),
+            _mm_cmpeq_epi8(block, v3)));
+
+        if (0 != mask)
+            return pos + __builtin_ctz(mask);
+    }
+#elif defined(INI_SIMD_NEON)
+    const uint8x16_t v1 = vdupq_n_u8((uint8_t)c1);
+    const uint8x16_t v2 = vdupq_n_u8((uint8_t)c2);
+    const uint8x16_t v3 = vdupq_n_u8((uint8_t)c3);
+
+    for (; end - pos >= 16; pos += 16)
+    {
+        uint8x16_t block = vld1q_u8((const uint8_t *)pos);
+
+        if (0 != vmaxvq_u8(vorrq_u8(vorrq_u8(vceqq_u8(block, v1), vceqq_u8(block, v2)), vceqq_u8(block, v3))))
+            break; /* The loop below locates it within these 16 bytes. */
+    }
+#endif
+
+    for (; pos < end; ++pos)
+    {
+        if (c1 == *pos || c2 == *pos || c3 == *pos)
+            return pos;
+    }
+
+    return end;
+}
+
+#if defined(INI_SIMD_SSE2) || defined(INI_SIMD_NEON)
+static int __is_blank_block(const char *pos) /* Whether all the 16 bytes at pos are blanks. */
+{
+#if defined(INI_SIMD_SSE2)
+    __m128i block = _mm_loadu_si128((const __m128i *)pos);
+
+    return 0xFFFF == _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+        _mm_cmpeq_epi8(block, _mm_set1_epi8('\t'))));
+#else
+    uint8x16_t block = vld1q_u8((const uint8_t *)pos);
+
+    return 0 != vminvq_u8(vorrq_u8(vceqq_u8(block, vdupq_n_u8(' ')), vceqq_u8(block, vdupq_n_u8('\t'))));
+#endif
+}
+#endif
+
+/* Returns the first position in [pos, end) holding a non-blank character, or end if there is none. */
+static const char* __skip_blanks(const char *pos, const char *end)
+{
+#if defined(INI_SIMD_SSE2) || defined(INI_SIMD_NEON)
+    while (end - pos >= 16 && __is_blank_block(pos))
+        pos += 16;
+#endif
+
+    while (pos < end && IS_BLANK(*pos))
+        ++pos;
+
+    return pos;
+}
+
+/* Returns the length of the string of the specified length without trailing blanks. */
+static size_t __strip_tail_blanks(const char *str, size_t length)
+{
+#if defined(INI_SIMD_SSE2) || defined(INI_SIMD_NEON)
+    while (length >= 16 && __is_blank_block(str + length - 16))
+        length -= 16;
+#endif
+
+    while (length > 0 && IS_BLANK(str[length - 1]))
+        --length;
+
+    return length;
+}
+
+/*
+ * ================
+ *  ARENA
+ * ================
+ */
+
+#ifndef INI_ARENA_CHUNK_SIZE
+#define INI_ARENA_CHUNK_SIZE    (64 * 1024)
+#endif
+
+#define INI_ARENA_ALIGN(size)   (((size) + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *))
+
+static void* __arena_calloc(ini_arena_t **arena, size_t size)
+{
+    const size_t DEFAULT_CAPACITY = INI_ARENA_CHUNK_SIZE - sizeof(ini_arena_t);
+    ini_arena_t *chunk = *arena;
+    char *ptr = NULL;
+
+    size = INI_ARENA_ALIGN(size);
+
+    if (NULL == chunk || chunk->used + size > chunk->capacity)
+    {
+        size_t capacity = (size > DEFAULT_CAPACITY) ? size : DEFAULT_CAPACITY;
+
+        if (NULL == (chunk = (ini_arena_t *)malloc(sizeof(ini_arena_t) + capacity)))
+            return NULL;
+
+        chunk->capacity = capacity;
+        chunk->used = 0;
+
+        if (size > DEFAULT_CAPACITY && NULL != *arena) /* NOTE: Keeps the current chunk in use for small ones. */
+        {
+            chunk->prev = (*arena)->prev;
+            (*arena)->prev = chunk;
+        }
+        else
+        {
+            chunk->prev = *arena;
+            *arena = chunk;
+        }
+    }
+
+    ptr = (char *)(chunk + 1) + chunk->used;
+    chunk->used += size;
+    memset(ptr, 0, size);
+
+    return ptr;
+}
+
+static void __arena_destroy(ini_arena_t *arena)
+{
+    while (NULL != arena)
+    {
+        ini_arena_t *prev = arena->prev;
+
+        free(arena);
+        arena = prev;
+    }
+}
+
+/* Frees a part of a node unless it is in the arena, which is freed as a whole on ini_destroy(). */
+static void __release(ini_node_t *node, unsigned char part, void *ptr)
+{
+    if (node->arena_mask & part)
+        node->arena_mask &= ~part;
+    else
+        free(ptr);
+}
+
+/*
+ * ================
+ *  HASH INDEX
+ * ================
+ */
+
+#define INI_INDEX_INIT_BUCKETS  16
+
+static unsigned long __hash_of(const char *str, size_t len)
+{
+    unsigned long hash = 2166136261UL; /* FNV-1a */
+    size_t i = 0;
+
+    for (; i < len; ++i)
+    {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+static ini_hash_link_t* __link_of(const ini_node_t *node)
+{
+    return (INI_NODE_SECTION == node->type) ? &((ini_section_t *)node->detail)->link : &((ini_item_t *)node->detail)->link;
+}
+
+static const char* __name_of(const ini_node_t *node)
+{
+    return (INI_NODE_SECTION == node->type) ? ((ini_section_t *)node->detail)->name : ((ini_item_t *)node->detail)->key;
+}
+
+static size_t __name_len_of(const ini_node_t *node)
+{
+    return (INI_NODE_SECTION == node->type) ? ((ini_section_t *)node->detail)->name_len : ((ini_item_t *)node->detail)->key_len;
+}
+
+static bool __name_equals(const ini_node_t *node, const char *name, size_t name_len)
+{
+    return (__name_len_of(node) == name_len && 0 == memcmp(__name_of(node), name, name_len));
+}
+
+static ini_index_t* __index_create(void)
+{
+    ini_index_t *index = (ini_index_t *)calloc(1, sizeof(ini_index_t));
+
+    if (NULL == index)
+        return NULL;
+
+    if (NULL == (index->buckets = (ini_node_t **)calloc(INI_INDEX_INIT_BUCKETS, sizeof(ini_node_t *))))
+    {
+        free(index);
+
+        return NULL;
+    }
+    index->bucket_count = INI_INDEX_INIT_BUCKETS;
+
+    return index;
+}
+
+static void __index_destroy(ini_index_t *index)
+{
+    if (NULL != index)
+    {
+        free(index->buckets);
+        free(index);
+    }
+}
+
+static bool __node_precedes(const ini_node_t *former, const ini_node_t *latter)
+{
+    for (; NULL != former; former = former->next)
+    {
+        if (former == latter)
+            return true;
+    }
+
+    return false;
+}
+
+static int __index_grow(ini_index_t *index)
+{
+    size_t new_count = index->bucket_count * 2;
+    ini_node_t **new_buckets = (ini_node_t **)calloc(new_count, sizeof(ini_node_t *));
+    size_t i = 0;
+
+    if (NULL == new_buckets)
+        return -INI_ERR_MEM_ALLOC;
+
+    for (; i < index->bucket_count; ++i)
+    {
+        ini_node_t *node = index->buckets[i];
+
+        while (NULL != node)
+        {
+            ini_hash_link_t *link = __link_of(node);
+            ini_node_t *next = link->next;
+            ini_node_t **tail = &new_buckets[link->hash & (new_count - 1)];
+
+            while (NULL != *tail) /* NOTE: Appending keeps the relative order of nodes of the same name. */
+                tail = &__link_of(*tail)->next;
+
+            *tail = node;
+            link->next = NULL;
+            node = next;
+        }
+    }
+
+    free(index->buckets);
+    index->buckets = new_buckets;
+    index->bucket_count = new_count;
+
+    return 0;
+}
+
+static int __index_insert(ini_index_t *index, ini_node_t *node)
+{
+    ini_hash_link_t *link = __link_of(node);
+    const char *name = __name_of(node);
+    ini_node_t **pos = NULL;
+
+    if (index->node_count + 1 > index->bucket_count / 4 * 3 && __index_grow(index) < 0)
+        return -INI_ERR_MEM_ALLOC;
+
+    link->hash = __hash_of(name, __name_len_of(node));
+    link->owner = index;
+    pos = &index->buckets[link->hash & (index->bucket_count - 1)];
+
+    /*
+     * Nodes of the same name are chained in file order,
+     * so that a lookup finds the same node as a linear search does.
+     */
+    while (NULL != *pos)
+    {
+        ini_hash_link_t *cur = __link_of(*pos);
+
+        if (cur->hash == link->hash && __name_equals(*pos, name, __name_len_of(node)) && __node_precedes(node, *pos))
+            break;
+
+        pos = &cur->next;
+    }
+
+    link->next = *pos;
+    *pos = node;
+    index->node_count += 1;
+
+    return 0;
+}
+
+static void __index_remove(ini_node_t *node)
+{
+    ini_hash_link_t *link = __link_of(node);
+    ini_index_t *index = link->owner;
+    ini_node_t **pos = NULL;
+
+    if (NULL == index)
+        return;
+
+    pos = &index->buckets[link->hash & (index->bucket_count - 1)];
+    while (NULL != *pos && node != *pos)
+        pos = &__link_of(*pos)->next;
+
+    if (NULL != *pos)
+    {
+        *pos = link->next;
+        index->node_count -= 1;
+    }
+
+    link->next = NULL;
+    link->owner = NULL;
+}
+
+static void __index_update(ini_node_t *node)
+{
+    ini_index_t *owner = __link_of(node)->owner;
+
+    if (NULL != owner)
+    {
+        __index_remove(node);
+        __index_insert(owner, node); /* NOTE: Never fails, since the node count does not grow. */
+    }
+}
+
+static ini_node_t* __index_find(const ini_index_t *index, const char *name, size_t name_len,
+    bool *nullable_is_repeated)
+{
+    unsigned long hash = __hash_of(name, name_len);
+    ini_node_t *node = index->buckets[hash & (index->bucket_count - 1)];
+    ini_node_t *first = NULL;
+
+    for (; NULL != node; node = __link_of(node)->next)
+    {
+        if (hash == __link_of(node)->hash && __name_equals(node, name, name_len))
+        {
+            if (NULL != first || NULL == nullable_is_repeated)
+                break;
+
+            first = node;
+        }
+    }
+
+    if (NULL != nullable_is_repeated)
+        *nullable_is_repeated = (NULL != node);
+
+    return (NULL == first) ? node : first;
+}
+
+static ini_node_t* __linear_find(const ini_node_t *head, char node_type, const char *name, size_t name_len,
+    bool *nullable_is_repeated)
+{
+    const ini_node_t *node = head;
+    const ini_node_t *first = NULL;
+
+    for (; NULL != node; node = node->next)
+    {
+        if (node_type == node->type && __name_equals(node, name, name_len))
+        {
+            if (NULL != first || NULL == nullable_is_repeated)
+                break;
+
+            first = node;
+        }
+    }
+
+    if (NULL != nullable_is_repeated)
+        *nullable_is_repeated = (NULL != node);
+
+    return (ini_node_t *)((NULL == first) ? node : first);
+}
+
+static void __free_node(ini_node_t *node)
+{
+    if (INI_NODE_SECTION == node->type)
+    {
+        __release(node, INI_IN_ARENA_NAME, ((ini_section_t *)node->detail)->name);
+        __index_destroy(((ini_section_t *)node->detail)->item_index);
+    }
+    else if (INI_NODE_ITEM == node->type)
+    {
+        __release(node, INI_IN_ARENA_NAME, ((ini_item_t *)node->detail)->key);
+        __release(node, INI_IN_ARENA_VALUE, ((ini_item_t *)node->detail)->val);
+    }
+
+    if (INI_NODE_BLANK_LINE != node->type)
+        __release(node, INI_IN_ARENA_DETAIL, node->detail);
+
+    __release(node, INI_IN_ARENA_NODE, node);
+}
+
 static char* __get_from_string(char *buf, int buf_len, void *str, int str_len)
 {
     char *pos = (char *)str;
-    int counter = -1;
     const int MAX_LEN = (buf_len <= str_len) ? (buf_len - 1) : str_len;
 
-    while (++counter < MAX_LEN && (!IS_NEWLINE(*pos)) && '\0' != *pos)
+    if (MAX_LEN <= 0)
     {
-        buf[counter] = *pos;
-        ++pos;
+        buf[0] = '\0';
+
+        return NULL;
     }
-    buf[counter] = '\0';
 
-    return (MAX_LEN > 0) ? pos : NULL;
+    pos = (char *)__scan_for(pos, pos + MAX_LEN, '\n', '\r', '\0');
+    memcpy(buf, str, pos - (char *)str);
+    buf[pos - (char *)str] = '\0';
+
+    return pos;
 }
 
-static char* __get_from_stream(char *buf, int buf_len, void *stream, int unused_len)
+#ifndef INI_STREAM_BLOCK_SIZE
+#define INI_STREAM_BLOCK_SIZE   (64 * 1024)
+#endif
+
+typedef struct stream_cursor_t
+{
+    FILE *stream;
+    char *pos;
+    char *end;
+    char block[INI_STREAM_BLOCK_SIZE];
+} stream_cursor_t;
+
+/*
+ * Same as fgets() but reads the stream block by block and scans for newlines with __scan_for().
+ * NOTE: The stream is read ahead, so its position is not right after the last line returned.
+ */
+static char* __get_from_stream(char *buf, int buf_len, void *stream_cursor, int unused_len)
 {
-    return fgets(buf, buf_len, (FILE *)stream);
+    stream_cursor_t *cursor = (stream_cursor_t *)stream_cursor;
+    int len = 0;
+
+    while (len < buf_len - 1)
+    {
+        char *newline = NULL;
+        int count = 0;
+
+        if (cursor->pos >= cursor->end)
+        {
+            size_t read_len = fread(cursor->block, 1, sizeof(cursor->block), cursor->stream);
+
+            if (0 == read_len)
+                break;
+
+            cursor->pos = cursor->block;
+            cursor->end = cursor->block + read_len;
+        }
+
+        count = (cursor->end - cursor->pos < buf_len - 1 - len) ? (cursor->end - cursor->pos) : (buf_len - 1 - len);
+        newline = (char *)__scan_for(cursor->pos, cursor->pos + count, '\n', '\n', '\n');
+        if (newline < cursor->pos + count)
+            count = newline - cursor->pos + 1;
+
+        memcpy(buf + len, cursor->pos, count);
+        cursor->pos += count;
+        len += count;
+        if ('\n' == buf[len - 1])
+            break;
+    }
+    buf[len] = '\0';
+
+    return (len > 0) ? buf : NULL;
+}
+
+typedef struct mapping_cursor_t
+{
+    char *pos;
+    char *end; /* Right after the last newline. */
+    char *last_line; /* NULL if the mapping ends with a newline. */
+} mapping_cursor_t;
+
+/* NOTE: Returns the line itself instead of a copy, and terminates it in place. */
+static char* __get_from_mapping(char *unused_buf, int unused_buf_len, void *mapping_cursor, int unused_len)
+{
+    mapping_cursor_t *cursor = (mapping_cursor_t *)mapping_cursor;
+    char *line = cursor->pos;
+    char *newline = NULL;
+
+    if (line >= cursor->end)
+    {
+        line = cursor->last_line;
+        cursor->last_line = NULL;
+
+        return line;
+    }
+
+    newline = (char *)memchr(line, '\n', cursor->end - line);
+    *newline = '\0';
+    cursor->pos = newline + 1;
+
+    return line;
 }
 
 ini_doc_t* __parse_from(void *target, int target_size, char* (*getline_func)(char*, int, void*, int),
-    int strip_blanks, ini_summary_t *nullable_summary)
+    int options, ini_summary_t *nullable_summary)
 {
+    int strip_blanks = (options & INI_PARSE_STRIP_BLANKS);
+    int use_arena = (options & INI_PARSE_ARENA);
+    int in_situ = (__get_from_mapping == getline_func);
     ini_summary_t summary = { 0 }; /* Use it instead of nullable_summary for reducing the "if" statements. */
     ini_doc_t *doc = (ini_doc_t *)calloc(1, sizeof(ini_doc_t));
     ini_node_t *section = (NULL == doc) ? NULL : doc->section;
@@ -193,6 +778,19 @@ ini_doc_t* __parse_from(void *target, int target_size, char* (*getline_func)(cha
     int is_str = (target_size > 0);
     char *pos = NULL;
 
+    #define PARSE_CALLOC(size)                  (use_arena ? __arena_calloc(&doc->arena, (size)) : calloc(1, (size)))
+
+    #define PARSE_FREE(ptr)                     do { if (!use_arena) free(ptr); } while (0)
+
+    #define PARSE_TOKEN(dest, src, len)         do { \
+        if (in_situ) { \
+            (dest) = (src); \
+            (dest)[len] = '\0'; \
+        } \
+        else if (NULL != ((dest) = (char *)PARSE_CALLOC((len) + 1))) \
+            strncpy((dest), (src), (len)); \
+    } while (0)
+
     #define RETURN_IF_TRUE(conditions, errcode, free_mem_statements)   do { \
         if (conditions) { \
             if (NULL != doc) {\
@@ -209,18 +807,21 @@ ini_doc_t* __parse_from(void *target, int target_size, char* (*getline_func)(cha
     } while (0)
 
     RETURN_IF_TRUE(NULL == doc, -INI_ERR_MEM_ALLOC, ;);
+    RETURN_IF_TRUE((options & INI_PARSE_HASH_INDEX) && NULL == (doc->sec_index = __index_create()),
+        -INI_ERR_MEM_ALLOC, free(buf));
 
     while (NULL != (pos = getline_func(buf, INI_LINE_SIZE_MAX + 1, target, target_size)))
     {
         size_t length = 0;
-        char *head = buf;
+        char *head = in_situ ? pos : buf;
         char *tail = NULL;
         int is_blank_line = 0;
         int is_comment = 0;
         int is_section = 0;
-        ini_node_t *_this = (ini_node_t *)calloc(1, sizeof(ini_node_t));
+        ini_node_t *_this = (ini_node_t *)PARSE_CALLOC(sizeof(ini_node_t));
 
         RETURN_IF_TRUE(NULL == _this, -INI_ERR_MEM_ALLOC, free(buf));
+        _this->arena_mask = use_arena ? INI_IN_ARENA_ALL : 0;
 
         if (is_str)
         {
@@ -241,7 +842,7 @@ ini_doc_t* __parse_from(void *target, int target_size, char* (*getline_func)(cha
             while (IS_NEWLINE(*tail)) --tail;
 
             if (is_section || is_comment || strip_blanks)
-                while (IS_BLANK(*tail)) --tail;
+                tail = head + __strip_tail_blanks(head, tail - head + 1) - 1;
 
             length = tail - head + 1;
         }
@@ -253,135 +854,478 @@ ini_doc_t* __parse_from(void *target, int target_size, char* (*getline_func)(cha
             if (NULL == section && NULL == doc->preamble)
                 doc->preamble = _this;
 
-            if (NULL != section && NULL == ((ini_section_t *)section->detail)->sub)
-                ((ini_section_t *)section->detail)->sub = _this;
+            if (NULL != section && NULL == ((ini_section_t *)section->detail)->sub)
+                ((ini_section_t *)section->detail)->sub = _this;
+
+            summary.blank_lines += 1;
+        }
+        else if (is_comment)
+        {
+            char *comment = NULL;
+
+            _this->type = INI_NODE_COMMENT;
+
+            PARSE_TOKEN(comment, head, length);
+            RETURN_IF_TRUE(NULL == comment, -INI_ERR_MEM_ALLOC, PARSE_FREE(_this);free(buf));
+            _this->detail = comment;
+
+            if (NULL == section && NULL == doc->preamble)
+                doc->preamble = _this;
+
+            if (NULL != section && NULL == ((ini_section_t *)section->detail)->sub)
+                ((ini_section_t *)section->detail)->sub = _this;
+
+            summary.comment_lines += 1;
+        }
+        else if (is_section)
+        {
+            char *name = NULL;
+            size_t counter = 0;
+            int has_extra_brackets = 0;
+
+            RETURN_IF_TRUE(1 == length || ']' == head[1], -INI_ERR_NULL_SECTION_NAME, PARSE_FREE(_this);free(buf));
+            RETURN_IF_TRUE(']' != head[length - 1], -INI_ERR_BAD_FORMAT, PARSE_FREE(_this);free(buf));
+
+            ++head;
+            --tail;
+            head = (char *)__skip_blanks(head, tail + 1);
+            RETURN_IF_TRUE(head > tail, -INI_ERR_NULL_SECTION_NAME, PARSE_FREE(_this);free(buf));
+            tail = head + __strip_tail_blanks(head, tail - head + 1) - 1;
+            RETURN_IF_TRUE(head > tail, -INI_ERR_NULL_SECTION_NAME, PARSE_FREE(_this);free(buf));
+            length = tail - head + 1;
+            counter = __scan_for(head, head + length, '[', ']', '[') - head;
+            has_extra_brackets = (counter < length);
+            RETURN_IF_TRUE(has_extra_brackets, -INI_ERR_BAD_FORMAT, PARSE_FREE(_this);free(buf));
+
+            _this->type = INI_NODE_SECTION;
+
+            _this->detail = PARSE_CALLOC(sizeof(ini_section_t));
+            RETURN_IF_TRUE(NULL == _this->detail, -INI_ERR_MEM_ALLOC, PARSE_FREE(_this);free(buf));
+
+            PARSE_TOKEN(name, head, length);
+            RETURN_IF_TRUE(NULL == name, -INI_ERR_MEM_ALLOC, PARSE_FREE(_this->detail);PARSE_FREE(_this);free(buf));
+            ((ini_section_t *)_this->detail)->name = name;
+            ((ini_section_t *)_this->detail)->doc = doc;
+            ((ini_section_t *)_this->detail)->name_len = length;
+
+            if (NULL == section)
+                doc->section = _this;
+            else
+                section->next = _this;
+
+            section = _this;
+
+            prev = NULL; /* NOTE: An non-section node cannot be its precedent. */
+
+            summary.section_lines += 1;
+        }
+        else
+        {
+            char *key = NULL;
+            char *val = NULL;
+            int is_orphan = (NULL == section);
+            char *equal_sign = is_orphan ? NULL : (char *)__scan_for(head, tail + 1, '=', '=', '=');
+            char *val_head = NULL;
+
+            if (tail + 1 == equal_sign)
+                equal_sign = NULL;
+            val_head = (NULL == equal_sign) ? NULL : equal_sign + 1;
+
+            RETURN_IF_TRUE(is_orphan || NULL == equal_sign || equal_sign == head,
+                is_orphan ? -INI_ERR_ORPHAN_ITEM : ((NULL == equal_sign) ? -INI_ERR_BAD_FORMAT : -INI_ERR_NULL_KEY),
+                PARSE_FREE(_this);free(buf));
+
+            _this->type = INI_NODE_ITEM;
+
+            _this->detail = PARSE_CALLOC(sizeof(ini_item_t));
+            RETURN_IF_TRUE(NULL == _this->detail, -INI_ERR_MEM_ALLOC, PARSE_FREE(_this);free(buf));
+
+            if (strip_blanks && NULL != val_head)
+                val_head = (char *)__skip_blanks(val_head, tail + 1);
+            length = (tail >= val_head ) ? (tail - val_head + 1) : 0;
+            PARSE_TOKEN(val, val_head, length);
+            RETURN_IF_TRUE(NULL == val, -INI_ERR_MEM_ALLOC, PARSE_FREE(_this->detail);PARSE_FREE(_this);free(buf));
+            ((ini_item_t *)_this->detail)->val = val;
+            ((ini_item_t *)_this->detail)->val_len = length;
+
+            length = __strip_tail_blanks(head, equal_sign - head);
+            PARSE_TOKEN(key, head, length);
+            RETURN_IF_TRUE(NULL == key, -INI_ERR_MEM_ALLOC, PARSE_FREE(val);PARSE_FREE(_this->detail);PARSE_FREE(_this);free(buf));
+            ((ini_item_t *)_this->detail)->key = key;
+            ((ini_item_t *)_this->detail)->sec = section;
+            ((ini_item_t *)_this->detail)->key_len = length;
+
+            if (NULL == ((ini_section_t *)section->detail)->sub)
+                ((ini_section_t *)section->detail)->sub = _this;
+        }
+
+        if (_this != section)
+        {
+            if (NULL != prev)
+                prev->next = _this;
+
+            prev = _this;
+        }
+
+        if (NULL != doc->sec_index && (INI_NODE_SECTION == _this->type || INI_NODE_ITEM == _this->type))
+        {
+            ini_section_t *sec_detail = (ini_section_t *)section->detail;
+            int failed = (_this == section && NULL == (sec_detail->item_index = __index_create()));
+
+            RETURN_IF_TRUE(failed || __index_insert((_this == section) ? doc->sec_index : sec_detail->item_index, _this) < 0,
+                -INI_ERR_MEM_ALLOC, free(buf));
+        }
+
+        summary.success_lines += 1;
+    } /* while (NULL != fgets() */
+
+    free(buf);
+
+    if (NULL != nullable_summary)
+        memcpy(nullable_summary, &summary, sizeof(ini_summary_t));
+
+    return doc;
+}
+
+/*
+ * ================
+ *  PARALLEL PARSING
+ * ================
+ */
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+
+#ifndef INI_PARSE_CHUNK_MIN
+#define INI_PARSE_CHUNK_MIN     (256 * 1024) /* Not worth a thread if smaller. */
+#endif
+
+typedef struct parse_chunk_t
+{
+    char *begin;
+    char *end;
+    mapping_cursor_t cursor; /* For mappings only. */
+    int options;
+    ini_doc_t *doc;
+    ini_summary_t summary;
+} parse_chunk_t;
+
+static void* __parse_chunk(void *parse_chunk)
+{
+    parse_chunk_t *chunk = (parse_chunk_t *)parse_chunk;
+
+    if (NULL != chunk->cursor.pos)
+        chunk->doc = __parse_from(&chunk->cursor, 0, __get_from_mapping, chunk->options, &chunk->summary);
+    else
+        chunk->doc = __parse_from(chunk->begin, chunk->end - chunk->begin, __get_from_string, chunk->options, &chunk->summary);
+
+    return NULL;
+}
+
+/* Returns the beginning of the first section line at or after pos, or end if there is none. */
+static char* __next_section_line(char *pos, char *begin, char *end)
+{
+    char *newline = NULL;
+
+    if (pos > begin && '\n' != pos[-1])
+    {
+        if (NULL == (newline = (char *)memchr(pos, '\n', end - pos)))
+            return end;
+        pos = newline + 1;
+    }
+
+    while (pos < end)
+    {
+        char *head = pos;
+
+        head = (char *)__skip_blanks(head, end);
+        if (head < end && '[' == *head)
+            return pos;
+
+        if (NULL == (newline = (char *)memchr(head, '\n', end - head)))
+            return end;
+        pos = newline + 1;
+    }
+
+    return end;
+}
+
+/*
+ * Every chunk but the first one begins with a section line, so the documents parsed from them
+ * have no preambles, and joining their sections one after another gives the same result
+ * as parsing the whole text sequentially.
+ */
+static ini_doc_t* __join_chunks(parse_chunk_t *chunks, int count, ini_summary_t *nullable_summary)
+{
+    ini_summary_t summary = { 0 };
+    ini_doc_t *doc = NULL;
+    ini_node_t *tail = NULL;
+    int failed = -1;
+    int i;
+
+    for (i = 0; i < count && failed < 0; ++i)
+    {
+        summary.success_lines += chunks[i].summary.success_lines;
+        summary.section_lines += chunks[i].summary.section_lines;
+        summary.comment_lines += chunks[i].summary.comment_lines;
+        summary.blank_lines += chunks[i].summary.blank_lines;
+        if (NULL == chunks[i].doc)
+        {
+            failed = i;
+            summary.error_code = chunks[i].summary.error_code;
+        }
+    }
+
+    if (failed < 0)
+    {
+        doc = chunks[0].doc;
+        for (tail = doc->section; NULL != tail && NULL != tail->next; tail = tail->next)
+            ;
+
+        for (i = 1; i < count; ++i)
+        {
+            ini_doc_t *sub = chunks[i].doc;
+            ini_arena_t *oldest = sub->arena;
+            ini_node_t *sec = sub->section;
+
+            for (; NULL != sec; sec = sec->next)
+            {
+                ((ini_section_t *)sec->detail)->doc = doc;
+                if (NULL == sec->next)
+                    break;
+            }
+
+            if (NULL == tail)
+                doc->section = sub->section;
+            else
+                tail->next = sub->section;
+            if (NULL != sec)
+                tail = sec;
+
+            while (NULL != oldest && NULL != oldest->prev)
+                oldest = oldest->prev;
+            if (NULL != oldest)
+            {
+                oldest->prev = doc->arena;
+                doc->arena = sub->arena;
+            }
+
+            __index_destroy(sub->sec_index);
+            free(sub);
+            chunks[i].doc = NULL;
+        }
+
+        /* Sections of the first chunk are indexed already. */
+        for (tail = (NULL == doc->sec_index) ? NULL : doc->section; NULL != tail; tail = tail->next)
+        {
+            if (doc->sec_index != __link_of(tail)->owner && __index_insert(doc->sec_index, tail) < 0)
+            {
+                ini_destroy(doc);
+                doc = NULL;
+                summary.error_code = -INI_ERR_MEM_ALLOC;
+                break;
+            }
+        }
+    }
+    else
+    {
+        for (i = 0; i < count; ++i)
+        {
+            ini_destroy(chunks[i].doc);
+        }
+    }
+
+    if (NULL != nullable_summary)
+        memcpy(nullable_summary, &summary, sizeof(ini_summary_t));
+
+    return doc;
+}
+
+/* NOTE: The text is a mapping to parse in place if nullable_cursor is not NULL, otherwise a buffer. */
+static ini_doc_t* __parse_in_parallel(char *begin, char *end, mapping_cursor_t *nullable_cursor,
+    int options, ini_summary_t *nullable_summary)
+{
+    parse_chunk_t chunks[INI_PARSE_THREADS_MAX];
+    pthread_t threads[INI_PARSE_THREADS_MAX];
+    int created[INI_PARSE_THREADS_MAX] = { 0 };
+    long thread_count = (s_parse_threads > 0) ? s_parse_threads : sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_count = (size_t)(end - begin) / INI_PARSE_CHUNK_MIN;
+    int count = 0;
+    int i;
+    char *pos = begin;
+
+    if (thread_count > INI_PARSE_THREADS_MAX)
+        thread_count = INI_PARSE_THREADS_MAX;
+    if (max_count > (size_t)thread_count)
+        max_count = (size_t)thread_count;
+
+    while (pos < end && (size_t)count < max_count)
+    {
+        char *target = begin + (end - begin) / max_count * (count + 1);
+        char *next = ((size_t)count + 1 == max_count) ? end
+            : __next_section_line((target > pos) ? target : (pos + 1), begin, end);
+
+        memset(&chunks[count], 0, sizeof(parse_chunk_t));
+        chunks[count].begin = pos;
+        chunks[count].end = next;
+        chunks[count].options = options;
+        if (NULL != nullable_cursor)
+        {
+            chunks[count].cursor.pos = pos;
+            chunks[count].cursor.end = next;
+        }
+        ++count;
+        pos = next;
+    }
+
+    if (count <= 1)
+    {
+        return (NULL == nullable_cursor)
+            ? __parse_from(begin, end - begin, __get_from_string, options, nullable_summary)
+            : __parse_from(nullable_cursor, 0, __get_from_mapping, options, nullable_summary);
+    }
+
+    if (NULL != nullable_cursor)
+        chunks[count - 1].cursor.last_line = nullable_cursor->last_line;
+
+    for (i = 1; i < count; ++i)
+    {
+        created[i] = (0 == pthread_create(&threads[i], NULL, __parse_chunk, &chunks[i]));
+    }
+
+    __parse_chunk(&chunks[0]);
 
-            summary.blank_lines += 1;
-        }
-        else if (is_comment)
-        {
-            _this->type = INI_NODE_COMMENT;
+    for (i = 1; i < count; ++i)
+    {
+        if (created[i])
+            pthread_join(threads[i], NULL);
+        else
+            __parse_chunk(&chunks[i]); /* Runs in the current thread if failed to create one. */
+    }
 
-            _this->detail = calloc(length + 1, sizeof(char));
-            RETURN_IF_TRUE(NULL == _this->detail, -INI_ERR_MEM_ALLOC, free(_this);free(buf));
-            strncpy((char *)_this->detail, head, length);
+    return __join_chunks(chunks, count, nullable_summary);
+}
 
-            if (NULL == section && NULL == doc->preamble)
-                doc->preamble = _this;
+#else
 
-            if (NULL != section && NULL == ((ini_section_t *)section->detail)->sub)
-                ((ini_section_t *)section->detail)->sub = _this;
+#define __parse_in_parallel(begin, end, nullable_cursor, options, nullable_summary) \
+    __parse_from((begin), (end) - (begin), __get_from_string, (options), (nullable_summary))
 
-            summary.comment_lines += 1;
-        }
-        else if (is_section)
-        {
-            char *name = NULL;
-            size_t counter = 0;
-            int has_extra_brackets = 0;
+#endif /* #if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS) */
 
-            RETURN_IF_TRUE(1 == length || ']' == head[1], -INI_ERR_NULL_SECTION_NAME, free(_this);free(buf));
-            RETURN_IF_TRUE(']' != head[length - 1], -INI_ERR_BAD_FORMAT, free(_this);free(buf));
+ini_doc_t* ini_parse_from_stream(FILE *stream, int options/* = 0 or INI_PARSE_* flags */,
+    ini_summary_t *nullable_summary/* = NULL if failure reason not cared*/)
+{
+    stream_cursor_t *cursor = (stream_cursor_t *)malloc(sizeof(stream_cursor_t));
+    ini_doc_t *doc = NULL;
 
-            ++head;
-            --tail;
-            while (IS_BLANK(*head)) ++head;
-            RETURN_IF_TRUE(head > tail, -INI_ERR_NULL_SECTION_NAME, free(_this);free(buf));
-            while (IS_BLANK(*tail)) --tail;
-            RETURN_IF_TRUE(head > tail, -INI_ERR_NULL_SECTION_NAME, free(_this);free(buf));
-            length = tail - head + 1;
-            while (counter < length && '[' != head[counter] && ']' != head[counter]) ++counter;
-            has_extra_brackets = (counter < length);
-            RETURN_IF_TRUE(has_extra_brackets, -INI_ERR_BAD_FORMAT, free(_this);free(buf));
+    if (NULL == cursor)
+    {
+        if (NULL != nullable_summary)
+        {
+            memset(nullable_summary, 0, sizeof(ini_summary_t));
+            nullable_summary->error_code = -INI_ERR_MEM_ALLOC;
+        }
 
-            _this->type = INI_NODE_SECTION;
+        return NULL;
+    }
 
-            _this->detail = calloc(1, sizeof(ini_section_t));
-            RETURN_IF_TRUE(NULL == _this->detail, -INI_ERR_MEM_ALLOC, free(_this);free(buf));
+    cursor->stream = stream;
+    cursor->pos = cursor->block;
+    cursor->end = cursor->block;
+    doc = __parse_from(cursor, 0, __get_from_stream, options, nullable_summary);
+    free(cursor);
 
-            name = (char *)calloc(length + 1, sizeof(char));
-            RETURN_IF_TRUE(NULL == name, -INI_ERR_MEM_ALLOC, free(_this->detail);free(_this);free(buf));
-            strncpy(name, head, length);
-            ((ini_section_t *)_this->detail)->name = name;
+    return doc;
+}
 
-            if (NULL == section)
-                doc->section = _this;
-            else
-                section->next = _this;
+ini_doc_t* ini_parse_from_buffer(char *buf, size_t buf_len, int options/* = 0 or INI_PARSE_* flags */,
+    ini_summary_t *nullable_summary/* = NULL if failure reason not cared*/)
+{
+    if (options & INI_PARSE_PARALLEL)
+        return __parse_in_parallel(buf, buf + buf_len, NULL, options, nullable_summary);
 
-            section = _this;
+    return __parse_from(buf, buf_len, __get_from_string, options, nullable_summary);
+}
 
-            prev = NULL; /* NOTE: An non-section node cannot be its precedent. */
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
 
-            summary.section_lines += 1;
-        }
-        else
-        {
-            char *key = NULL;
-            char *val = NULL;
-            int is_orphan = (NULL == section);
-            char *equal_sign = is_orphan ? NULL : strchr(head, '=');
-            char *val_head = (NULL == equal_sign) ? NULL : equal_sign + 1;
+ini_doc_t* ini_parse_from_file_mmap(const char *path, int options/* = 0 or INI_PARSE_* flags */,
+    ini_summary_t *nullable_summary/* = NULL if failure reason not cared*/)
+{
+    mapping_cursor_t cursor = { NULL, NULL, NULL };
+    char *last_line = NULL;
+    struct stat file_stat;
+    char *addr = (char *)MAP_FAILED;
+    size_t map_len = 0;
+    ini_doc_t *doc = NULL;
+    int fd = open(path, O_RDONLY);
 
-            RETURN_IF_TRUE(is_orphan || NULL == equal_sign || equal_sign == head,
-                is_orphan ? -INI_ERR_ORPHAN_ITEM : ((NULL == equal_sign) ? -INI_ERR_BAD_FORMAT : -INI_ERR_NULL_KEY),
-                free(_this);free(buf));
+    if (fd >= 0 && 0 == fstat(fd, &file_stat))
+    {
+        map_len = (file_stat.st_size > 0) ? (size_t)file_stat.st_size : 1;
+        /* NOTE: A private writable mapping, so that tokens can be terminated in place without touching the file. */
+        addr = (char *)mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
 
-            _this->type = INI_NODE_ITEM;
+    if (fd >= 0)
+        close(fd);
 
-            _this->detail = calloc(1, sizeof(ini_item_t));
-            RETURN_IF_TRUE(NULL == _this->detail, -INI_ERR_MEM_ALLOC, free(_this);free(buf));
+    if (MAP_FAILED == addr)
+    {
+        if (NULL != nullable_summary)
+        {
+            memset(nullable_summary, 0, sizeof(ini_summary_t));
+            nullable_summary->error_code = -INI_ERR_IO;
+        }
 
-            if (strip_blanks && NULL != val_head)
-                while (IS_BLANK(*val_head)) ++val_head;
-            length = (tail >= val_head ) ? (tail - val_head + 1) : 0;
-            val = (char *)calloc(length + 1, sizeof(char));
-            RETURN_IF_TRUE(NULL == val, -INI_ERR_MEM_ALLOC, free(_this->detail);free(_this);free(buf));
-            strncpy(val, val_head, length);
-            ((ini_item_t *)_this->detail)->val = val;
+        return NULL;
+    }
 
-            tail = equal_sign - 1;
-            while (IS_BLANK(*tail)) --tail;
-            length = tail - head + 1;
-            key = (char *)calloc(length + 1, sizeof(char));
-            RETURN_IF_TRUE(NULL == key, -INI_ERR_MEM_ALLOC, free(val);free(_this->detail);free(_this);free(buf));
-            strncpy(key, head, length);
-            ((ini_item_t *)_this->detail)->key = key;
+    cursor.pos = addr;
+    cursor.end = addr + file_stat.st_size;
+    while (cursor.end > addr && '\n' != cursor.end[-1])
+        --cursor.end;
 
-            if (NULL == ((ini_section_t *)section->detail)->sub)
-                ((ini_section_t *)section->detail)->sub = _this;
-        }
+    if (cursor.end < addr + file_stat.st_size)
+    {
+        size_t last_len = addr + file_stat.st_size - cursor.end;
 
-        if (_this != section)
+        if (NULL == (cursor.last_line = (char *)malloc(last_len + 1)))
         {
-            if (NULL != prev)
-                prev->next = _this;
+            munmap(addr, map_len);
+            if (NULL != nullable_summary)
+            {
+                memset(nullable_summary, 0, sizeof(ini_summary_t));
+                nullable_summary->error_code = -INI_ERR_MEM_ALLOC;
+            }
 
-            prev = _this;
+            return NULL;
         }
+        memcpy(cursor.last_line, cursor.end, last_len);
+        cursor.last_line[last_len] = '\0';
+    }
 
-        summary.success_lines += 1;
-    } /* while (NULL != fgets() */
+    last_line = cursor.last_line;
 
-    free(buf);
+    doc = (options & INI_PARSE_PARALLEL)
+        ? __parse_in_parallel(cursor.pos, cursor.end, &cursor, options | INI_PARSE_ARENA, nullable_summary)
+        : __parse_from(&cursor, 0, __get_from_mapping, options | INI_PARSE_ARENA, nullable_summary);
+    if (NULL == doc)
+    {
+        munmap(addr, map_len);
+        free(last_line);
 
-    if (NULL != nullable_summary)
-        memcpy(nullable_summary, &summary, sizeof(ini_summary_t));
+        return NULL;
+    }
 
-    return doc;
-}
+    doc->mapping = addr;
+    doc->mapping_len = map_len;
+    doc->last_line = last_line;
 
-ini_doc_t* ini_parse_from_stream(FILE *stream, int strip_blanks/* = 0 or 1, for item value only */,
-    ini_summary_t *nullable_summary/* = NULL if failure reason not cared*/)
-{
-    return __parse_from(stream, 0, __get_from_stream, strip_blanks, nullable_summary);
+    return doc;
 }
 
-ini_doc_t* ini_parse_from_buffer(char *buf, size_t buf_len, int strip_blanks/* = 0 or 1, for item value only */,
-    ini_summary_t *nullable_summary/* = NULL if failure reason not cared*/)
-{
-    return __parse_from(buf, buf_len, __get_from_string, strip_blanks, nullable_summary);
-}
+#endif /* #if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS) */
 
 /*
  * ================
@@ -426,18 +1370,7 @@ static ini_summary_t __traverse_nodes_of(ini_node_t *sec, int should_free_memory
         }
 
         if (should_free_memory)
-        {
-            if (INI_NODE_ITEM == node_type)
-            {
-                free(((ini_item_t *)node_ptr->detail)->key);
-                free(((ini_item_t *)node_ptr->detail)->val);
-            }
-
-            if (INI_NODE_BLANK_LINE != node_type)
-                free(node_ptr->detail);
-
-            free(node_ptr);
-        }
+            __free_node(node_ptr);
     } /* while (NULL != node) */
 
     return summary;
@@ -504,15 +1437,7 @@ static ini_summary_t __traverse_all_nodes(ini_doc_t *doc, int should_free_memory
             }
 
             if (should_free_memory)
-            {
-                if (INI_NODE_SECTION == node_type)
-                    free(((ini_section_t *)node_ptr->detail)->name);
-
-                if (INI_NODE_BLANK_LINE != node_type)
-                    free(node_ptr->detail);
-
-                free(node_ptr);
-            }
+                __free_node(node_ptr);
         } /* while (NULL != node) */
     }
 
@@ -575,148 +1500,356 @@ typedef struct str_buf_t
     char **pptr;
     size_t total;
     size_t used;
-    int allow_resizing;
 } str_buf_t;
 
+static size_t __dump_len_of(const ini_node_t *node)
+{
+    switch (node->type)
+    {
+    case INI_NODE_COMMENT:
+        return strlen((char *)node->detail) + s_newline_len;
+
+    case INI_NODE_SECTION:
+        return 1 + ((ini_section_t *)node->detail)->name_len + 1 + s_newline_len;
+
+    case INI_NODE_ITEM:
+        return s_indent_width + ((ini_item_t *)node->detail)->key_len + 1
+            + ((ini_item_t *)node->detail)->val_len + s_newline_len;
+
+    default:
+        return s_newline_len;
+    }
+}
+
+static int __measure_node(const char *sec_name, ini_node_t *cur_node, void *total_len)
+{
+    *((size_t *)total_len) += __dump_len_of(cur_node);
+
+    return 0;
+}
+
 static int __dump_node_to_buffer(const char *sec_name, ini_node_t *cur_node, void *str_buf)
 {
     str_buf_t *buf = (str_buf_t *)str_buf;
     void *detail = cur_node->detail;
     char *pos = *(buf->pptr) + buf->used;
-    char node_type = cur_node->type;
-    size_t newline_len = strlen(s_newline); /* TODO: Add a static variable outside to store this length value. */
-    size_t indent_width = strlen(s_indent_spaces); /* TODO: Same as above. */
-    size_t name_len = (INI_NODE_SECTION == node_type) ? strlen(((ini_section_t *)detail)->name) : 0; /* TODO: detail->name_len */
-    size_t key_len = (INI_NODE_ITEM == node_type) ? strlen(((ini_item_t *)detail)->key) : 0; /* TODO: detail->key_len */
-    size_t val_len = (INI_NODE_ITEM == node_type) ? strlen(((ini_item_t *)detail)->val) : 0; /* TODO: detail->val_len */
-    size_t comment_len = (INI_NODE_COMMENT == node_type) ? strlen((char *)detail) : 0;
-    size_t expected_len = (INI_NODE_ITEM == node_type)
-        ? (indent_width + key_len + 1 + val_len + newline_len)
-        : ((INI_NODE_SECTION == node_type)
-            ? (name_len + 2 + newline_len)
-            : ((INI_NODE_COMMENT == node_type) ? (comment_len + newline_len) : newline_len));
-    int buf_not_enough = (buf->used + expected_len > buf->total);
-
-    if (NULL == *(buf->pptr) || buf_not_enough)
-    {
-        char *tmp = (buf_not_enough && !buf->allow_resizing) ? NULL : (char *)realloc(*buf->pptr, buf->total * 2);
-
-        if (NULL == tmp)
-            return -INI_ERR_MEM_ALLOC;
-
-        *(buf->pptr) = tmp;
-        buf->total *= 2;
-        pos = *(buf->pptr) + buf->used;
-    }
+    size_t expected_len = __dump_len_of(cur_node);
 
-    switch (node_type)
+    switch (cur_node->type)
     {
     case INI_NODE_BLANK_LINE:
-        memcpy(pos, s_newline, newline_len);
         break;
 
     case INI_NODE_COMMENT:
-        memcpy(pos, detail, comment_len);
-        pos += comment_len;
-        memcpy(pos, s_newline, newline_len);
+        memcpy(pos, detail, expected_len - s_newline_len);
+        pos += expected_len - s_newline_len;
         break;
 
     case INI_NODE_SECTION:
         *pos = '[';
         ++pos;
-        memcpy(pos, ((ini_section_t *)detail)->name, name_len);
-        pos += name_len;
+        memcpy(pos, ((ini_section_t *)detail)->name, ((ini_section_t *)detail)->name_len);
+        pos += ((ini_section_t *)detail)->name_len;
         *pos = ']';
         ++pos;
-        memcpy(pos, s_newline, newline_len);
         break;
 
     case INI_NODE_ITEM:
-        memcpy(pos, s_indent_spaces, indent_width);
-        pos += indent_width;
-        memcpy(pos, ((ini_item_t *)detail)->key, key_len);
-        pos += key_len;
+        if (s_indent_width > 0) /* NOTE: s_indent_spaces is NULL if the width has never been set. */
+            memcpy(pos, s_indent_spaces, s_indent_width);
+        pos += s_indent_width;
+        memcpy(pos, ((ini_item_t *)detail)->key, ((ini_item_t *)detail)->key_len);
+        pos += ((ini_item_t *)detail)->key_len;
         *pos = '=';
         ++pos;
-        memcpy(pos, ((ini_item_t *)detail)->val, val_len);
-        pos += val_len;
-        memcpy(pos, s_newline, newline_len);
+        memcpy(pos, ((ini_item_t *)detail)->val, ((ini_item_t *)detail)->val_len);
+        pos += ((ini_item_t *)detail)->val_len;
         break;
 
     default:
         return -INI_ERR_UNKNOWN_NODE_TYPE;
     }
 
+    memcpy(pos, s_newline, s_newline_len);
     buf->used += expected_len;
 
     return expected_len;
 }
 
-ini_summary_t ini_dump_to_buffer(const ini_doc_t *doc, char **buf, size_t *buf_len, int allow_resizing)
+ini_summary_t ini_dump_to_buffer(const ini_doc_t *doc, char **buf, size_t *buf_len, int allow_resizing)
+{
+    str_buf_t arg = { 0 };
+    size_t total_len = 0;
+    ini_summary_t summary = __traverse_all_nodes((ini_doc_t *)doc, 0, __measure_node, &total_len);
+
+    if (summary.error_code < 0)
+        return summary;
+
+    arg.pptr = buf;
+    arg.total = (NULL == *buf) ? 0 : *buf_len;
+
+    if (total_len > arg.total)
+    {
+        /* NOTE: One more byte for the null terminator, which is not required of a buffer given by the caller. */
+        char *tmp = allow_resizing ? (char *)realloc(*buf, total_len + 1) : NULL;
+
+        if (NULL == tmp)
+        {
+            memset(&summary, 0, sizeof(ini_summary_t));
+            summary.error_code = -INI_ERR_MEM_ALLOC;
+
+            return summary;
+        }
+
+        *buf = tmp;
+        arg.total = total_len + 1;
+    }
+
+    summary = __traverse_all_nodes((ini_doc_t *)doc, 0, __dump_node_to_buffer, &arg);
+    if (arg.used < arg.total)
+        (*buf)[arg.used] = '\0';
+    if (summary.error_code >= 0)
+        *buf_len = arg.total;
+
+    return summary;
+}
+
+static int __do_nothing_but_trigger_summary(const char *sec_name, ini_node_t *cur_node, void *none)
+{
+    return 0;
+}
+
+void ini_destroy(ini_doc_t *doc)
+{
+    if (NULL != doc)
+    {
+        __traverse_all_nodes(doc, 1, __do_nothing_but_trigger_summary, NULL);
+        doc->changes.trackers = 0; /* Released regardless of trackers left. */
+        ini_changes_track(doc, false);
+        __index_destroy(doc->sec_index);
+        __arena_destroy(doc->arena);
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+        if (NULL != doc->mapping)
+            munmap(doc->mapping, doc->mapping_len);
+#endif
+        free(doc->last_line);
+        doc->preamble = NULL;
+        doc->section = NULL;
+        doc->sec_index = NULL;
+        doc->arena = NULL;
+        doc->mapping = NULL;
+        doc->last_line = NULL;
+        free(doc);
+    }
+}
+
+ini_summary_t ini_traverse_all_nodes(ini_doc_t *doc, ini_traverval_callback_t cb, void *cb_arg)
+{
+    return __traverse_all_nodes(doc, 0, cb, cb_arg);
+}
+
+ini_summary_t ini_traverse_all_sections(ini_doc_t *doc, ini_traverval_callback_t cb, void *cb_arg)
+{
+    ini_summary_t summary = { 0 };
+    ini_node_t *node = doc->section;
+
+    if (NULL == cb)
+        return summary;
+
+    for (; NULL != node; node = node->next)
+    {
+        int err = cb(((ini_section_t *)node->detail)->name, node, cb_arg);
+
+        if (err < 0)
+        {
+            summary.error_code = err;
+
+            return summary;
+        }
+
+        summary.success_lines += 1;
+        summary.section_lines += 1;
+    }
+
+    return summary;
+}
+
+ini_summary_t ini_traverse_nodes_of(ini_node_t *sec, ini_traverval_callback_t cb, void *cb_arg)
+{
+    return __traverse_nodes_of(sec, 0, cb, cb_arg);
+}
+
+/*
+ * ================
+ *  CHANGE TRACKING
+ * ================
+ */
+
+static void __changes_free_retired(ini_change_log_t *log)
+{
+    size_t i = 0;
+
+    for (; i < log->retired_count; ++i)
+    {
+        free(log->retired_strs[i]);
+    }
+    log->retired_count = 0;
+
+    while (NULL != log->retired_nodes)
+    {
+        ini_node_t *node = log->retired_nodes;
+
+        log->retired_nodes = node->next;
+        if (INI_NODE_SECTION == node->type)
+            __traverse_nodes_of(node, 1, NULL, NULL);
+        __free_node(node);
+    }
+}
+
+/* Drops all records, which forces every consumer to re-sync fully, but before which retired strings are still used. */
+static void __changes_drop(ini_change_log_t *log)
+{
+    log->base_seq += log->count + 1;
+    log->count = 0;
+}
+
+static void __changes_record(ini_doc_t *nullable_doc, const char *sec_name, const char *nullable_key)
+{
+    ini_change_log_t *log = (NULL == nullable_doc) ? NULL : &nullable_doc->changes;
+
+    if (NULL == log || 0 == log->trackers)
+        return;
+
+    if (log->count == log->capacity)
+    {
+        size_t new_capacity = (0 == log->capacity) ? 16 : (log->capacity * 2);
+        ini_change_t *tmp = (ini_change_t *)realloc(log->entries, sizeof(ini_change_t) * new_capacity);
+
+        if (NULL == tmp)
+        {
+            __changes_drop(log);
+
+            return;
+        }
+
+        log->entries = tmp;
+        log->capacity = new_capacity;
+    }
+
+    log->entries[log->count].sec_name = sec_name;
+    log->entries[log->count].key = nullable_key;
+    log->count += 1;
+}
+
+/* Same as __release(), except that the string is kept until the change records are cleared. */
+static void __discard(ini_doc_t *nullable_doc, ini_node_t *node, unsigned char part, char *str)
+{
+    ini_change_log_t *log = (NULL == nullable_doc) ? NULL : &nullable_doc->changes;
+
+    if ((node->arena_mask & part) || NULL == log || 0 == log->trackers)
+    {
+        __release(node, part, str);
+
+        return;
+    }
+
+    if (log->retired_count == log->retired_capacity)
+    {
+        size_t new_capacity = (0 == log->retired_capacity) ? 16 : (log->retired_capacity * 2);
+        char **tmp = (char **)realloc(log->retired_strs, sizeof(char *) * new_capacity);
+
+        if (NULL != tmp)
+        {
+            log->retired_strs = tmp;
+            log->retired_capacity = new_capacity;
+        }
+    }
+
+    if (log->retired_count < log->retired_capacity)
+        log->retired_strs[log->retired_count++] = str;
+    else
+    {
+        __changes_drop(log);
+        free(str);
+    }
+}
+
+static void __discard_node(ini_doc_t *doc, ini_node_t *node)
 {
-    str_buf_t arg = { 0 };
-    ini_summary_t summary;
-
-    arg.pptr = buf;
-    arg.total = (NULL == *buf || 0 == *buf_len) ? 64 : *buf_len;
-    arg.allow_resizing = allow_resizing;
+    if (doc->changes.trackers > 0)
+    {
+        node->next = doc->changes.retired_nodes;
+        doc->changes.retired_nodes = node;
 
-    summary = __traverse_all_nodes((ini_doc_t *)doc, 0, __dump_node_to_buffer, &arg);
-    if (summary.error_code >= 0)
-        *buf_len = arg.total;
+        return;
+    }
 
-    return summary;
+    if (INI_NODE_SECTION == node->type)
+        __traverse_nodes_of(node, 1, NULL, NULL);
+    __free_node(node);
 }
 
-static int __do_nothing_but_trigger_summary(const char *sec_name, ini_node_t *cur_node, void *none)
+static ini_doc_t* __doc_of_item(const ini_node_t *item)
 {
-    return 0;
+    const ini_node_t *sec = ((ini_item_t *)item->detail)->sec;
+
+    return (NULL == sec) ? NULL : ((ini_section_t *)sec->detail)->doc;
 }
 
-void ini_destroy(ini_doc_t *doc)
+static void __changes_release(ini_change_log_t *log)
 {
-    if (NULL != doc && __traverse_all_nodes(doc, 1, __do_nothing_but_trigger_summary, NULL).success_lines > 0)
-    {
-        doc->preamble = NULL;
-        doc->section = NULL;
-        free(doc);
-    }
+    log->base_seq += log->count;
+    log->count = 0;
+    __changes_free_retired(log);
+    free(log->entries);
+    free(log->retired_strs);
+    log->entries = NULL;
+    log->retired_strs = NULL;
+    log->capacity = 0;
+    log->retired_capacity = 0;
+    log->trackers = 0;
 }
 
-ini_summary_t ini_traverse_all_nodes(ini_doc_t *doc, ini_traverval_callback_t cb, void *cb_arg)
+int ini_changes_track(ini_doc_t *doc, bool enabled)
 {
-    return __traverse_all_nodes(doc, 0, cb, cb_arg);
+    ini_change_log_t *log = &doc->changes;
+
+    if (enabled)
+        log->trackers += 1;
+    else if (log->trackers > 1)
+        log->trackers -= 1;
+    else
+        __changes_release(log);
+
+    return 0;
 }
 
-ini_summary_t ini_traverse_all_sections(ini_doc_t *doc, ini_traverval_callback_t cb, void *cb_arg)
+unsigned long ini_changes_seq(const ini_doc_t *doc)
 {
-    ini_summary_t summary = { 0 };
-    ini_node_t *node = doc->section;
-
-    if (NULL == cb)
-        return summary;
+    return doc->changes.base_seq + doc->changes.count;
+}
 
-    for (; NULL != node; node = node->next)
-    {
-        int err = cb(((ini_section_t *)node->detail)->name, node, cb_arg);
+const ini_change_t* ini_changes_since(const ini_doc_t *doc, unsigned long since_seq, size_t *count)
+{
+    static const ini_change_t S_NO_CHANGE = { NULL, NULL };
+    const ini_change_log_t *log = &doc->changes;
 
-        if (err < 0)
-        {
-            summary.error_code = err;
+    *count = 0;
 
-            return summary;
-        }
+    if (0 == log->trackers || since_seq < log->base_seq || since_seq > log->base_seq + log->count)
+        return NULL;
 
-        summary.success_lines += 1;
-        summary.section_lines += 1;
-    }
+    *count = log->base_seq + log->count - since_seq;
 
-    return summary;
+    return (0 == *count) ? &S_NO_CHANGE : (log->entries + (since_seq - log->base_seq));
 }
 
-ini_summary_t ini_traverse_nodes_of(ini_node_t *sec, ini_traverval_callback_t cb, void *cb_arg)
+void ini_changes_clear(ini_doc_t *doc)
 {
-    return __traverse_nodes_of(sec, 0, cb, cb_arg);
+    doc->changes.base_seq += doc->changes.count;
+    doc->changes.count = 0;
+    if (doc->changes.trackers <= 1) /* Other trackers may still refer to retired strings until they re-sync. */
+        __changes_free_retired(&doc->changes);
 }
 
 /*
@@ -725,40 +1858,29 @@ ini_summary_t ini_traverse_nodes_of(ini_node_t *sec, ini_traverval_callback_t cb
  * ================
  */
 
-ini_node_t* ini_section_find(const ini_doc_t *doc, const char *name, size_t name_len/* = 0 if auto calculated later */)
+static ini_node_t* __section_find(const ini_doc_t *doc, const char *name, size_t name_len,
+    bool *nullable_is_repeated)
 {
-    ini_node_t *node = doc->section;
+    if (0 == name_len)
+        name_len = strlen(name);
 
-    for (; NULL != node; node = node->next)
-    {
-        if (INI_NODE_SECTION == node->type && /* TODO: Use name_len */
-            0 == strncmp(((ini_section_t *)node->detail)->name, name, INI_LINE_SIZE_MAX - 2))
-        {
-            return node;
-        }
-    }
+    return (NULL == doc->sec_index)
+        ? __linear_find(doc->section, INI_NODE_SECTION, name, name_len, nullable_is_repeated)
+        : __index_find(doc->sec_index, name, name_len, nullable_is_repeated);
+}
 
-    return NULL;
+ini_node_t* ini_section_find(const ini_doc_t *doc, const char *name, size_t name_len/* = 0 if auto calculated later */)
+{
+    return __section_find(doc, name, name_len, NULL);
 }
 
 bool ini_section_is_repeated(const ini_doc_t *doc, const char *name, size_t name_len/* = 0 if auto calculated later */)
 {
-    ini_node_t *first = NULL;
-    ini_node_t *node = doc->section;
+    bool is_repeated = false;
 
-    for (; NULL != node; node = node->next)
-    {
-        if (INI_NODE_SECTION == node->type && /* TODO: Use name_len */
-            0 == strncmp(((ini_section_t *)node->detail)->name, name, INI_LINE_SIZE_MAX - 2))
-        {
-            if (NULL != first)
-                return true;
-
-            first = node;
-        }
-    }
+    __section_find(doc, name, name_len, &is_repeated);
 
-    return false;
+    return is_repeated;
 }
 
 const char* ini_section_get_name(const ini_node_t *sec)
@@ -800,23 +1922,77 @@ int ini_section_rename(const char *name, size_t name_len, ini_node_t *sec)
     if (NULL == (new_name = (char *)malloc(name_len + 1)))
         return -INI_ERR_MEM_ALLOC;
 
-    strncpy(new_name, name, name_len);
+    strncpy(new_name, head, name_len);
     new_name[name_len] = '\0';
 
-    free(detail->name);
+    __changes_record(detail->doc, detail->name, NULL);
+    __changes_record(detail->doc, new_name, NULL);
+    __discard(detail->doc, sec, INI_IN_ARENA_NAME, detail->name);
     detail->name = new_name;
+    detail->name_len = name_len;
+    __index_update(sec);
 
     return name_len;
 }
 
 int ini_section_add(const char *name, size_t name_len, ini_doc_t *doc)
 {
-    return -INI_ERR_NOT_IMPLEMENTED; /* TODO */
+    ini_node_t *sec = (ini_node_t *)calloc(1, sizeof(ini_node_t));
+    ini_section_t *detail = (NULL == sec) ? NULL : (ini_section_t *)calloc(1, sizeof(ini_section_t));
+    ini_node_t **tail = &doc->section;
+    int ret = 0;
+
+    if (NULL == detail)
+    {
+        free(sec);
+
+        return -INI_ERR_MEM_ALLOC;
+    }
+
+    sec->type = INI_NODE_SECTION;
+    sec->detail = detail;
+
+    if ((ret = ini_section_rename(name, name_len, sec)) <= 0)
+        ret = (0 == ret) ? -INI_ERR_NULL_SECTION_NAME : ret;
+    else if (NULL != ini_section_find(doc, detail->name, ret))
+        ret = -INI_ERR_REPEATED_SECTION;
+    else if (NULL != doc->sec_index
+        && (NULL == (detail->item_index = __index_create()) || __index_insert(doc->sec_index, sec) < 0))
+        ret = -INI_ERR_MEM_ALLOC;
+
+    if (ret < 0)
+    {
+        __free_node(sec);
+
+        return ret;
+    }
+
+    while (NULL != *tail)
+        tail = &(*tail)->next;
+    *tail = sec;
+    detail->doc = doc;
+    __changes_record(doc, detail->name, NULL);
+
+    return ret;
 }
 
 int ini_section_remove(const char *name, size_t name_len/* = 0 if auto calculated later */, ini_doc_t *doc)
 {
-    return -INI_ERR_NOT_IMPLEMENTED; /* TODO */
+    ini_node_t *sec = ini_section_find(doc, name, name_len);
+    ini_node_t **pos = &doc->section;
+
+    if (NULL == sec)
+        return -INI_ERR_SECTION_NOT_FOUND;
+
+    while (sec != *pos)
+        pos = &(*pos)->next;
+    *pos = sec->next;
+
+    __index_remove(sec);
+    __changes_record(doc, ((ini_section_t *)sec->detail)->name, NULL);
+    __discard_node(doc, sec);
+
+    return 0;
 }
 
 /*
@@ -825,40 +2001,38 @@ int ini_section_remove(const char *name, size_t name_len/* = 0 if auto calculate
  * ================
  */
 
-ini_node_t* ini_item_find(const ini_node_t *sec, const char *key, size_t key_len/* = 0 if auto calculated later */)
+static ini_node_t* __item_find(const ini_node_t *sec, const char *key, size_t key_len, bool *nullable_is_repeated)
 {
-    ini_node_t *node = (INI_NODE_SECTION == sec->type) ? (((ini_section_t *)sec->detail)->sub) : NULL;
+    const ini_section_t *detail = (INI_NODE_SECTION == sec->type) ? ((ini_section_t *)sec->detail) : NULL;
 
-    for (; NULL != node; node = node->next)
+    if (NULL == detail)
     {
-        if (INI_NODE_ITEM == node->type && /* TODO: Use key_len */
-            0 == strncmp(((ini_item_t *)node->detail)->key, key, INI_KEY_SIZE_MAX))
-        {
-            return node;
-        }
+        if (NULL != nullable_is_repeated)
+            *nullable_is_repeated = false;
+
+        return NULL;
     }
 
-    return NULL;
+    if (0 == key_len)
+        key_len = strlen(key);
+
+    return (NULL == detail->item_index)
+        ? __linear_find(detail->sub, INI_NODE_ITEM, key, key_len, nullable_is_repeated)
+        : __index_find(detail->item_index, key, key_len, nullable_is_repeated);
 }
 
-bool ini_item_is_repeated(const ini_node_t *sec, const char *key, size_t key_len/* = 0 if auto calculated later */)
+ini_node_t* ini_item_find(const ini_node_t *sec, const char *key, size_t key_len/* = 0 if auto calculated later */)
 {
-    ini_node_t *first = NULL;
-    ini_node_t *node = (INI_NODE_SECTION == sec->type) ? (((ini_section_t *)sec->detail)->sub) : NULL;
+    return __item_find(sec, key, key_len, NULL);
+}
 
-    for (; NULL != node; node = node->next)
-    {
-        if (INI_NODE_ITEM == node->type && /* TODO: Use key_len */
-            0 == strncmp(((ini_item_t *)node->detail)->key, key, INI_KEY_SIZE_MAX))
-        {
-            if (NULL != first)
-                return true;
+bool ini_item_is_repeated(const ini_node_t *sec, const char *key, size_t key_len/* = 0 if auto calculated later */)
+{
+    bool is_repeated = false;
 
-            first = node;
-        }
-    }
+    __item_find(sec, key, key_len, &is_repeated);
 
-    return false;
+    return is_repeated;
 }
 
 const char* ini_item_get_key(const ini_node_t *item)
@@ -906,8 +2080,15 @@ int ini_item_set_key(const char *key, size_t key_len, ini_node_t *item)
     strncpy(new_key, head, key_len);
     new_key[key_len] = '\0';
 
-    free(detail->key);
+    if (NULL != detail->sec)
+    {
+        __changes_record(__doc_of_item(item), ini_section_get_name(detail->sec), detail->key);
+        __changes_record(__doc_of_item(item), ini_section_get_name(detail->sec), new_key);
+    }
+    __discard(__doc_of_item(item), item, INI_IN_ARENA_NAME, detail->key);
     detail->key = new_key;
+    detail->key_len = key_len;
+    __index_update(item);
 
     return key_len;
 }
@@ -947,20 +2128,105 @@ int ini_item_set_value(const char *val, size_t val_len, ini_node_t *item)
     strncpy(new_value, head, val_len);
     new_value[val_len] = '\0';
 
-    free(detail->val);
+    if (NULL != detail->sec)
+        __changes_record(__doc_of_item(item), ini_section_get_name(detail->sec), detail->key);
+    __discard(__doc_of_item(item), item, INI_IN_ARENA_VALUE, detail->val);
     detail->val = new_value;
+    detail->val_len = val_len;
 
     return val_len;
 }
 
 int ini_item_add(const char *key, size_t key_len, const char *val, size_t val_len, ini_node_t *sec)
 {
-    return -INI_ERR_NOT_IMPLEMENTED; /* TODO */
+    ini_section_t *sec_detail = (INI_NODE_SECTION == sec->type) ? ((ini_section_t *)sec->detail) : NULL;
+    ini_node_t *item = (NULL == sec_detail) ? NULL : (ini_node_t *)calloc(1, sizeof(ini_node_t));
+    ini_item_t *detail = (NULL == item) ? NULL : (ini_item_t *)calloc(1, sizeof(ini_item_t));
+    ini_node_t *last = NULL;
+    ini_node_t *node = NULL;
+    int ret = 0;
+    int err = 0;
+
+    if (NULL == sec_detail)
+        return -INI_ERR_NOT_SECTION_NODE;
+
+    if (NULL == detail)
+    {
+        free(item);
+
+        return -INI_ERR_MEM_ALLOC;
+    }
+
+    item->type = INI_NODE_ITEM;
+    item->detail = detail;
+
+    if ((ret = ini_item_set_key(key, key_len, item)) <= 0)
+        err = (0 == ret) ? -INI_ERR_NULL_KEY : ret;
+    else if (NULL != ini_item_find(sec, detail->key, ret))
+        err = -INI_ERR_REPEATED_ITEM;
+    else if ((err = ini_item_set_value(val, val_len, item)) >= 0 && NULL == detail->val)
+        err = (NULL == (detail->val = (char *)calloc(1, sizeof(char)))) ? -INI_ERR_MEM_ALLOC : 0;
+
+    if (err >= 0 && NULL != sec_detail->item_index && __index_insert(sec_detail->item_index, item) < 0)
+        err = -INI_ERR_MEM_ALLOC;
+
+    if (err < 0)
+    {
+        __free_node(item);
+
+        return err;
+    }
+
+    /* NOTE: Goes after the last non-blank line of the section, so that trailing blank lines stay at the end. */
+    for (node = sec_detail->sub; NULL != node; node = node->next)
+    {
+        if (INI_NODE_BLANK_LINE != node->type)
+            last = node;
+    }
+
+    if (NULL == last)
+    {
+        item->next = sec_detail->sub;
+        sec_detail->sub = item;
+    }
+    else
+    {
+        item->next = last->next;
+        last->next = item;
+    }
+    detail->sec = sec;
+    __changes_record(sec_detail->doc, sec_detail->name, detail->key);
+
+    return ret;
 }
 
 int ini_item_remove(const char *key, size_t key_len/* = 0 if auto calculated later */, ini_node_t *sec)
 {
-    return -INI_ERR_NOT_IMPLEMENTED; /* TODO */
+    ini_node_t *item = NULL;
+    ini_node_t **pos = NULL;
+
+    if (INI_NODE_SECTION != sec->type)
+        return -INI_ERR_NOT_SECTION_NODE;
+
+    if (NULL == (item = ini_item_find(sec, key, key_len)))
+        return -INI_ERR_ITEM_NOT_FOUND;
+
+    pos = &((ini_section_t *)sec->detail)->sub;
+    while (item != *pos)
+        pos = &(*pos)->next;
+    *pos = item->next;
+
+    __index_remove(item);
+    if (NULL == ((ini_section_t *)sec->detail)->doc)
+        __free_node(item);
+    else
+    {
+        __changes_record(((ini_section_t *)sec->detail)->doc, ((ini_section_t *)sec->detail)->name,
+            ((ini_item_t *)item->detail)->key);
+        __discard_node(((ini_section_t *)sec->detail)->doc, item);
+    }
+
+    return 0;
 }
 
 /*
@@ -1014,8 +2280,7 @@ int ini_comment_set(const char *comment, size_t comment_len, ini_node_t *node)
     strncpy(new_comment, head, comment_len);
     new_comment[comment_len] = '\0';
 
-    if (NULL != node->detail)
-        free(node->detail);
+    __release(node, INI_IN_ARENA_DETAIL, node->detail);
     node->detail = new_comment;
     if (INI_NODE_BLANK_LINE == node->type)
         node->type = INI_NODE_COMMENT;
@@ -1028,6 +2293,8 @@ int ini_comment_set(const char *comment, size_t comment_len, ini_node_t *node)
 #include <ctype.h>
 #include <errno.h>
 
+#include "sleeps.h"
+
 static void print_summary(const ini_summary_t *summary, const char *title, FILE *stream)
 {
     fprintf(stream, "%s: successes: %d, sections: %d, items: %d, comment lines: %d, blank lines: %d\n",
@@ -1039,7 +2306,6 @@ static void print_summary(const ini_summary_t *summary, const char *title, FILE
 static int test_getters_and_setters(const char *sec_name, ini_node_t *cur_node, void *doc)
 {
     const char* const STR_TO_APPEND = "\t TEST \t";
-    const size_t APPEND_LEN = strlen(STR_TO_APPEND);
     char buf[INI_LINE_SIZE_MAX + 1] = { 0 };
     ini_node_t *sec = NULL;
     const char *key = NULL;
@@ -1051,7 +2317,7 @@ static int test_getters_and_setters(const char *sec_name, ini_node_t *cur_node,
 
     case INI_NODE_COMMENT:
         strcpy(buf, ini_comment_get(cur_node));
-        strncat(buf, STR_TO_APPEND, APPEND_LEN);
+        strncat(buf, STR_TO_APPEND, sizeof(buf) - strlen(buf) - 1);
 
         return ini_comment_set(buf, strlen(buf), cur_node);
 
@@ -1063,7 +2329,7 @@ static int test_getters_and_setters(const char *sec_name, ini_node_t *cur_node,
             return -INI_ERR_REPEATED_SECTION;
 
         strcpy(buf, sec_name);
-        strncat(buf, STR_TO_APPEND, APPEND_LEN);
+        strncat(buf, STR_TO_APPEND, sizeof(buf) - strlen(buf) - 1);
 
         return ini_section_rename(buf, strlen(buf), cur_node);
 
@@ -1075,12 +2341,12 @@ static int test_getters_and_setters(const char *sec_name, ini_node_t *cur_node,
             return -INI_ERR_REPEATED_ITEM;
 
         strcpy(buf, ini_item_get_value(cur_node));
-        strncat(buf, STR_TO_APPEND, APPEND_LEN);
+        strncat(buf, STR_TO_APPEND, sizeof(buf) - strlen(buf) - 1);
 
         ini_item_set_value(buf, strlen(buf), cur_node);
 
         strcpy(buf, key);
-        strncat(buf, STR_TO_APPEND, APPEND_LEN);
+        strncat(buf, STR_TO_APPEND, sizeof(buf) - strlen(buf) - 1);
 
         return ini_item_set_key(buf, strlen(buf), cur_node);
 
@@ -1091,6 +2357,218 @@ static int test_getters_and_setters(const char *sec_name, ini_node_t *cur_node,
     return 0;
 }
 
+static int test_adders_and_removers(ini_doc_t *doc)
+{
+    const char* const SEC_NAME = "__ADDED_SECTION__";
+    char key[32];
+    ini_node_t *sec = NULL;
+    int i = 0;
+    int err = 0;
+
+    if ((err = ini_section_add(SEC_NAME, strlen(SEC_NAME), doc)) < 0)
+        return err;
+
+    if (ini_section_add(SEC_NAME, strlen(SEC_NAME), doc) != -INI_ERR_REPEATED_SECTION)
+        return -INI_ERR_REPEATED_SECTION;
+
+    if (NULL == (sec = ini_section_find(doc, "__ADDED_SECTION__ with a suffix", strlen(SEC_NAME))))
+        return -INI_ERR_SECTION_NOT_FOUND;
+
+    for (i = 0; i < 100; ++i) /* Enough to grow the index. */
+    {
+        sprintf(key, " key%d ", i);
+        if ((err = ini_item_add(key, strlen(key), "value", strlen("value"), sec)) < 0)
+            return err;
+    }
+
+    if (ini_item_add("key7", 4, "", 0, sec) != -INI_ERR_REPEATED_ITEM)
+        return -INI_ERR_REPEATED_ITEM;
+
+    if (NULL == ini_item_find(sec, "key99", 0) || 0 != strcmp(ini_item_get_value(ini_item_find(sec, "key0", 0)), "value"))
+        return -INI_ERR_ITEM_NOT_FOUND;
+
+    if ((err = ini_item_set_key("key7", 4, ini_item_find(sec, "key8", 0))) < 0)
+        return err;
+
+    if (!ini_item_is_repeated(sec, "key7", 0) || NULL != ini_item_find(sec, "key8", 0))
+        return -INI_ERR_ITEM_MISMATCHED;
+
+    for (i = 0; i < 100; ++i)
+    {
+        sprintf(key, "key%d", i);
+        if (8 != i && (err = ini_item_remove(key, 0, sec)) < 0)
+            return err;
+    }
+
+    if (NULL == ini_item_find(sec, "key7", 0) || ini_item_remove("key7", 0, sec) < 0 || NULL != ini_item_find(sec, "key7", 0))
+        return -INI_ERR_ITEM_MISMATCHED;
+
+    if ((err = ini_section_remove(SEC_NAME, 0, doc)) < 0)
+        return err;
+
+    return (NULL == ini_section_find(doc, SEC_NAME, 0)) ? 0 : -INI_ERR_SECTION_MISMATCHED;
+}
+
+static int test_change_tracking(ini_doc_t *doc)
+{
+    const char* const EXPECTED[][2] = {
+        { "__TRACKED__", NULL }, { "__TRACKED__", "key" }, { "__TRACKED__", "key" },
+        { "__TRACKED__", NULL }, { "__RENAMED__", NULL }, { "__RENAMED__", "key" }, { "__RENAMED__", NULL }
+    };
+    const ini_change_t *changes = NULL;
+    unsigned long seq = 0;
+    size_t count = 0;
+    size_t i = 0;
+    ini_node_t *sec = NULL;
+    int err = 0;
+
+    if (NULL != ini_changes_since(doc, ini_changes_seq(doc), &count))
+        return -INI_ERR_ITEM_MISMATCHED; /* Tracking has not been enabled yet. */
+
+    ini_changes_track(doc, true);
+    seq = ini_changes_seq(doc);
+
+    if ((err = ini_section_add("__TRACKED__", strlen("__TRACKED__"), doc)) < 0
+        || (err = ini_item_add("key", 3, "old", 3, (sec = ini_section_find(doc, "__TRACKED__", 0)))) < 0
+        || (err = ini_item_set_value("new", 3, ini_item_find(sec, "key", 0))) < 0
+        || (err = ini_section_rename("__RENAMED__", strlen("__RENAMED__"), sec)) < 0
+        || (err = ini_item_remove("key", 0, sec)) < 0
+        || (err = ini_section_remove("__RENAMED__", 0, doc)) < 0)
+        return err;
+
+    if (NULL == (changes = ini_changes_since(doc, seq, &count)) || sizeof(EXPECTED) / sizeof(EXPECTED[0]) != count)
+        return -INI_ERR_ITEM_MISMATCHED;
+
+    for (i = 0; i < count; ++i) /* Replaced and removed strings should still be readable here. */
+    {
+        if (0 != strcmp(changes[i].sec_name, EXPECTED[i][0])
+            || (NULL == EXPECTED[i][1]) != (NULL == changes[i].key)
+            || (NULL != changes[i].key && 0 != strcmp(changes[i].key, EXPECTED[i][1])))
+            return -INI_ERR_ITEM_MISMATCHED;
+    }
+
+    seq = ini_changes_seq(doc);
+    ini_changes_clear(doc);
+    if (NULL == ini_changes_since(doc, seq, &count) || 0 != count || NULL != ini_changes_since(doc, seq - 1, &count))
+        return -INI_ERR_ITEM_MISMATCHED;
+
+    /* Tracking lasts until the last tracker turns it off. */
+    ini_changes_track(doc, true);
+    ini_changes_track(doc, false);
+    if (NULL == ini_changes_since(doc, seq, &count))
+        return -INI_ERR_ITEM_MISMATCHED;
+
+    ini_changes_track(doc, false);
+
+    return (NULL == ini_changes_since(doc, seq, &count)) ? 0 : -INI_ERR_ITEM_MISMATCHED;
+}
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+
+static ini_doc_t* parse_for_bench(const char *path, char *buf, size_t buf_len, int options, double *ms)
+{
+    double begin = 0;
+    ini_doc_t *doc = NULL;
+
+    begin = monotonic_milliseconds();
+    doc = (NULL == buf) ? ini_parse_from_file_mmap(path, options, NULL) : ini_parse_from_buffer(buf, buf_len, options, NULL);
+    *ms = monotonic_milliseconds() - begin;
+
+    return doc;
+}
+
+/* Usage: ini_file.elf --bench [file size in MB, 50 by default] [thread count, 0 by default for online CPUs] */
+static int bench_parallel_parsing(long size_mb, int threads)
+{
+    const char *PATH = "ini_file_bench.ini";
+    const int OPTIONS = INI_PARSE_STRIP_BLANKS | INI_PARSE_HASH_INDEX | INI_PARSE_ARENA;
+    FILE *stream = fopen(PATH, "w");
+    char *file_buf = NULL;
+    long file_size = 0;
+    int mode = 0;
+    int err = -1;
+
+    if (NULL == stream)
+        return -1;
+
+    for (; file_size < size_mb * 1024 * 1024; ++err) /* A generated device table. */
+    {
+        file_size += fprintf(stream, "[device%07d]\n; generated\nid = %d\nname = device-%d\naddr = 0x%08x\nirq = %d\nenabled = yes\n\n",
+            err + 1, err + 1, err + 1, (unsigned int)(err + 1) * 4096, (err + 1) % 256);
+    }
+    fclose(stream);
+
+    if (NULL != (stream = fopen(PATH, "r")) && NULL != (file_buf = (char *)malloc(file_size + 1)))
+        file_size = (long)fread(file_buf, 1, file_size, stream);
+    if (NULL != stream)
+        fclose(stream);
+
+    ini_set_parse_threads(threads);
+    for (err = (NULL == file_buf) ? -1 : 0; mode < 2 && 0 == err; ++mode)
+    {
+        double ms[2] = { 0 };
+        char *dumps[2] = { NULL, NULL };
+        size_t dump_lens[2] = { 0, 0 };
+        int i;
+
+        for (i = 0; i < 2; ++i)
+        {
+            ini_doc_t *doc = parse_for_bench(PATH, mode ? NULL : file_buf, file_size, OPTIONS | (i ? INI_PARSE_PARALLEL : 0), &ms[i]);
+
+            if (NULL == doc || ini_dump_to_buffer(doc, &dumps[i], &dump_lens[i], 1).error_code < 0
+                || NULL == ini_section_find(doc, "device0000000", 0) || ini_section_is_repeated(doc, "device0000001", 0))
+                err = -1;
+            ini_destroy(doc); /* Before the next parsing, so that both parse with the same heap state. */
+        }
+
+        if (0 == err && 0 != strcmp(dumps[0], dumps[1]))
+            err = -1;
+
+        printf("%s of %ld bytes (%s scanner): sequential: %.1f ms (%.0f MB/s), parallel: %.1f ms (%.0f MB/s), %s\n",
+            mode ? "Mapping" : "Buffer", file_size, INI_SIMD_NAME, ms[0], file_size / 1048.576 / ms[0],
+            ms[1], file_size / 1048.576 / ms[1], (0 == err) ? "same results" : "DIFFERENT RESULTS!");
+
+        free(dumps[0]);
+        free(dumps[1]);
+    }
+
+    if (0 == err && NULL != (stream = fopen(PATH, "r")))
+    {
+        char *dumps[2] = { NULL, NULL };
+        size_t dump_lens[2] = { 0, 0 };
+        double begin = 0;
+        ini_doc_t *doc = NULL;
+        double ms = 0;
+
+        begin = monotonic_milliseconds();
+        doc = ini_parse_from_stream(stream, OPTIONS, NULL);
+        ms = monotonic_milliseconds() - begin;
+        fclose(stream);
+        if (NULL == doc || ini_dump_to_buffer(doc, &dumps[0], &dump_lens[0], 1).error_code < 0)
+            err = -1;
+        ini_destroy(doc);
+
+        doc = ini_parse_from_buffer(file_buf, file_size, OPTIONS, NULL);
+        if (NULL == doc || ini_dump_to_buffer(doc, &dumps[1], &dump_lens[1], 1).error_code < 0
+            || (0 == err && 0 != strcmp(dumps[0], dumps[1])))
+            err = -1;
+        ini_destroy(doc);
+
+        printf("Stream of %ld bytes (%s scanner): %.1f ms (%.0f MB/s), %s\n", file_size, INI_SIMD_NAME,
+            ms, file_size / 1048.576 / ms, (0 == err) ? "same results as the buffer" : "DIFFERENT RESULTS!");
+
+        free(dumps[0]);
+        free(dumps[1]);
+    }
+
+    free(file_buf);
+    remove(PATH);
+
+    return err;
+}
+
+#endif /* #if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS) */
+
 int main(int argc, char **argv)
 {
     char buf[INI_LINE_SIZE_MAX + 1] = { 0 };
@@ -1104,6 +2582,11 @@ int main(int argc, char **argv)
     size_t ini_str_len = 0;
     ini_summary_t summary = { 0 };
 
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+    if (argc > 1 && 0 == strcmp(argv[1], "--bench"))
+        return bench_parallel_parsing((argc > 2) ? atol(argv[2]) : 50, (argc > 3) ? atoi(argv[3]) : 0);
+#endif
+
     printf("Step 1: Please specify the indent width (from 0 to 16) [0]: ");
     ini_set_item_indent_width(atoi(fgets(buf, sizeof(buf), stdin)) % (INI_INDENT_WIDTH_MAX + 1));
 
@@ -1122,7 +2605,7 @@ int main(int argc, char **argv)
         strncpy(path, DEFAULT_RESULT_PATH, sizeof(path));
 
     printf("Step 4: Please enter contents of your .ini file, and press Ctrl+D to start test:\n");
-    doc = ini_parse_from_stream(stdin, /*strip_blanks = */0, &summary);
+    doc = ini_parse_from_stream(stdin, /* options = */0, &summary);
     print_summary(&summary, "Parse[1] summary", (summary.error_code < 0) ? stderr : stdout);
     if (summary.error_code < 0)
     {
@@ -1150,8 +2633,23 @@ int main(int argc, char **argv)
     }
     printf("Capacity of ini_str_buf has expanded from 0 to %d, contents:\n%s\n", (int)ini_str_len, ini_str_buf);
 
+    /* A buffer which can't grow is enough when it's as large as the text, without room for a null terminator. */
+    {
+        size_t exact_len = strlen(ini_str_buf);
+        char *exact_buf = (char *)malloc(exact_len);
+
+        summary = ini_dump_to_buffer(doc, &exact_buf, &exact_len, /*allow_resizing = */0);
+        if (NULL == exact_buf || summary.error_code < 0 || 0 != memcmp(exact_buf, ini_str_buf, exact_len))
+        {
+            fprintf(stderr, "Failed to dump into a buffer of the exact size: %s\n", ini_error(summary.error_code));
+            free(exact_buf);
+            goto TEST_END;
+        }
+        free(exact_buf);
+    }
+
     ini_destroy(doc);
-    doc = ini_parse_from_buffer(ini_str_buf, strlen(ini_str_buf), /*strip_blanks =*/1, &summary);
+    doc = ini_parse_from_buffer(ini_str_buf, strlen(ini_str_buf), INI_PARSE_STRIP_BLANKS | INI_PARSE_HASH_INDEX | INI_PARSE_ARENA, &summary);
     print_summary(&summary, "Parse[2] summary", (summary.error_code < 0) ? stderr : stdout);
     if (summary.error_code < 0)
     {
@@ -1169,6 +2667,18 @@ int main(int argc, char **argv)
         goto TEST_END;
     }
 
+    if ((summary.error_code = test_adders_and_removers(doc)) < 0)
+    {
+        fprintf(stderr, "Failed to test adders and removers: %s\n", ini_error(summary.error_code));
+        goto TEST_END;
+    }
+
+    if ((summary.error_code = test_change_tracking(doc)) < 0)
+    {
+        fprintf(stderr, "Failed to test change tracking: %s\n", ini_error(summary.error_code));
+        goto TEST_END;
+    }
+
     wstream = fopen(path, "w");
     if (NULL == wstream)
     {
@@ -1201,7 +2711,7 @@ int main(int argc, char **argv)
     }
 
     ini_destroy(doc);
-    doc = ini_parse_from_stream(rstream, /*strip_blanks =*/1, &summary);
+    doc = ini_parse_from_stream(rstream, INI_PARSE_STRIP_BLANKS | INI_PARSE_ARENA, &summary);
     print_summary(&summary, "Parse[3] summary", (summary.error_code < 0) ? stderr : stdout);
     if (summary.error_code < 0)
     {
@@ -1213,6 +2723,37 @@ int main(int argc, char **argv)
     summary = ini_dump_to_stream(doc, stdout);
     print_summary(&summary, "Dump[3] summary", (summary.error_code < 0) ? stderr : stdout);
     if (summary.error_code < 0)
+    {
+        fprintf(stderr, "Failed to dump the ini memory, error occured at line %d: %s\n",
+            summary.success_lines + 1, ini_error(summary.error_code));
+        goto TEST_END;
+    }
+
+    ini_destroy(doc);
+    doc = ini_parse_from_file_mmap(path, INI_PARSE_STRIP_BLANKS | INI_PARSE_HASH_INDEX, &summary);
+    print_summary(&summary, "Parse[4] summary", (summary.error_code < 0) ? stderr : stdout);
+    if (summary.error_code < 0)
+    {
+        fprintf(stderr, "Failed to parse the mapping, error occured at line %d: %s\n",
+            summary.success_lines + 1, ini_error(summary.error_code));
+        goto TEST_END;
+    }
+
+    if ((summary.error_code = test_adders_and_removers(doc)) < 0)
+    {
+        fprintf(stderr, "Failed to test adders and removers on the mapping: %s\n", ini_error(summary.error_code));
+        goto TEST_END;
+    }
+
+    if ((summary.error_code = test_change_tracking(doc)) < 0)
+    {
+        fprintf(stderr, "Failed to test change tracking on the mapping: %s\n", ini_error(summary.error_code));
+        goto TEST_END;
+    }
+
+    summary = ini_dump_to_stream(doc, stdout);
+    print_summary(&summary, "Dump[4] summary", (summary.error_code < 0) ? stderr : stdout);
+    if (summary.error_code < 0)
     {
         fprintf(stderr, "Failed to dump the ini memory, error occured at line %d: %s\n",
             summary.success_lines + 1, ini_error(summary.error_code));
@@ -1288,5 +2829,29 @@ TEST_END:
  *
  * >>> 2022-05-16, Man Hung-Coeng:
  *  01. Eliminate warnings from VIM plugins.
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Add optional hash indexes over sections and items (INI_PARSE_HASH_INDEX),
+ *      which are kept in sync by adding, removing and renaming.
+ *  02. Make use of name_len and key_len in lookup functions.
+ *  03. Implement ini_{section,item}_{add,remove}().
+ *  04. Fix the wrong source pointer of ini_section_rename() when the new name
+ *      has leading blanks, and the memory leak of ini_destroy() on empty documents.
+ *  05. Fix the -Wstringop-overflow errors of test code reported by newer GCC.
+ *  06. Add an arena parse mode (INI_PARSE_ARENA) which allocates all nodes
+ *      and strings of a document from a few large chunks.
+ *  07. Add ini_parse_from_file_mmap() for in-situ parsing without line length limit.
+ *  08. Cache lengths of names, keys, values, the newline and the indent,
+ *      and make ini_dump_to_buffer() measure the whole document first,
+ *      then allocate only once and null-terminate the result if there is room.
+ *  09. Add ini_changes_*() to track modifications of a document.
+ *  10. Add INI_PARSE_PARALLEL option to parse large buffers and mappings
+ *      in threads, and a benchmark of it (ini_file.elf --bench).
+ *  11. Scan for line ends, brackets and equal signs 16 bytes at a time
+ *      with SSE2 or NEON if available (define INI_NO_SIMD to disable it).
+ *  12. Read streams block by block with the same scanner instead of fgets(),
+ *      and strip blanks 16 bytes at a time as well.
+ *  13. Count trackers of changes, and keep retired strings and nodes
+ *      until the only or last tracker is done with them.
  */
 
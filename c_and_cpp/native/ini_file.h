@@ -1,7 +1,7 @@
 /*
  * APIs for Windows .ini file manipulation.
  *
- * Copyright (c) 2021 Man Hung-Coeng <udc577@126.com>
+ * Copyright (c) 2021-2026 Man Hung-Coeng <udc577@126.com>
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -49,6 +49,20 @@ extern "C" {
 #define INI_NODE_SECTION        's'
 #define INI_NODE_ITEM           'i'
 
+#define INI_PARSE_STRIP_BLANKS  0x01 /* Strips blanks around item values. */
+#define INI_PARSE_HASH_INDEX    0x02 /* Indexes sections and items for O(1) lookups, kept in sync on modifications. */
+/*
+ * Allocates nodes and strings from chunks owned by the document, which are freed as a whole by ini_destroy().
+ * Strings replaced by setters go to the heap; memory of removed nodes is not reclaimed until ini_destroy().
+ */
+#define INI_PARSE_ARENA         0x04
+/*
+ * Splits the text into chunks beginning with section lines and parses them in threads,
+ * for large buffers and mappings only (ignored by ini_parse_from_stream() and on Windows).
+ * The number of threads is set by ini_set_parse_threads().
+ */
+#define INI_PARSE_PARALLEL      0x08
+
 struct ini_node_t;
 typedef struct ini_node_t ini_node_t;
 
@@ -72,16 +86,32 @@ void ini_set_newline(const char* const newline); /* \n for *nix, \r\n for Window
 
 void ini_set_item_indent_width(size_t width);
 
+void ini_set_parse_threads(int count/* = 0 for the number of online CPUs */);
+
 char ini_node_type(const ini_node_t *node);
 
-ini_doc_t* ini_parse_from_stream(FILE *stream, int strip_blanks/* = 0 or 1, for item value only */,
+ini_doc_t* ini_parse_from_stream(FILE *stream, int options/* = 0 or INI_PARSE_* flags */,
     ini_summary_t *nullable_summary/* = NULL if failure reason not cared*/);
 
-ini_doc_t* ini_parse_from_buffer(char *buf, size_t buf_len, int strip_blanks/* = 0 or 1, for item value only */,
+ini_doc_t* ini_parse_from_buffer(char *buf, size_t buf_len, int options/* = 0 or INI_PARSE_* flags */,
     ini_summary_t *nullable_summary/* = NULL if failure reason not cared*/);
 
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+/*
+ * Parses a file in place within a private mapping of it, without the limit of INI_LINE_SIZE_MAX.
+ * Unmodified names, keys, values and comments point into the mapping, which lives until ini_destroy().
+ * INI_PARSE_ARENA is always implied.
+ */
+ini_doc_t* ini_parse_from_file_mmap(const char *path, int options/* = 0 or INI_PARSE_* flags */,
+    ini_summary_t *nullable_summary/* = NULL if failure reason not cared*/);
+#endif
+
 ini_summary_t ini_dump_to_stream(const ini_doc_t *doc, FILE *stream);
 
+/*
+ * A buffer as large as the dumped text is enough. The text is null-terminated if there is a byte left,
+ * which is always the case when the buffer has been (re)allocated by this function.
+ */
 ini_summary_t ini_dump_to_buffer(const ini_doc_t *doc, char **buf, size_t *buf_len, int allow_resizing);
 
 void ini_destroy(ini_doc_t *doc);
@@ -98,6 +128,40 @@ ini_summary_t ini_traverse_all_sections(ini_doc_t *doc, ini_traverval_callback_t
 
 ini_summary_t ini_traverse_nodes_of(ini_node_t *sec, ini_traverval_callback_t cb, void *cb_arg);
 
+/*
+ * ================
+ *  CHANGE TRACKING
+ * ================
+ */
+
+typedef struct ini_change_t
+{
+    const char *sec_name;
+    const char *key; /* NULL for section-level changes (addition, removal and renaming). */
+} ini_change_t;
+
+/*
+ * Once enabled, every rename/set/add/remove operation on the document is recorded
+ * with a sequence number, and strings or nodes replaced by those operations
+ * are kept alive until ini_changes_clear() is called, so that a consumer
+ * (e.g., ini_map_c) can re-sync only the changed parts of its own view.
+ * Each consumer enables it once and disables it once: tracking lasts until the last one disables it,
+ * which clears and releases the records, and while several consumers track the document,
+ * ini_changes_clear() keeps the retired strings and nodes since others may still refer to them.
+ */
+int ini_changes_track(ini_doc_t *doc, bool enabled);
+
+unsigned long ini_changes_seq(const ini_doc_t *doc);
+
+/*
+ * Returns the records made after since_seq, or NULL if they're incomplete
+ * (tracking disabled, cleared or dropped due to memory shortage),
+ * in which case the consumer has to re-sync fully.
+ */
+const ini_change_t* ini_changes_since(const ini_doc_t *doc, unsigned long since_seq, size_t *count);
+
+void ini_changes_clear(ini_doc_t *doc);
+
 /*
  * ================
  *  SECTION
@@ -189,5 +253,16 @@ int ini_comment_set(const char *comment, size_t comment_len, ini_node_t *node);
  *  01. Rename file simple_ini_config.{c,h} to ini_file.{c,h}.
  *  02. Rename structure ini_cfg_t to ini_doc_t.
  *  03. Change return type of ini_{section,item}_is_repeated() to bool.
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Replace the strip_blanks parameter of ini_parse_from_{stream,buffer}()
+ *      with option flags: INI_PARSE_STRIP_BLANKS (same as the old value 1)
+ *      and INI_PARSE_HASH_INDEX.
+ *  02. Implement ini_{section,item}_{add,remove}().
+ *  03. Add INI_PARSE_ARENA option.
+ *  04. Add ini_parse_from_file_mmap().
+ *  05. Add ini_changes_*() for change tracking.
+ *  06. Add INI_PARSE_PARALLEL option and ini_set_parse_threads().
+ *  07. Count trackers in ini_changes_track() for several consumers of the same document.
  */
 
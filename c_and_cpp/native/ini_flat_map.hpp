@@ -0,0 +1,336 @@
+/*
+ * A frozen read-only class built once from parsed INI data,
+ * with the same operator [] as ini_map_c but backed by sorted flat arrays
+ * of pre-hashed entries and interned strings for faster look-ups.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __INLINE_INI_FLAT_MAP_HPP__
+#define __INLINE_INI_FLAT_MAP_HPP__
+
+#include <string.h>
+
+#include "ini_file.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * Unlike ini_map_c, all strings are copied into a pool owned by the object,
+ * so it doesn't depend on the document after construction,
+ * and has no sync(): build a new one to see the changes of the document.
+ * Repeated sections are merged and the first one of repeated items wins,
+ * which is the same as ini_map_c.
+ */
+class ini_flat_map_c final
+{
+public:
+    typedef struct item_t
+    {
+        size_t hash;
+        const char *key;
+        const char *value;
+    } item_t;
+
+private:
+    template<typename T>
+    static const T* find_entry(const T *begin, const T *end, const char *name,
+        size_t T::*hash_member, const char* T::*name_member)
+    {
+        size_t hash = hash_of(name);
+        const T *iter = std::lower_bound(begin, end, hash, [hash_member](const T &entry, size_t h) {
+            return entry.*hash_member < h;
+        });
+
+        for (; end != iter && hash == iter->*hash_member; ++iter)
+        {
+            if (0 == strcmp(iter->*name_member, name))
+                return iter;
+        }
+
+        return end;
+    }
+
+public:
+    class section_c
+    {
+    public:
+        const char* operator[](const char *key) const
+        {
+            const item_t *iter = (nullptr == key) ? end() : find_entry(begin(), end(), key, &item_t::hash, &item_t::key);
+            const char *safe_key = ((nullptr == key) ? "<nullptr>" : key);
+
+            if (end() == iter)
+                throw std::invalid_argument(std::string("INI configuration key not found: ") + safe_key);
+
+            return iter->value;
+        }
+
+        inline const char* name(void) const
+        {
+            return name_;
+        }
+
+        inline size_t size(void) const
+        {
+            return count_;
+        }
+
+        inline const item_t* begin(void) const
+        {
+            return items_;
+        }
+
+        inline const item_t* end(void) const
+        {
+            return items_ + count_;
+        }
+
+    private:
+        friend class ini_flat_map_c;
+
+        size_t hash_;
+        const char *name_;
+        const item_t *items_;
+        size_t count_;
+    };
+
+    enum
+    {
+        ERR_NOT_INITIALIZED = 1
+        , ERR_MEM_ALLOC
+    };
+
+public:
+    ini_flat_map_c() = delete;
+
+    explicit ini_flat_map_c(ini_doc_t *doc)
+        : err_(-ERR_NOT_INITIALIZED)
+    {
+        if (nullptr == doc)
+            return;
+
+        try
+        {
+            construct(doc);
+        }
+        catch (const std::bad_alloc &)
+        {
+            err_ = -ERR_MEM_ALLOC;
+            pool_.clear();
+            items_.clear();
+            sections_.clear();
+        }
+    }
+
+    ini_flat_map_c(const ini_flat_map_c &src) = delete; /* Pointers would refer to the pool of src. */
+
+    ini_flat_map_c(ini_flat_map_c &&src) = default; /* Moving vectors keeps their buffers. */
+
+    ini_flat_map_c& operator=(const ini_flat_map_c &src) = delete;
+
+    ini_flat_map_c& operator=(ini_flat_map_c &&src) = default;
+
+    inline int error_code(void) const
+    {
+        return err_;
+    }
+
+    const char* error_string(void) const
+    {
+        if (err_ >= 0)
+            return "OK";
+
+        switch (err_)
+        {
+        case -ERR_NOT_INITIALIZED:
+            return "Not initialized";
+
+        case -ERR_MEM_ALLOC:
+            return "Failed to allocate memory";
+
+        default:
+            break;
+        }
+
+        return ini_error(err_);
+    }
+
+    const section_c& operator[](const char *section) const
+    {
+        const section_c *iter = (nullptr == section) ? end()
+            : find_entry(begin(), end(), section, &section_c::hash_, &section_c::name_);
+        const char *safe_sec = ((nullptr == section) ? "<nullptr>" : section);
+
+        if (end() == iter)
+            throw std::invalid_argument(std::string("INI configuration section not found: [") + safe_sec + "]");
+
+        return *iter;
+    }
+
+    inline size_t size(void) const
+    {
+        return sections_.size();
+    }
+
+    inline const section_c* begin(void) const
+    {
+        return sections_.data();
+    }
+
+    inline const section_c* end(void) const
+    {
+        return sections_.data() + sections_.size();
+    }
+
+private:
+    static size_t hash_of(const char *str)
+    {
+        size_t hash = 2166136261UL; /* FNV-1a, same as the hash index of ini_file.c. */
+
+        for (; '\0' != *str; ++str)
+        {
+            hash ^= (unsigned char)*str;
+            hash *= 16777619UL;
+        }
+
+        return hash;
+    }
+
+    typedef struct builder_t
+    {
+        std::vector<const char *> sec_names; /* In order of first appearance. */
+        std::unordered_map<std::string, size_t> sec_ids;
+        std::vector<std::vector<std::pair<const char *, const char *> > > items;
+        std::vector<std::unordered_set<std::string> > keys;
+    } builder_t;
+
+    static int collect_node(const char *section, ini_node_t *cur_node, void *builder)
+    {
+        builder_t *b = (builder_t *)builder;
+
+        switch (ini_node_type(cur_node))
+        {
+        case INI_NODE_SECTION:
+            if (b->sec_ids.insert(std::make_pair(std::string(section), b->sec_names.size())).second)
+            {
+                b->sec_names.push_back(section);
+                b->items.push_back(std::vector<std::pair<const char *, const char *> >());
+                b->keys.push_back(std::unordered_set<std::string>());
+            }
+
+            break;
+
+        case INI_NODE_ITEM:
+            {
+                size_t id = b->sec_ids.find(section)->second;
+                const char *key = ini_item_get_key(cur_node);
+
+                if (b->keys[id].insert(key).second)
+                    b->items[id].push_back(std::make_pair(key, ini_item_get_value(cur_node)));
+            }
+
+            break;
+
+        default:
+            break;
+        }
+
+        return 0;
+    }
+
+    void construct(ini_doc_t *doc)
+    {
+        builder_t b;
+        std::unordered_map<std::string, size_t> offsets; /* Interned string => offset in pool_. */
+        auto intern = [&](const char *str) -> size_t
+        {
+            auto result = offsets.insert(std::make_pair(std::string(str), pool_.size()));
+
+            if (result.second)
+                pool_.insert(pool_.end(), str, str + strlen(str) + 1);
+
+            return result.first->second;
+        };
+        std::vector<std::pair<size_t, size_t> > item_offsets; /* Offsets of keys and values in pool_. */
+        std::vector<std::pair<size_t, size_t> > sec_offsets; /* Offsets of names in pool_, and of first items in items_. */
+
+        if ((err_ = ini_traverse_all_nodes(doc, collect_node, &b).error_code) < 0)
+            return;
+
+        sec_offsets.reserve(b.sec_names.size());
+        for (size_t i = 0; i < b.sec_names.size(); ++i)
+        {
+            sec_offsets.push_back(std::make_pair(intern(b.sec_names[i]), item_offsets.size()));
+            for (auto &pair : b.items[i])
+            {
+                item_offsets.push_back(std::make_pair(intern(pair.first), intern(pair.second)));
+            }
+        }
+        pool_.shrink_to_fit();
+
+        // Neither the pool nor the item array grows from now on, so offsets can become pointers.
+        items_.reserve(item_offsets.size());
+        for (auto &offsets : item_offsets)
+        {
+            const char *key = pool_.data() + offsets.first;
+
+            items_.push_back({ hash_of(key), key, pool_.data() + offsets.second });
+        }
+
+        sections_.resize(b.sec_names.size());
+        for (size_t i = 0; i < sections_.size(); ++i)
+        {
+            section_c &sec = sections_[i];
+            item_t *sec_items = items_.data() + sec_offsets[i].second;
+
+            sec.name_ = pool_.data() + sec_offsets[i].first;
+            sec.hash_ = hash_of(sec.name_);
+            sec.items_ = sec_items;
+            sec.count_ = b.items[i].size();
+            std::sort(sec_items, sec_items + sec.count_, [](const item_t &a, const item_t &b) {
+                return (a.hash != b.hash) ? (a.hash < b.hash) : (strcmp(a.key, b.key) < 0);
+            });
+        }
+
+        std::sort(sections_.begin(), sections_.end(), [](const section_c &a, const section_c &b) {
+            return (a.hash_ != b.hash_) ? (a.hash_ < b.hash_) : (strcmp(a.name_, b.name_) < 0);
+        });
+    }
+
+private:
+    int err_;
+    std::vector<char> pool_;
+    std::vector<item_t> items_;
+    std::vector<section_c> sections_;
+};
+
+#endif /* #ifndef __INLINE_INI_FLAT_MAP_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. Keep offsets as indices until the pool is complete, and rename section_c::hash to hash_.
+ */
+
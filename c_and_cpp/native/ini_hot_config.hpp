@@ -0,0 +1,347 @@
+/*
+ * A holder of INI configuration that can be reloaded while other threads
+ * are reading it, by publishing immutable snapshots RCU-style.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __INLINE_INI_HOT_CONFIG_HPP__
+#define __INLINE_INI_HOT_CONFIG_HPP__
+
+#include <stdio.h>
+
+#include "ini_map.hpp"
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+/*
+ * Usage:
+ *
+ * ini_hot_config_c<> cfg("app.ini");
+ *
+ * // Worker threads, never blocked by reloading:
+ * {
+ *     auto snapshot = cfg.read(); // Keep it short-lived, reloading waits for it.
+ *     const char *timeout = (*snapshot)["net"]["timeout"];
+ * }
+ *
+ * // Any other thread, e.g., on a file change notification:
+ * if (cfg.reload() < 0) { ...keep using the old snapshot... }
+ *
+ * A thread must not call reload() while holding a reader, or it waits for itself forever.
+ *
+ * M can be ini_map_c or ini_flat_map_c. A snapshot is never modified after being published,
+ * and all const member functions of both, typed accessors of ini_map_c included,
+ * can be called on it by several threads at the same time.
+ */
+template<typename M = ini_map_c>
+class ini_hot_config_c final
+{
+private:
+    /* Takes the document from the caller, and destroys it after the map which refers to it. */
+    typedef struct doc_owner_t
+    {
+        ini_doc_t *doc;
+
+        explicit doc_owner_t(ini_doc_t *&d)
+            : doc(d)
+        {
+            d = nullptr;
+        }
+
+        ~doc_owner_t()
+        {
+            ini_destroy(doc);
+        }
+    } doc_owner_t;
+
+    typedef struct snapshot_t
+    {
+        doc_owner_t owner; /* Declared ahead of the map, so destroyed after it. */
+        M map;
+        unsigned long version;
+
+        snapshot_t(ini_doc_t *&d, unsigned long ver)
+            : owner(d)
+            , map(owner.doc)
+            , version(ver)
+        {
+        }
+    } snapshot_t;
+
+    enum
+    {
+        ERR_NOT_LOADED = 1
+        , ERR_OPEN_FILE
+        , ERR_MEM_ALLOC
+    };
+
+public:
+    class reader_c
+    {
+    public:
+        reader_c(const reader_c &src) = delete;
+
+        reader_c(reader_c &&src)
+            : counter_(src.counter_)
+            , snapshot_(src.snapshot_)
+        {
+            src.counter_ = nullptr;
+        }
+
+        reader_c& operator=(const reader_c &src) = delete;
+
+        reader_c& operator=(reader_c &&src) = delete;
+
+        ~reader_c()
+        {
+            if (nullptr != counter_)
+                counter_->fetch_sub(1);
+        }
+
+        inline const M& operator*(void) const
+        {
+            return snapshot_->map;
+        }
+
+        inline const M* operator->(void) const
+        {
+            return &snapshot_->map;
+        }
+
+        inline unsigned long version(void) const
+        {
+            return snapshot_->version;
+        }
+
+    private:
+        friend class ini_hot_config_c;
+
+        reader_c(std::atomic<unsigned long> *counter, const snapshot_t *snapshot)
+            : counter_(counter)
+            , snapshot_(snapshot)
+        {
+        }
+
+        std::atomic<unsigned long> *counter_;
+        const snapshot_t *snapshot_;
+    };
+
+public:
+    ini_hot_config_c() = delete;
+
+    explicit ini_hot_config_c(const char *path, int parse_options = INI_PARSE_STRIP_BLANKS)
+        : path_(path)
+        , options_(parse_options)
+        , err_(-ERR_NOT_LOADED)
+        , current_(nullptr)
+        , epoch_(0)
+    {
+        readers_[0] = 0;
+        readers_[1] = 0;
+        reload();
+    }
+
+    ini_hot_config_c(const ini_hot_config_c &src) = delete;
+
+    ini_hot_config_c& operator=(const ini_hot_config_c &src) = delete;
+
+    ~ini_hot_config_c() /* All readers must have been destroyed. */
+    {
+        delete current_.load();
+    }
+
+    inline int error_code(void) const /* Result of the last reloading. */
+    {
+        return err_.load();
+    }
+
+    const char* error_string(void) const
+    {
+        int err = err_.load();
+
+        if (err >= 0)
+            return "OK";
+
+        switch (err)
+        {
+        case -ERR_NOT_LOADED:
+            return "Not loaded";
+
+        case -ERR_OPEN_FILE:
+            return "Failed to open the file";
+
+        case -ERR_MEM_ALLOC:
+            return "Failed to allocate memory";
+
+        default:
+            break;
+        }
+
+        return ini_error(err);
+    }
+
+    inline const std::string& path(void) const
+    {
+        return path_;
+    }
+
+    /* Returns 0 on success, or a negative error code with the old snapshot kept. */
+    int reload(void)
+    {
+        FILE *stream = fopen(path_.c_str(), "r");
+        ini_summary_t summary;
+        ini_doc_t *doc = nullptr;
+
+        if (nullptr == stream)
+            return (err_ = -ERR_OPEN_FILE);
+
+        doc = ini_parse_from_stream(stream, options_, &summary);
+        fclose(stream);
+
+        return (nullptr == doc) ? (err_ = summary.error_code) : publish(doc);
+    }
+
+    /*
+     * Same as reload() but with a document parsed elsewhere, e.g., by ini_watcher_t:
+     *
+     * static void on_reload(ini_doc_t *nullable_doc, const ini_summary_t *summary, void *cfg)
+     * {
+     *     if (nullptr != nullable_doc)
+     *         ((ini_hot_config_c<> *)cfg)->publish(nullable_doc);
+     * }
+     *
+     * The ownership of the document is taken even on failure.
+     */
+    int publish(ini_doc_t *doc)
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        snapshot_t *snapshot = nullptr;
+        snapshot_t *old = nullptr;
+
+        try
+        {
+            old = current_.load();
+            snapshot = new snapshot_t(doc, (nullptr == old) ? 1 : (old->version + 1));
+        }
+        catch (const std::bad_alloc &)
+        {
+            ini_destroy(doc); // Still owned here if the snapshot itself failed to be allocated.
+
+            return (err_ = -ERR_MEM_ALLOC);
+        }
+
+        if (snapshot->map.error_code() < 0)
+        {
+            int err = snapshot->map.error_code();
+
+            delete snapshot;
+
+            return (err_ = err);
+        }
+
+        old = current_.exchange(snapshot);
+        synchronize();
+        delete old;
+
+        return (err_ = 0);
+    }
+
+    /*
+     * Parses in a background thread. Get the result from the returned future,
+     * which must be done before this object is destroyed.
+     */
+    std::future<int> reload_async(void)
+    {
+        return std::async(std::launch::async, [this]{ return reload(); });
+    }
+
+    /* Throws std::logic_error if nothing has been loaded successfully. */
+    reader_c read(void) const
+    {
+        std::atomic<unsigned long> *counter = nullptr;
+        const snapshot_t *snapshot = nullptr;
+
+        while (true)
+        {
+            unsigned long epoch = epoch_.load();
+
+            counter = &readers_[epoch & 1];
+            counter->fetch_add(1);
+            if (epoch_.load() == epoch)
+                break;
+
+            counter->fetch_sub(1); // Reloading flipped the epoch in between, so register again.
+        }
+
+        if (nullptr == (snapshot = current_.load()))
+        {
+            counter->fetch_sub(1);
+            throw std::logic_error("No INI configuration loaded from " + path_);
+        }
+
+        return reader_c(counter, snapshot);
+    }
+
+    inline unsigned long version(void) const /* 0 if nothing has been loaded. */
+    {
+        return (nullptr == current_.load()) ? 0 : read().version();
+    }
+
+private:
+    /*
+     * Waits until readers which may still see the old snapshot have left:
+     * they registered on the counter of the old epoch before it was flipped,
+     * while readers registering afterwards can only see the new snapshot.
+     */
+    void synchronize(void)
+    {
+        unsigned long old_epoch = epoch_.fetch_add(1);
+
+        while (0 != readers_[old_epoch & 1].load())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    std::string path_;
+    int options_;
+    std::atomic<int> err_;
+    std::atomic<snapshot_t*> current_;
+    mutable std::atomic<unsigned long> epoch_;
+    mutable std::atomic<unsigned long> readers_[2];
+    std::mutex writer_mutex_;
+};
+
+#endif /* #ifndef __INLINE_INI_HOT_CONFIG_HPP__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. Add publish() for documents parsed by others, e.g., ini_watcher_t.
+ *  03. Destroy the document of a snapshot after its map.
+ *  04. Allow concurrent typed accessors on the same snapshot.
+ */
+
@@ -2,7 +2,7 @@
  * A read-only class based on std::map and the relative C APIs
  * to make it easier to access parsed INI data.
  *
- * Copyright (c) 2021-2022 Man Hung-Coeng <udc577@126.com>
+ * Copyright (c) 2021-2026 Man Hung-Coeng <udc577@126.com>
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -20,12 +20,21 @@
 #ifndef __INLINE_INI_MAP_HPP__
 #define __INLINE_INI_MAP_HPP__
 
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "ini_file.h"
 
+#include <atomic>
+#include <chrono>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
 
 class ini_map_c final
 {
@@ -64,9 +73,48 @@ private:
         , ERR_MEM_ALLOC
     };
 
+    enum
+    {
+        PARSED_INTEGER = 0x01
+        , PARSED_REAL = 0x02
+        , PARSED_BOOLEAN = 0x04
+        , PARSED_DURATION = 0x08
+        , PARSED_SIZE = 0x10
+    };
+
+    typedef struct typed_value_t
+    {
+        unsigned char parsed; /* PARSED_* flags of types the value is valid for */
+        unsigned char overflowed; /* PARSED_* flags of types the value is out of range of */
+        bool boolean;
+        long long integer;
+        double real;
+        long long nanoseconds;
+        unsigned long long bytes;
+    } typed_value_t;
+
+    typedef struct typed_entry_t
+    {
+        std::once_flag parsing; /* The value is parsed as all types on the first typed access. */
+        typed_value_t typed;
+    } typed_entry_t;
+
+    typedef std::unordered_map<const char*, typed_entry_t> typed_cache_t; /* Value string => parsed results */
+
+    template<typename T>
+    struct type_tag_t
+    {
+    };
+
 public:
     ini_map_c() = delete;
 
+    /*
+     * The map refers to strings of the document, and turns on its change tracking for sync(),
+     * so the document must outlive the map, which turns its own tracking off on destruction.
+     * Several maps of the same document work too, at the cost of a full rebuild in sync()
+     * of the others after one of them has synced.
+     */
     explicit ini_map_c(ini_doc_t *doc, const char *path = nullptr)
     {
         reset();
@@ -86,6 +134,9 @@ public:
         , dir_(src.dir_)
         , basename_(src.basename_)
         , map_(src.map_)
+        , seq_(src.seq_)
+        , cache_filled_(src.cache_filled_.load())
+        , cache_(std::move(src.cache_))
     {
         src.reset();
     }
@@ -112,6 +163,9 @@ public:
             this->dir_ = src.dir_;
             this->basename_ = src.basename_;
             this->map_ = src.map_;
+            this->seq_ = src.seq_;
+            this->cache_filled_ = src.cache_filled_.load();
+            this->cache_ = std::move(src.cache_);
 
             src.reset();
         }
@@ -191,21 +245,84 @@ public:
         return map_->end();
     }
 
-    inline int sync(void)
+    /*
+     * Typed accessors, which throw std::invalid_argument if the section, the key
+     * or the format of the value is invalid, or std::out_of_range on overflow.
+     * A value is parsed as all types on its first typed access, once even with concurrent calls,
+     * so later calls cost only the look-ups, and all are as safe as operator [] to make concurrently.
+     *
+     * Supported types:
+     *  1. Integer types: decimal, hexadecimal (0x) or octal (0) numbers.
+     *  2. Floating-point types.
+     *  3. bool: true/false, yes/no, on/off or 1/0, case-insensitive.
+     *  4. std::chrono::duration types: a number with an optional unit
+     *     among ns, us, ms, s, m/min, h and d, e.g., 1.5s. No unit means ms.
+     */
+    template<typename T>
+    inline T get(const char *section, const char *key) const
     {
+        const char *value = (*this)[section][key];
+
+        return parse_as(value, typed_value_of(value), type_tag_t<T>());
+    }
+
+    /*
+     * A number with an optional binary unit among K, M, G and T,
+     * optionally followed by B or iB (e.g., 4K, 16MiB, 1GB),
+     * where 1K is always 1024 bytes. No unit or a single B means bytes.
+     */
+    unsigned long long get_size(const char *section, const char *key) const
+    {
+        const char *value = (*this)[section][key];
+        const typed_value_t &typed = typed_value_of(value);
+
+        check_parsed(value, typed, PARSED_SIZE, "a size");
+
+        return typed.bytes;
+    }
+
+    /*
+     * Re-syncs only the sections and items changed since the last sync
+     * according to the change records of the document,
+     * and falls back to a full rebuild if the records are incomplete.
+     */
+    int sync(void)
+    {
+        size_t count = 0;
+        const ini_change_t *changes = nullptr;
+
         if (err_ < 0)
             return err_;
 
-        map_->clear();
+        if (nullptr == (changes = ini_changes_since(doc_, seq_, &count)))
+            return resync_all();
 
-        return (err_ = ini_traverse_all_nodes(doc_, save_node_into_map, map_).error_code);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (ini_section_is_repeated(doc_, changes[i].sec_name, 0))
+                return resync_all(); // Can't tell which one of them should be in the map.
+
+            if (nullptr == changes[i].key)
+                sync_section(changes[i].sec_name);
+            else
+                sync_item(changes[i].sec_name, changes[i].key);
+        }
+
+        seq_ = ini_changes_seq(doc_);
+        ini_changes_clear(doc_);
+
+        return err_;
     }
 
 private:
     inline void release(void)
     {
         if (nullptr != map_)
+        {
+            // Otherwise the document keeps retaining replaced strings and nodes for nobody.
+            ini_changes_track(doc_, false); // Still on for other maps of the document, if any.
             delete map_;
+        }
 
         char **xx[] = { &basename_, &dir_, &path_ };
 
@@ -224,6 +341,9 @@ private:
         dir_ = nullptr;
         basename_ = nullptr;
         map_ = nullptr;
+        seq_ = 0;
+        cache_filled_ = false;
+        cache_.clear();
     }
 
     void construct(ini_doc_t *doc, const char *path)
@@ -269,9 +389,340 @@ private:
             return;
         }
 
+        ini_changes_track(doc_, true);
+        seq_ = ini_changes_seq(doc_);
         err_ = ini_traverse_all_nodes(doc_, save_node_into_map, map_).error_code;
     }
 
+    static const char* skip_spaces(const char *str)
+    {
+        while (' ' == *str || '\t' == *str)
+            ++str;
+
+        return str;
+    }
+
+    static void throw_invalid(const char *value, const char *type_desc)
+    {
+        throw std::invalid_argument(std::string("INI configuration value is not ") + type_desc + ": " + value);
+    }
+
+    static void parse_integer(const char *value, typed_value_t &typed)
+    {
+        char *end = nullptr;
+
+        errno = 0;
+        typed.integer = strtoll(value, &end, 0);
+        if (end == value || '\0' != *skip_spaces(end))
+            return;
+
+        typed.parsed |= PARSED_INTEGER;
+        if (ERANGE == errno)
+            typed.overflowed |= PARSED_INTEGER;
+    }
+
+    static void parse_real(const char *value, typed_value_t &typed)
+    {
+        char *end = nullptr;
+
+        errno = 0;
+        typed.real = strtod(value, &end);
+        if (end == value || '\0' != *skip_spaces(end))
+            return;
+
+        typed.parsed |= PARSED_REAL;
+        if (ERANGE == errno)
+            typed.overflowed |= PARSED_REAL;
+    }
+
+    static void parse_boolean(const char *value, typed_value_t &typed)
+    {
+        static const char *TRUE_WORDS[] = { "true", "yes", "on", "1" };
+        static const char *FALSE_WORDS[] = { "false", "no", "off", "0" };
+
+        for (size_t i = 0; i < sizeof(TRUE_WORDS) / sizeof(TRUE_WORDS[0]); ++i)
+        {
+            bool matched[2] = { true, true };
+            const char *words[2] = { TRUE_WORDS[i], FALSE_WORDS[i] };
+
+            for (int j = 0; j < 2; ++j)
+            {
+                const char *v = value;
+                const char *w = words[j];
+
+                for (; '\0' != *w && tolower((unsigned char)*v) == *w; ++v, ++w)
+                    ;
+                matched[j] = ('\0' == *w && '\0' == *skip_spaces(v));
+            }
+
+            if (matched[0] || matched[1])
+            {
+                typed.boolean = matched[0];
+                typed.parsed |= PARSED_BOOLEAN;
+
+                return;
+            }
+        }
+    }
+
+    static void parse_duration(const char *value, typed_value_t &typed)
+    {
+        static const struct
+        {
+            const char *name;
+            double nanoseconds;
+        } UNITS[] = {
+            { "ns", 1.0 }, { "us", 1e3 }, { "ms", 1e6 }, { "s", 1e9 },
+            { "m", 60e9 }, { "min", 60e9 }, { "h", 3600e9 }, { "d", 86400e9 }
+        };
+        char *end = nullptr;
+        double num = strtod(value, &end);
+        const char *unit = skip_spaces(end);
+        size_t unit_len = 0;
+        double scale = 0;
+
+        if (end == value)
+            return;
+
+        while (isalpha((unsigned char)unit[unit_len]))
+            ++unit_len;
+
+        if (0 == unit_len)
+            scale = 1e6;
+        for (size_t i = 0; i < sizeof(UNITS) / sizeof(UNITS[0]) && 0 == scale; ++i)
+        {
+            if (strlen(UNITS[i].name) == unit_len && 0 == strncmp(UNITS[i].name, unit, unit_len))
+                scale = UNITS[i].nanoseconds;
+        }
+        if (0 == scale || '\0' != *skip_spaces(unit + unit_len))
+            return;
+
+        typed.parsed |= PARSED_DURATION;
+        num *= scale;
+        if (num > (double)std::numeric_limits<long long>::max() || num < (double)std::numeric_limits<long long>::min())
+            typed.overflowed |= PARSED_DURATION;
+        else
+            typed.nanoseconds = (long long)num;
+    }
+
+    static void parse_size(const char *value, typed_value_t &typed)
+    {
+        char *unit = nullptr;
+        const char *units = "KMGT";
+        const char *pos = nullptr;
+        unsigned long long num;
+
+        errno = 0;
+        num = strtoull(value, &unit, 10);
+        if (unit == value || '-' == *skip_spaces(value))
+            return;
+
+        unit = const_cast<char *>(skip_spaces(unit));
+        if ('\0' != *unit && nullptr != (pos = strchr(units, toupper((unsigned char)*unit))))
+        {
+            ++unit;
+            for (int i = 0; i <= pos - units; ++i)
+            {
+                if (num > std::numeric_limits<unsigned long long>::max() / 1024)
+                    errno = ERANGE;
+                num *= 1024;
+            }
+            if ('i' == *unit)
+                ++unit;
+        }
+        if ('B' == *unit || 'b' == *unit)
+            ++unit;
+        if ('\0' != *skip_spaces(unit))
+            return;
+
+        typed.bytes = num;
+        typed.parsed |= PARSED_SIZE;
+        if (ERANGE == errno)
+            typed.overflowed |= PARSED_SIZE;
+    }
+
+    static typed_value_t parse_all(const char *value)
+    {
+        typed_value_t typed;
+
+        memset(&typed, 0, sizeof(typed));
+        parse_integer(value, typed);
+        parse_real(value, typed);
+        parse_boolean(value, typed);
+        parse_duration(value, typed);
+        parse_size(value, typed);
+
+        return typed;
+    }
+
+    /* Entries are added unparsed, and only once the cache has been filled by a typed access. */
+    void cache_item(const char *value)
+    {
+        if (cache_filled_.load(std::memory_order_relaxed))
+            cache_.emplace(std::piecewise_construct, std::forward_as_tuple(value), std::forward_as_tuple());
+    }
+
+    void cache_items(const cstr_map_c &items)
+    {
+        for (auto &item : items)
+        {
+            cache_item(item.second);
+        }
+    }
+
+    void uncache_items(const cstr_map_c &items)
+    {
+        for (auto &item : items)
+        {
+            cache_.erase(item.second);
+        }
+    }
+
+    void uncache_all(void)
+    {
+        cache_filled_ = false;
+        cache_.clear();
+    }
+
+    const typed_value_t& typed_value_of(const char *value) const
+    {
+        typed_cache_t::iterator iter;
+
+        if (!cache_filled_.load(std::memory_order_acquire))
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex_);
+
+            if (!cache_filled_.load(std::memory_order_relaxed))
+            {
+                for (auto &sec : *map_)
+                {
+                    for (auto &item : sec.second)
+                    {
+                        cache_.emplace(std::piecewise_construct, std::forward_as_tuple(item.second), std::forward_as_tuple());
+                    }
+                }
+                cache_filled_.store(true, std::memory_order_release);
+            }
+        }
+
+        if (cache_.end() == (iter = cache_.find(value)))
+            throw std::logic_error(std::string("INI configuration value not synced: ") + value);
+
+        typed_entry_t &entry = iter->second;
+
+        std::call_once(entry.parsing, [&entry, value]{ entry.typed = parse_all(value); });
+
+        return entry.typed;
+    }
+
+    static void check_parsed(const char *value, const typed_value_t &typed, unsigned char type_flag, const char *type_desc)
+    {
+        if (!(typed.parsed & type_flag))
+            throw_invalid(value, type_desc);
+        if (typed.overflowed & type_flag)
+            throw std::out_of_range(std::string("INI configuration value out of range: ") + value);
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, T>::type
+    parse_as(const char *value, const typed_value_t &typed, type_tag_t<T>)
+    {
+        check_parsed(value, typed, PARSED_INTEGER, "an integer");
+        if (typed.integer < (long long)std::numeric_limits<T>::min() || typed.integer > (long long)std::numeric_limits<T>::max())
+            throw std::out_of_range(std::string("INI configuration value out of range: ") + value);
+
+        return (T)typed.integer;
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value
+        && !std::is_same<T, bool>::value, T>::type
+    parse_as(const char *value, const typed_value_t &typed, type_tag_t<T>)
+    {
+        check_parsed(value, typed, PARSED_INTEGER, "an integer");
+        if (typed.integer < 0 || (unsigned long long)typed.integer > (unsigned long long)std::numeric_limits<T>::max())
+            throw std::out_of_range(std::string("INI configuration value out of range: ") + value);
+
+        return (T)typed.integer;
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value, T>::type
+    parse_as(const char *value, const typed_value_t &typed, type_tag_t<T>)
+    {
+        check_parsed(value, typed, PARSED_REAL, "a number");
+
+        return (T)typed.real;
+    }
+
+    static bool parse_as(const char *value, const typed_value_t &typed, type_tag_t<bool>)
+    {
+        check_parsed(value, typed, PARSED_BOOLEAN, "a boolean");
+
+        return typed.boolean;
+    }
+
+    template<typename R, typename P>
+    static std::chrono::duration<R, P> parse_as(const char *value, const typed_value_t &typed,
+        type_tag_t<std::chrono::duration<R, P> >)
+    {
+        check_parsed(value, typed, PARSED_DURATION, "a duration");
+
+        return std::chrono::duration_cast<std::chrono::duration<R, P> >(std::chrono::nanoseconds(typed.nanoseconds));
+    }
+
+    int resync_all(void)
+    {
+        map_->clear();
+        uncache_all();
+        seq_ = ini_changes_seq(doc_);
+        ini_changes_clear(doc_);
+        err_ = ini_traverse_all_nodes(doc_, save_node_into_map, map_).error_code;
+
+        return err_;
+    }
+
+    void sync_section(const char *name)
+    {
+        section_map_t::iterator iter = map_->find(name);
+        ini_node_t *sec = ini_section_find(doc_, name, 0);
+
+        if (map_->end() != iter)
+        {
+            uncache_items(iter->second);
+            map_->erase(iter);
+        }
+        if (nullptr == sec)
+            return;
+
+        // The key must point to the current name in the document, not the one in the change record.
+        iter = map_->insert(std::make_pair(ini_section_get_name(sec), cstr_map_c())).first;
+        ini_traverse_nodes_of(sec, save_node_into_map, map_);
+        cache_items(iter->second);
+    }
+
+    void sync_item(const char *sec_name, const char *key)
+    {
+        section_map_t::iterator iter = map_->find(sec_name);
+        ini_node_t *sec = ini_section_find(doc_, sec_name, 0);
+        ini_node_t *item = nullptr;
+        cstr_map_c::iterator old_item;
+
+        if (map_->end() == iter || nullptr == sec)
+            return; // Handled by the record of the section.
+
+        if (iter->second.end() != (old_item = iter->second.find(key)))
+        {
+            cache_.erase(old_item->second);
+            iter->second.erase(old_item);
+        }
+        if (nullptr != (item = ini_item_find(sec, key, 0)))
+        {
+            iter->second.insert(std::make_pair(ini_item_get_key(item), ini_item_get_value(item)));
+            cache_item(ini_item_get_value(item));
+        }
+    }
+
     static int save_node_into_map(const char *section, ini_node_t *cur_node, void *map)
     {
         section_map_t *sec_map = (section_map_t *)map;
@@ -309,6 +760,10 @@ private:
     char *dir_;
     char *basename_;
     section_map_t *map_;
+    unsigned long seq_;
+    mutable std::mutex cache_mutex_; /* Taken only to fill the cache on the first typed access. */
+    mutable std::atomic<bool> cache_filled_;
+    mutable typed_cache_t cache_; /* Filled and parsed by const member functions as above, and changed only by others. */
 };
 
 #endif /* #ifndef __INLINE_INI_MAP_HPP__ */
@@ -347,5 +802,18 @@ private:
  *
  * >>> 2022-09-04, Man Hung-Coeng:
  *  01. Replace the header <exception> with <stdexcept>.
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Make sync() re-sync only the changed sections and items
+ *      according to the change records of the document.
+ *  02. Add typed accessors get<T>() and get_size() with a cache
+ *      of parsed values which is invalidated by sync().
+ *  03. Turn change tracking of the document off on destruction.
+ *  04. Parse values for typed accessors on construction and by sync()
+ *      instead of on first access, to keep const member functions thread-safe.
+ *  05. Leave change tracking on for other maps of the same document on destruction.
+ *  06. Parse a value for typed accessors on its first typed access, once with std::call_once(),
+ *      instead of parsing all values on construction and by sync().
+ *  07. Pass characters to <ctype.h> functions as unsigned char.
  */
 
@@ -0,0 +1,440 @@
+/*
+ * Watcher of an INI file which re-parses it after changes settle down.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "ini_watcher.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum
+{
+    INI_WATCHER_ERR_UNKNOWN = 1
+    , INI_WATCHER_ERR_NOT_SUPPORTED
+    , INI_WATCHER_ERR_MEM_ALLOC
+    , INI_WATCHER_ERR_INVALID_PATH
+
+    , INI_WATCHER_ERR_END /* NOTE: All error codes should be defined ahead of this. */
+};
+
+static const char* const S_ERRORS[] = {
+    "Unknown error"
+    , "Not supported"
+    , "Failed to allocate memory"
+    , "Invalid path"
+};
+
+const char* ini_watcher_error(int error_code)
+{
+    if (error_code >= 0)
+        return "OK";
+
+    if (error_code <= -INI_WATCHER_ERR_END)
+        return strerror(-error_code - INI_WATCHER_ERR_END);
+
+    return S_ERRORS[-error_code - 1];
+}
+
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+
+#define INI_WATCHER_EVENTS      (IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_MODIFY)
+
+struct ini_watcher_t
+{
+    int fd;
+    int wd;
+    char *path;
+    const char *basename; /* Points into path. */
+    int parse_options;
+    int debounce_ms;
+    ini_watcher_callback_t cb;
+    void *cb_arg;
+};
+
+ini_watcher_t* ini_watcher_create(const char *path, int parse_options,
+    int debounce_ms, ini_watcher_callback_t cb, void *cb_arg, int *nullable_error)
+{
+    size_t path_len = (NULL == path) ? 0 : strlen(path);
+    ini_watcher_t *watcher = NULL;
+    char *slash = NULL;
+    int err = 0;
+
+    if (0 == path_len || '/' == path[path_len - 1] || NULL == cb)
+    {
+        err = -INI_WATCHER_ERR_INVALID_PATH;
+        goto CREATE_END;
+    }
+
+    if (NULL == (watcher = (ini_watcher_t *)calloc(1, sizeof(ini_watcher_t) + path_len + 1)))
+    {
+        err = -INI_WATCHER_ERR_MEM_ALLOC;
+        goto CREATE_END;
+    }
+
+    watcher->fd = -1;
+    watcher->path = (char *)(watcher + 1);
+    memcpy(watcher->path, path, path_len + 1);
+    watcher->parse_options = parse_options;
+    watcher->debounce_ms = (debounce_ms < 0) ? 0 : debounce_ms;
+    watcher->cb = cb;
+    watcher->cb_arg = cb_arg;
+
+    if ((watcher->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0)
+    {
+        err = -(errno + INI_WATCHER_ERR_END);
+        goto CREATE_END;
+    }
+
+    if (NULL == (slash = strrchr(watcher->path, '/')))
+    {
+        watcher->basename = watcher->path;
+        watcher->wd = inotify_add_watch(watcher->fd, ".", INI_WATCHER_EVENTS);
+    }
+    else if (slash == watcher->path)
+    {
+        watcher->basename = slash + 1;
+        watcher->wd = inotify_add_watch(watcher->fd, "/", INI_WATCHER_EVENTS);
+    }
+    else
+    {
+        *slash = '\0'; /* Temporarily turns the path into the directory. */
+        watcher->wd = inotify_add_watch(watcher->fd, watcher->path, INI_WATCHER_EVENTS);
+        *slash = '/';
+        watcher->basename = slash + 1;
+    }
+
+    if (watcher->wd < 0)
+        err = -(errno + INI_WATCHER_ERR_END);
+
+CREATE_END:
+
+    if (NULL != nullable_error)
+        *nullable_error = err;
+
+    if (err < 0)
+    {
+        ini_watcher_destroy(watcher);
+
+        return NULL;
+    }
+
+    return watcher;
+}
+
+void ini_watcher_destroy(ini_watcher_t *watcher)
+{
+    if (NULL == watcher)
+        return;
+
+    if (watcher->fd >= 0)
+        close(watcher->fd); /* Watches are removed along with it. */
+
+    free(watcher);
+}
+
+int ini_watcher_fd(const ini_watcher_t *watcher)
+{
+    return watcher->fd;
+}
+
+enum
+{
+    WAIT_TIMED_OUT = 0
+    , WAIT_TOUCHED
+    , WAIT_IRRELEVANT /* Only events of other files in the directory, or an interruption */
+};
+
+static unsigned long __now_ms(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (unsigned long)now.tv_sec * 1000UL + now.tv_nsec / 1000000L;
+}
+
+/* Returns one of WAIT_*, or a negative error code. */
+static int __wait_for_changes(ini_watcher_t *watcher, int timeout_ms)
+{
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct pollfd pfd;
+    int changed = WAIT_IRRELEVANT;
+    int ret;
+
+    pfd.fd = watcher->fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    if ((ret = poll(&pfd, 1, timeout_ms)) <= 0)
+    {
+        if (0 == ret)
+            return WAIT_TIMED_OUT;
+
+        return (EINTR == errno) ? WAIT_IRRELEVANT : -(errno + INI_WATCHER_ERR_END);
+    }
+
+    while ((ret = read(watcher->fd, buf, sizeof(buf))) > 0)
+    {
+        char *pos = buf;
+
+        while (pos < buf + ret)
+        {
+            const struct inotify_event *event = (const struct inotify_event *)pos;
+
+            if ((event->mask & IN_Q_OVERFLOW)
+                || (event->wd == watcher->wd && event->len > 0 && 0 == strcmp(event->name, watcher->basename)))
+                changed = WAIT_TOUCHED;
+
+            pos += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    if (ret < 0 && EAGAIN != errno && EWOULDBLOCK != errno && EINTR != errno)
+        return -(errno + INI_WATCHER_ERR_END);
+
+    return changed;
+}
+
+/*
+ * Waits until the file is touched, or timeout_ms milliseconds (negative for infinity) pass
+ * no matter how many irrelevant events come meanwhile.
+ * Returns WAIT_TOUCHED, WAIT_TIMED_OUT, or a negative error code.
+ */
+static int __wait_for_touch(ini_watcher_t *watcher, int timeout_ms)
+{
+    unsigned long begin_ms = __now_ms();
+    int remaining_ms = timeout_ms;
+    int ret;
+
+    while (WAIT_IRRELEVANT == (ret = __wait_for_changes(watcher, remaining_ms)))
+    {
+        unsigned long elapsed_ms = __now_ms() - begin_ms;
+
+        if (timeout_ms < 0)
+            continue;
+
+        if (elapsed_ms >= (unsigned long)timeout_ms)
+            return WAIT_TIMED_OUT;
+
+        remaining_ms = timeout_ms - (int)elapsed_ms;
+    }
+
+    return ret;
+}
+
+int ini_watcher_process(ini_watcher_t *watcher, int timeout_ms)
+{
+    ini_summary_t summary = { 0 };
+    ini_doc_t *doc = NULL;
+    FILE *stream = NULL;
+    int ret = __wait_for_touch(watcher, timeout_ms);
+
+    if (ret <= 0)
+        return ret;
+
+    /*
+     * Editors and deployment tools usually write a file several times in a burst,
+     * so wait until it's been quiet for a whole debounce_ms before parsing it.
+     * Events of other files (e.g., swap or backup files of editors) don't count.
+     */
+    while (WAIT_TOUCHED == (ret = __wait_for_touch(watcher, watcher->debounce_ms)))
+        ;
+
+    if (ret < 0)
+        return ret;
+
+    if (NULL == (stream = fopen(watcher->path, "r")))
+    {
+        /* If removed or renamed away, it will be parsed after being created again. */
+        return (ENOENT == errno) ? 0 : -(errno + INI_WATCHER_ERR_END);
+    }
+
+    doc = ini_parse_from_stream(stream, watcher->parse_options, &summary);
+    fclose(stream);
+
+    watcher->cb(doc, &summary, watcher->cb_arg);
+
+    return 1;
+}
+
+#else /* Not Linux */
+
+ini_watcher_t* ini_watcher_create(const char *path, int parse_options,
+    int debounce_ms, ini_watcher_callback_t cb, void *cb_arg, int *nullable_error)
+{
+    if (NULL != nullable_error)
+        *nullable_error = -INI_WATCHER_ERR_NOT_SUPPORTED;
+
+    return NULL;
+}
+
+void ini_watcher_destroy(ini_watcher_t *watcher)
+{
+}
+
+int ini_watcher_fd(const ini_watcher_t *watcher)
+{
+    return -INI_WATCHER_ERR_NOT_SUPPORTED;
+}
+
+int ini_watcher_process(ini_watcher_t *watcher, int timeout_ms)
+{
+    return -INI_WATCHER_ERR_NOT_SUPPORTED;
+}
+
+#endif /* #if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__) */
+
+#ifdef TEST
+
+#include <stdio.h>
+#include <sys/wait.h>
+
+typedef struct test_result_t
+{
+    int calls;
+    char value[32];
+} test_result_t;
+
+static void on_reload(ini_doc_t *nullable_doc, const ini_summary_t *summary, void *cb_arg)
+{
+    test_result_t *result = (test_result_t *)cb_arg;
+    ini_node_t *sec = (NULL == nullable_doc) ? NULL : ini_section_find(nullable_doc, "test", 0);
+    ini_node_t *item = (NULL == sec) ? NULL : ini_item_find(sec, "value", 0);
+
+    result->calls += 1;
+    strcpy(result->value, (NULL == item) ? ini_error(summary->error_code) : ini_item_get_value(item));
+    printf("Callback[%d]: %s\n", result->calls, result->value);
+    ini_destroy(nullable_doc);
+}
+
+static int write_file(const char *path, const char *value)
+{
+    FILE *stream = fopen(path, "w");
+
+    if (NULL == stream)
+        return -1;
+
+    fprintf(stream, "[test]\n");
+    fflush(stream); /* Makes an extra write to be debounced. */
+    fprintf(stream, "value = %s\n", value);
+
+    return fclose(stream);
+}
+
+int main(int argc, char **argv)
+{
+    const char *PATH = "ini_watcher_test.ini";
+    const char *TMP_PATH = "ini_watcher_test.ini.tmp";
+    test_result_t result = { 0 };
+    pid_t child = -1;
+    int err = 0;
+    ini_watcher_t *watcher = ini_watcher_create(PATH, INI_PARSE_STRIP_BLANKS, 50, on_reload, &result, &err);
+
+    if (NULL == watcher)
+    {
+        fprintf(stderr, "ini_watcher_create() failed: %s\n", ini_watcher_error(err));
+
+        return -1;
+    }
+
+    if (write_file(PATH, "first") < 0 || write_file(PATH, "second") < 0 || write_file(PATH, "third") < 0)
+        goto TEST_END;
+    if ((err = ini_watcher_process(watcher, 1000)) < 0 || 1 != result.calls || 0 != strcmp(result.value, "third"))
+    {
+        fprintf(stderr, "A burst of writes should lead to one reload of the last content: %s\n", ini_watcher_error(err));
+        goto TEST_END;
+    }
+
+    if (write_file(TMP_PATH, "renamed") < 0 || rename(TMP_PATH, PATH) < 0)
+        goto TEST_END;
+    if ((err = ini_watcher_process(watcher, 1000)) < 0 || 2 != result.calls || 0 != strcmp(result.value, "renamed"))
+    {
+        fprintf(stderr, "Replacing by rename() should lead to a reload: %s\n", ini_watcher_error(err));
+        goto TEST_END;
+    }
+
+    if (write_file(TMP_PATH, "ignored") < 0 || 0 != (err = ini_watcher_process(watcher, 100)) || 2 != result.calls)
+    {
+        fprintf(stderr, "Changes of other files in the directory should be ignored: %s\n", ini_watcher_error(err));
+        goto TEST_END;
+    }
+
+    /* Nor should they end the wait or the debouncing early, e.g., writes of swap files of an editor. */
+    ini_watcher_destroy(watcher);
+    if (NULL == (watcher = ini_watcher_create(PATH, INI_PARSE_STRIP_BLANKS, 200, on_reload, &result, &err)))
+        goto TEST_END;
+    if (0 == (child = fork()))
+    {
+        usleep(50 * 1000);
+        write_file(TMP_PATH, "swap");
+        usleep(50 * 1000);
+        write_file(PATH, "early");
+        usleep(100 * 1000);
+        write_file(TMP_PATH, "swap");
+        usleep(80 * 1000);
+        write_file(PATH, "late");
+        _exit(0);
+    }
+    err = (child < 0) ? -1 : ini_watcher_process(watcher, 1000);
+    if (child > 0)
+        waitpid(child, NULL, 0);
+    if (err < 0 || 3 != result.calls || 0 != strcmp(result.value, "late"))
+    {
+        fprintf(stderr, "Changes of other files should neither end the wait nor the debouncing: %s\n",
+            ini_watcher_error(err));
+        goto TEST_END;
+    }
+
+    printf("All tests passed.\n");
+
+TEST_END:
+
+    remove(TMP_PATH);
+    remove(PATH);
+    ini_watcher_destroy(watcher);
+
+    return (3 == result.calls) ? 0 : -1;
+}
+
+#endif /* #ifdef TEST */
+
+#ifdef __cplusplus
+}
+#endif
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. Keep waiting and debouncing for the rest of the time on events of other files,
+ *      and finish debouncing only after a whole debounce_ms without events of the file.
+ */
+
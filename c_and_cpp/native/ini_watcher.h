@@ -0,0 +1,75 @@
+/*
+ * Watcher of an INI file which re-parses it after changes settle down.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __INI_WATCHER_H__
+#define __INI_WATCHER_H__
+
+#include "ini_file.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ini_watcher_t ini_watcher_t;
+
+/*
+ * The callback takes the ownership of the document, and the document is NULL
+ * if the file failed to be parsed, in which case the summary tells the reason.
+ */
+typedef void (*ini_watcher_callback_t)(ini_doc_t *nullable_doc, const ini_summary_t *summary, void *cb_arg);
+
+const char* ini_watcher_error(int error_code);
+
+/*
+ * The directory of the file is watched instead of the file itself,
+ * so that the file can be replaced (e.g., by an editor or a rename()),
+ * or even not exist until later.
+ * Changes are considered settled down after no more of them
+ * come within debounce_ms milliseconds.
+ */
+ini_watcher_t* ini_watcher_create(const char *path, int parse_options/* = 0 or INI_PARSE_* flags */,
+    int debounce_ms, ini_watcher_callback_t cb, void *cb_arg, int *nullable_error);
+
+void ini_watcher_destroy(ini_watcher_t *watcher);
+
+/* For integrating the watcher into an external event loop: call ini_watcher_process() when it's readable. */
+int ini_watcher_fd(const ini_watcher_t *watcher);
+
+/*
+ * Waits at most timeout_ms milliseconds (negative for infinity) for changes,
+ * debounces them, then re-parses the file and calls the callback.
+ * Returns 1 if the callback was called, 0 on timeout, or a negative error code.
+ * It's supposed to be called in a loop of a dedicated thread, off the hot path.
+ */
+int ini_watcher_process(ini_watcher_t *watcher, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __INI_WATCHER_H__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ */
+
@@ -133,6 +133,15 @@ int sleep_microseconds_fully(int microseconds)
     return (0 == return_value) ? 0 : -errno;
 }
 
+double monotonic_milliseconds(void)
+{
+    struct timespec now = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
 #ifdef TEST
 
 #include <stdio.h>
@@ -157,5 +166,8 @@ int main(int argc, char **argv)
  *
  * >>> 2022-01-07, Man Hung-Coeng:
  *  01. Create.
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Add monotonic_milliseconds().
  */
 
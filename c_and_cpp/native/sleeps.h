@@ -34,6 +34,9 @@ int sleep_milliseconds_fully(int milliseconds);
 int sleep_microseconds(int microseconds);
 int sleep_microseconds_fully(int microseconds);
 
+/* Milliseconds on a monotonic clock with sub-millisecond precision, only meaningful as intervals. */
+double monotonic_milliseconds(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -47,6 +50,9 @@ int sleep_microseconds_fully(int microseconds);
  *
  * >>> 2022-01-07, Man Hung-Coeng:
  *  01. Create.
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Add monotonic_milliseconds() for timing of tests and benchmarks.
  */
 
 
@@ -0,0 +1,589 @@
+/*
+ * Group of SO_REUSEPORT listeners, each accepting connections in its own worker thread
+ * with its own event loop, so that there's no accept lock shared among workers.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "sock_acceptor.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <linux/filter.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum
+{
+    SOCK_ACCEPTOR_ERR_UNKNOWN = 1
+    , SOCK_ACCEPTOR_ERR_NOT_SUPPORTED
+    , SOCK_ACCEPTOR_ERR_MEM_ALLOC
+    , SOCK_ACCEPTOR_ERR_INVALID_PARAM
+    , SOCK_ACCEPTOR_ERR_EVENT_LOOP
+    , SOCK_ACCEPTOR_ERR_THREAD
+
+    , SOCK_ACCEPTOR_ERR_END /* NOTE: All error codes should be defined ahead of this. */
+};
+
+static const char* const S_ERRORS[] = {
+    "Unknown error"
+    , "Not supported"
+    , "Failed to allocate memory"
+    , "Invalid parameter"
+    , "Event loop failure"
+    , "Failed to create a worker thread"
+};
+
+const char* sock_acceptor_error(int error_code)
+{
+    if (error_code >= 0)
+        return "OK";
+
+    if (error_code <= -SOCK_ACCEPTOR_ERR_END)
+        return strerror(-error_code - SOCK_ACCEPTOR_ERR_END);
+
+    return S_ERRORS[-error_code - 1];
+}
+
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+
+static int __cpu_count(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (count > 0) ? (int)count : 1;
+}
+
+/* Returns (CPU % count) of the one handling the incoming packet as the index of the listener. */
+static int __attach_cpu_bpf(int fd, int count)
+{
+    struct sock_filter code[3];
+    struct sock_fprog prog;
+
+    memset(code, 0, sizeof(code));
+    code[0].code = BPF_LD | BPF_W | BPF_ABS;
+    code[0].k = SKF_AD_OFF + SKF_AD_CPU;
+    code[1].code = BPF_ALU | BPF_MOD | BPF_K;
+    code[1].k = count;
+    code[2].code = BPF_RET | BPF_A;
+    prog.len = sizeof(code) / sizeof(code[0]);
+    prog.filter = code;
+
+    return setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog));
+}
+
+int sock_listener_group_open(const struct sockaddr *addr, size_t addr_len, int backlog,
+    int count, int steering, int *fds)
+{
+    struct sockaddr_storage bound_addr;
+    socklen_t bound_len = sizeof(bound_addr);
+    int cpu_count = __cpu_count();
+    int opened = 0;
+    int err = 0;
+    int i;
+
+    if (NULL == addr || addr_len > sizeof(bound_addr) || count <= 0 || NULL == fds
+        || steering < SOCK_STEER_HASH || steering > SOCK_STEER_CPU_BPF)
+        return -SOCK_ACCEPTOR_ERR_INVALID_PARAM;
+
+    memcpy(&bound_addr, addr, addr_len);
+    bound_len = addr_len;
+    for (i = 0; i < count && 0 == err; ++i)
+    {
+        const int ENABLED = 1;
+        int cpu = i % cpu_count;
+
+        if ((fds[i] = socket(addr->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0)
+        {
+            err = -(errno + SOCK_ACCEPTOR_ERR_END);
+            break;
+        }
+        ++opened;
+
+        if (setsockopt(fds[i], SOL_SOCKET, SO_REUSEADDR, &ENABLED, sizeof(ENABLED)) < 0
+            || setsockopt(fds[i], SOL_SOCKET, SO_REUSEPORT, &ENABLED, sizeof(ENABLED)) < 0
+            || (SOCK_STEER_INCOMING_CPU == steering && setsockopt(fds[i], SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(cpu)) < 0)
+            || (SOCK_STEER_CPU_BPF == steering && 0 == i && __attach_cpu_bpf(fds[i], count) < 0) /* Applies to the group. */
+            || bind(fds[i], (struct sockaddr *)&bound_addr, bound_len) < 0
+            || (0 == i && getsockname(fds[i], (struct sockaddr *)&bound_addr, &bound_len) < 0) /* In case of port 0 */
+            || listen(fds[i], backlog) < 0) /* A listener joins the group on listening, which decides its index. */
+        {
+            err = (ENOPROTOOPT == errno) ? -SOCK_ACCEPTOR_ERR_NOT_SUPPORTED : -(errno + SOCK_ACCEPTOR_ERR_END);
+        }
+    }
+
+    if (err < 0)
+        sock_listener_group_close(fds, opened);
+
+    return err;
+}
+
+void sock_listener_group_close(const int *fds, int count)
+{
+    int i;
+
+    for (i = 0; i < count; ++i)
+    {
+        close(fds[i]);
+    }
+}
+
+#ifndef SOCK_ACCEPT_RETRY_MS
+#define SOCK_ACCEPT_RETRY_MS    100 /* Delay of accepting again after running out of fds or memory. */
+#endif
+
+typedef struct acceptor_worker_t
+{
+    sock_acceptor_t *acceptor;
+    int index;
+    int listen_fd;
+    int cpu; /* -1 if not pinned */
+    bool started;
+    pthread_t tid;
+    sock_reactor_t *reactor;
+    sock_timer_t retry_timer;
+    size_t accepted;
+} acceptor_worker_t;
+
+struct sock_acceptor_t
+{
+    sock_acceptor_callback_t on_accept;
+    void *cb_arg;
+    int worker_count;
+    int *listen_fds;
+    acceptor_worker_t *workers;
+};
+
+/* Accepts until EAGAIN as required by edge triggering. */
+static void __on_listener_readable(sock_reactor_t *reactor, int fd, int events, void *cb_arg)
+{
+    acceptor_worker_t *worker = (acceptor_worker_t *)cb_arg;
+
+    for (;;)
+    {
+        int client_fd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (client_fd < 0)
+        {
+            /*
+             * Pending connections are left in the backlog without any more edge to report them,
+             * so out of resources, accepting is retried later by a timer.
+             */
+            if (EMFILE == errno || ENFILE == errno || ENOBUFS == errno || ENOMEM == errno)
+                sock_reactor_start_timer(reactor, &worker->retry_timer, SOCK_ACCEPT_RETRY_MS);
+
+            /* Other errors are of the connection itself (e.g., aborted). */
+            if (SOCK_SHOULD_TRY_LATER(errno) || (EINTR != errno && ECONNABORTED != errno))
+                break;
+
+            continue;
+        }
+
+        __atomic_add_fetch(&worker->accepted, 1, __ATOMIC_RELAXED);
+        worker->acceptor->on_accept(reactor, worker->index, client_fd, worker->acceptor->cb_arg);
+    }
+}
+
+static void __on_retry_timer(sock_reactor_t *reactor, sock_timer_t *timer, void *cb_arg)
+{
+    acceptor_worker_t *worker = (acceptor_worker_t *)cb_arg;
+
+    __on_listener_readable(reactor, worker->listen_fd, SOCK_STATUS_READABLE, worker);
+}
+
+static void* __worker_thread(void *arg)
+{
+    acceptor_worker_t *worker = (acceptor_worker_t *)arg;
+
+    if (worker->cpu >= 0)
+    {
+        cpu_set_t cpus;
+
+        CPU_ZERO(&cpus);
+        CPU_SET(worker->cpu, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus); /* Just less efficient on failure. */
+    }
+
+    sock_reactor_run(worker->reactor);
+
+    return NULL;
+}
+
+sock_acceptor_t* sock_acceptor_start(const sock_acceptor_config_t *config, int *nullable_error)
+{
+    sock_acceptor_t *acceptor = NULL;
+    int count = (config->worker_count > 0) ? config->worker_count : __cpu_count();
+    int err = 0;
+    int i;
+
+    if (NULL == config->on_accept)
+    {
+        err = -SOCK_ACCEPTOR_ERR_INVALID_PARAM;
+        goto START_END;
+    }
+
+    if (NULL == (acceptor = (sock_acceptor_t *)calloc(1, sizeof(sock_acceptor_t)))
+        || NULL == (acceptor->listen_fds = (int *)malloc(sizeof(int) * count))
+        || NULL == (acceptor->workers = (acceptor_worker_t *)calloc(count, sizeof(acceptor_worker_t))))
+    {
+        err = -SOCK_ACCEPTOR_ERR_MEM_ALLOC;
+        goto START_END;
+    }
+    acceptor->on_accept = config->on_accept;
+    acceptor->cb_arg = config->cb_arg;
+
+    if ((err = sock_listener_group_open(config->addr, config->addr_len, config->backlog, count, config->steering,
+        acceptor->listen_fds)) < 0)
+        goto START_END;
+    acceptor->worker_count = count; /* Tells sock_acceptor_stop() the listeners are open. */
+
+    for (i = 0; i < count; ++i)
+    {
+        acceptor_worker_t *worker = &acceptor->workers[i];
+
+        worker->acceptor = acceptor;
+        worker->index = i;
+        worker->listen_fd = acceptor->listen_fds[i];
+        worker->cpu = config->pin_workers ? (i % __cpu_count()) : -1;
+        sock_timer_init(&worker->retry_timer, __on_retry_timer, worker);
+        if (NULL == (worker->reactor = sock_reactor_create(0, NULL))
+            || sock_reactor_add(worker->reactor, worker->listen_fd, SOCK_STATUS_READABLE, __on_listener_readable, worker) < 0)
+        {
+            err = -SOCK_ACCEPTOR_ERR_EVENT_LOOP;
+            goto START_END;
+        }
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        if (0 != pthread_create(&acceptor->workers[i].tid, NULL, __worker_thread, &acceptor->workers[i]))
+        {
+            err = -SOCK_ACCEPTOR_ERR_THREAD;
+            goto START_END;
+        }
+        acceptor->workers[i].started = true;
+    }
+
+START_END:
+
+    if (NULL != nullable_error)
+        *nullable_error = err;
+
+    if (err < 0)
+    {
+        sock_acceptor_stop(acceptor);
+
+        return NULL;
+    }
+
+    return acceptor;
+}
+
+void sock_acceptor_stop(sock_acceptor_t *acceptor)
+{
+    int i;
+
+    if (NULL == acceptor)
+        return;
+
+    for (i = 0; i < acceptor->worker_count; ++i)
+    {
+        if (acceptor->workers[i].started)
+            sock_reactor_stop(acceptor->workers[i].reactor);
+    }
+
+    for (i = 0; i < acceptor->worker_count; ++i)
+    {
+        if (acceptor->workers[i].started)
+            pthread_join(acceptor->workers[i].tid, NULL);
+        sock_reactor_destroy(acceptor->workers[i].reactor);
+    }
+
+    if (acceptor->worker_count > 0)
+        sock_listener_group_close(acceptor->listen_fds, acceptor->worker_count);
+
+    free(acceptor->workers);
+    free(acceptor->listen_fds);
+    free(acceptor);
+}
+
+int sock_acceptor_worker_count(const sock_acceptor_t *acceptor)
+{
+    return acceptor->worker_count;
+}
+
+int sock_acceptor_listener(const sock_acceptor_t *acceptor, int worker_index)
+{
+    return acceptor->listen_fds[worker_index];
+}
+
+sock_reactor_t* sock_acceptor_reactor(const sock_acceptor_t *acceptor, int worker_index)
+{
+    return acceptor->workers[worker_index].reactor;
+}
+
+size_t sock_acceptor_accepted_count(const sock_acceptor_t *acceptor, int worker_index)
+{
+    return __atomic_load_n(&acceptor->workers[worker_index].accepted, __ATOMIC_RELAXED);
+}
+
+#else /* Not Linux */
+
+int sock_listener_group_open(const struct sockaddr *addr, size_t addr_len, int backlog,
+    int count, int steering, int *fds)
+{
+    return -SOCK_ACCEPTOR_ERR_NOT_SUPPORTED;
+}
+
+void sock_listener_group_close(const int *fds, int count)
+{
+}
+
+sock_acceptor_t* sock_acceptor_start(const sock_acceptor_config_t *config, int *nullable_error)
+{
+    if (NULL != nullable_error)
+        *nullable_error = -SOCK_ACCEPTOR_ERR_NOT_SUPPORTED;
+
+    return NULL;
+}
+
+void sock_acceptor_stop(sock_acceptor_t *acceptor)
+{
+}
+
+int sock_acceptor_worker_count(const sock_acceptor_t *acceptor)
+{
+    return 0;
+}
+
+int sock_acceptor_listener(const sock_acceptor_t *acceptor, int worker_index)
+{
+    return -1;
+}
+
+sock_reactor_t* sock_acceptor_reactor(const sock_acceptor_t *acceptor, int worker_index)
+{
+    return NULL;
+}
+
+size_t sock_acceptor_accepted_count(const sock_acceptor_t *acceptor, int worker_index)
+{
+    return 0;
+}
+
+#endif /* #if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__) */
+
+#ifdef TEST
+
+#include <stdio.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+
+#define WORKER_COUNT                        4
+#define CONNECTION_COUNT                    400
+
+/* Tells the client which worker accepted it, with one byte. */
+static void on_accept(sock_reactor_t *reactor, int worker_index, int client_fd, void *cb_arg)
+{
+    char byte = (char)worker_index;
+
+    if (write(client_fd, &byte, 1) != 1)
+        __atomic_add_fetch((int *)cb_arg, 1, __ATOMIC_RELAXED);
+    close(client_fd);
+}
+
+static int run_test(int steering, const char *name)
+{
+    int failures = 0;
+    sock_acceptor_config_t config;
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    size_t tally[WORKER_COUNT] = { 0 };
+    sock_acceptor_t *acceptor = NULL;
+    cpu_set_t old_cpus, cpus;
+    int err = 0;
+    int i;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    memset(&config, 0, sizeof(config));
+    config.addr = (struct sockaddr *)&addr;
+    config.addr_len = sizeof(addr);
+    config.backlog = CONNECTION_COUNT;
+    config.worker_count = WORKER_COUNT;
+    config.steering = steering;
+    config.pin_workers = (SOCK_STEER_HASH != steering);
+    config.on_accept = on_accept;
+    config.cb_arg = &failures;
+    if (NULL == (acceptor = sock_acceptor_start(&config, &err)))
+    {
+        printf("[%s] Skipped: %s\n", name, sock_acceptor_error(err));
+
+        return (-SOCK_ACCEPTOR_ERR_NOT_SUPPORTED == err) ? 0 : -1;
+    }
+    getsockname(sock_acceptor_listener(acceptor, 0), (struct sockaddr *)&addr, &addr_len);
+
+    /* Connects from CPU 0 only, so that CPU steering is predictable. */
+    pthread_getaffinity_np(pthread_self(), sizeof(old_cpus), &old_cpus);
+    CPU_ZERO(&cpus);
+    CPU_SET(0, &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    for (i = 0; i < CONNECTION_COUNT && 0 == failures; ++i)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        unsigned char byte = 0xff;
+
+        if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0
+            || read(fd, &byte, 1) != 1 || byte >= WORKER_COUNT)
+            failures += 1;
+        else
+            tally[byte] += 1;
+
+        if (fd >= 0)
+            close(fd);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(old_cpus), &old_cpus);
+
+    printf("[%s] Connections accepted by each worker:", name);
+    for (i = 0; i < WORKER_COUNT; ++i)
+    {
+        printf(" %lu", (unsigned long)tally[i]);
+        if (tally[i] != sock_acceptor_accepted_count(acceptor, i))
+            failures += 1;
+    }
+    printf("\n");
+    sock_acceptor_stop(acceptor);
+
+    if (SOCK_STEER_CPU_BPF == steering && CONNECTION_COUNT != tally[0])
+        failures += 1;
+
+    if (failures)
+        fprintf(stderr, "[%s] %d failures\n", name, failures);
+
+    return failures ? -1 : 0;
+}
+
+/* A connection left in the backlog on EMFILE must be accepted once fds are available, without new ones coming. */
+static int run_fd_exhaustion_test(void)
+{
+    const int FD_LIMIT = 64;
+    int fillers[64];
+    int filler_count = 0;
+    int failures = 0;
+    sock_acceptor_config_t config;
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    sock_acceptor_t *acceptor = NULL;
+    struct rlimit old_limit, limit;
+    struct pollfd pfd;
+    unsigned char byte = 0xff;
+    int client_fd = -1;
+    int fd;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    memset(&config, 0, sizeof(config));
+    config.addr = (struct sockaddr *)&addr;
+    config.addr_len = sizeof(addr);
+    config.backlog = 8;
+    config.worker_count = 1;
+    config.on_accept = on_accept;
+    config.cb_arg = &failures;
+    if (getrlimit(RLIMIT_NOFILE, &old_limit) < 0 || NULL == (acceptor = sock_acceptor_start(&config, NULL))
+        || (client_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0)
+    {
+        failures += 1;
+        goto TEST_END;
+    }
+    getsockname(sock_acceptor_listener(acceptor, 0), (struct sockaddr *)&addr, &addr_len);
+
+    limit = old_limit;
+    limit.rlim_cur = (old_limit.rlim_cur < (rlim_t)FD_LIMIT) ? old_limit.rlim_cur : (rlim_t)FD_LIMIT;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    while (filler_count < (int)(sizeof(fillers) / sizeof(fillers[0])) && (fd = dup(client_fd)) >= 0)
+    {
+        fillers[filler_count++] = fd;
+    }
+
+    pfd.fd = client_fd;
+    pfd.events = POLLIN;
+    if (connect(client_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || 0 != poll(&pfd, 1, 2 * SOCK_ACCEPT_RETRY_MS))
+        failures += 1; /* Not accepted while fds are used up. */
+
+    while (filler_count > 0)
+    {
+        close(fillers[--filler_count]);
+    }
+    setrlimit(RLIMIT_NOFILE, &old_limit);
+
+    if (1 != poll(&pfd, 1, 10 * SOCK_ACCEPT_RETRY_MS) || read(client_fd, &byte, 1) != 1 || 0 != byte)
+        failures += 1;
+
+TEST_END:
+
+    while (filler_count > 0)
+    {
+        close(fillers[--filler_count]);
+    }
+    if (client_fd >= 0)
+        close(client_fd);
+    sock_acceptor_stop(acceptor);
+
+    printf("[fd exhaustion] %s\n", failures ? "Pending connection not accepted after fds were released" : "OK");
+
+    return failures ? -1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (run_test(SOCK_STEER_HASH, "hash") < 0 || run_test(SOCK_STEER_INCOMING_CPU, "incoming CPU") < 0
+        || run_test(SOCK_STEER_CPU_BPF, "CPU BPF") < 0 || run_fd_exhaustion_test() < 0)
+        return -1;
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif /* #ifdef TEST */
+
+#ifdef __cplusplus
+}
+#endif
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. Retry accepting by a timer after running out of fds or memory,
+ *      since edge triggering reports no more pending connections.
+ */
+
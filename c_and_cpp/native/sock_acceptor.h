@@ -0,0 +1,101 @@
+/*
+ * Group of SO_REUSEPORT listeners, each accepting connections in its own worker thread
+ * with its own event loop, so that there's no accept lock shared among workers.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __SOCK_ACCEPTOR_H__
+#define __SOCK_ACCEPTOR_H__
+
+#include "sock_reactor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* How the kernel picks a listener of the group for a new connection. */
+enum
+{
+    SOCK_STEER_HASH = 0 /* By the hash of addresses and ports, the default of SO_REUSEPORT. */
+    , SOCK_STEER_INCOMING_CPU /* Prefers listener i on CPU i, by SO_INCOMING_CPU (Linux 4.4+). */
+    , SOCK_STEER_CPU_BPF /* Listener (CPU % count) strictly, by a classic BPF program (Linux 4.5+). */
+};
+
+const char* sock_acceptor_error(int error_code);
+
+/*
+ * Creates count non-blocking TCP sockets listening on the same address with SO_REUSEPORT,
+ * and stores them into fds in the order of the group.
+ * If the port of addr is 0, the one picked for the first socket is shared by the others.
+ * Returns 0 on success, or a negative error code with nothing left open.
+ */
+int sock_listener_group_open(const struct sockaddr *addr, size_t addr_len, int backlog,
+    int count, int steering/* = SOCK_STEER_* */, int *fds);
+
+void sock_listener_group_close(const int *fds, int count);
+
+typedef struct sock_acceptor_t sock_acceptor_t;
+
+/*
+ * Called in the worker thread for each accepted (non-blocking) connection, which belongs to the callback then,
+ * e.g., to be added to the reactor of the worker.
+ */
+typedef void (*sock_acceptor_callback_t)(sock_reactor_t *reactor, int worker_index, int client_fd, void *cb_arg);
+
+typedef struct sock_acceptor_config_t
+{
+    const struct sockaddr *addr;
+    size_t addr_len;
+    int backlog;
+    int worker_count; /* = 0 for the number of online CPUs */
+    int steering; /* = SOCK_STEER_* */
+    bool pin_workers; /* Pins worker i to CPU (i % CPU count), which CPU steering relies on. */
+    sock_acceptor_callback_t on_accept;
+    void *cb_arg;
+} sock_acceptor_config_t;
+
+sock_acceptor_t* sock_acceptor_start(const sock_acceptor_config_t *config, int *nullable_error);
+
+/*
+ * Stops and joins all workers, and closes the listeners.
+ * Connections handed over to callbacks are left open.
+ */
+void sock_acceptor_stop(sock_acceptor_t *acceptor);
+
+int sock_acceptor_worker_count(const sock_acceptor_t *acceptor);
+
+int sock_acceptor_listener(const sock_acceptor_t *acceptor, int worker_index);
+
+/* Can be used by other threads, e.g., to wake it up or to stop it earlier. */
+sock_reactor_t* sock_acceptor_reactor(const sock_acceptor_t *acceptor, int worker_index);
+
+size_t sock_acceptor_accepted_count(const sock_acceptor_t *acceptor, int worker_index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __SOCK_ACCEPTOR_H__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ */
+
@@ -0,0 +1,1519 @@
+/*
+ * Asynchronous accept/recv/send/close of sockets with completion callbacks,
+ * backed by io_uring, or by epoll (sock_reactor) where io_uring is unavailable.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "sock_async.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+
+#include "sock_reactor.h"
+
+#if defined(__NR_io_uring_setup) && defined(IORING_RECV_MULTISHOT) /* Headers of Linux 6.0+ */
+#define SOCK_ASYNC_HAS_IO_URING
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum
+{
+    SOCK_ASYNC_ERR_UNKNOWN = 1
+    , SOCK_ASYNC_ERR_NOT_SUPPORTED
+    , SOCK_ASYNC_ERR_MEM_ALLOC
+    , SOCK_ASYNC_ERR_INVALID_PARAM
+    , SOCK_ASYNC_ERR_BUSY
+    , SOCK_ASYNC_ERR_QUEUE_FULL
+    , SOCK_ASYNC_ERR_BUFFERS_REGISTERED
+    , SOCK_ASYNC_ERR_EVENT_LOOP
+
+    , SOCK_ASYNC_ERR_END /* NOTE: All error codes should be defined ahead of this. */
+};
+
+static const char* const S_ERRORS[] = {
+    "Unknown error"
+    , "Not supported"
+    , "Failed to allocate memory"
+    , "Invalid parameter"
+    , "Another operation of the same direction is pending on the fd"
+    , "Submission queue is full"
+    , "Buffers have been registered"
+    , "Event loop failure"
+};
+
+const char* sock_async_error(int error_code)
+{
+    if (error_code >= 0)
+        return "OK";
+
+    if (error_code <= -SOCK_ASYNC_ERR_END)
+        return strerror(-error_code - SOCK_ASYNC_ERR_END);
+
+    return S_ERRORS[-error_code - 1];
+}
+
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+
+#define SOCK_ASYNC_QUEUE_DEPTH_DEFAULT      256
+#define SOCK_ASYNC_RECV_BUF_SIZE_DEFAULT    4096
+#define SOCK_ASYNC_CHUNKS_PER_TURN          16 /* Of a multishot operation with epoll, for fairness. */
+#define OP_BLOCK_SIZE                       64
+
+#define ERRNO_TO_CODE(e)                    (-((e) + SOCK_ASYNC_ERR_END))
+
+enum
+{
+    OP_ACCEPT
+    , OP_ACCEPT_MULTISHOT
+    , OP_RECV
+    , OP_RECV_MULTISHOT
+    , OP_SEND
+    , OP_CLOSE
+    , OP_CANCEL
+};
+
+typedef struct async_op_t
+{
+    struct async_op_t *next; /* In the free list, or in the ready list of epoll. */
+    int type;
+    int fd;
+    int fixed;
+    int queued; /* In the ready list of epoll. */
+    int cancelled; /* By a close or cancellation submitted later, with epoll. */
+    unsigned int buf_index;
+    char *buf;
+    size_t len;
+    sock_async_callback_t cb;
+    void *cb_arg;
+} async_op_t;
+
+typedef struct op_block_t
+{
+    struct op_block_t *next;
+    async_op_t ops[OP_BLOCK_SIZE];
+} op_block_t;
+
+#ifdef SOCK_ASYNC_HAS_IO_URING
+typedef struct uring_t
+{
+    int fd;
+    unsigned int sq_entries;
+    unsigned int sq_mask;
+    unsigned int sqe_tail; /* Local, published to *sq_tail on entering. */
+    unsigned int *sq_head;
+    unsigned int *sq_tail;
+    struct io_uring_sqe *sqes;
+    unsigned int cq_mask;
+    unsigned int *cq_head;
+    unsigned int *cq_tail;
+    struct io_uring_cqe *cqes;
+    void *sq_ptr;
+    size_t sq_size;
+    void *cq_ptr; /* Same as sq_ptr with IORING_FEAT_SINGLE_MMAP. */
+    size_t cq_size;
+    size_t sqes_size;
+    struct io_uring_buf_ring *buf_ring; /* Provided buffers of multishot recv. */
+    size_t buf_ring_size;
+} uring_t;
+#endif
+
+typedef struct fd_ops_t
+{
+    async_op_t *reader; /* accept or recv */
+    async_op_t *writer; /* send */
+    int registered;
+} fd_ops_t;
+
+struct sock_async_t
+{
+    int backend;
+    int buffers_registered;
+    unsigned int queue_depth; /* Also the count of buffers for multishot recv, a power of 2. */
+    size_t recv_buf_size;
+    char *recv_bufs;
+    async_op_t *free_ops;
+    op_block_t *op_blocks;
+#ifdef SOCK_ASYNC_HAS_IO_URING
+    uring_t ring;
+#endif
+    fd_ops_t *fds; /* Indexed by fd. */
+    size_t fd_count;
+    /* Members below are for epoll. */
+    sock_reactor_t *reactor;
+    async_op_t *ready_head; /* Operations to try without waiting for readiness. */
+    async_op_t *ready_tail;
+    int callback_count;
+};
+
+static async_op_t* __alloc_op(sock_async_t *engine)
+{
+    async_op_t *op = engine->free_ops;
+
+    if (NULL == op)
+    {
+        op_block_t *block = (op_block_t *)malloc(sizeof(op_block_t));
+        int i;
+
+        if (NULL == block)
+            return NULL;
+
+        block->next = engine->op_blocks;
+        engine->op_blocks = block;
+        for (i = OP_BLOCK_SIZE - 1; i >= 0; --i)
+        {
+            block->ops[i].next = engine->free_ops;
+            engine->free_ops = &block->ops[i];
+        }
+        op = engine->free_ops;
+    }
+    engine->free_ops = op->next;
+    memset(op, 0, sizeof(async_op_t));
+
+    return op;
+}
+
+static void __free_op(sock_async_t *engine, async_op_t *op)
+{
+    op->next = engine->free_ops;
+    engine->free_ops = op;
+}
+
+/* Returns the operations of the fd, growing the array if needed, or NULL if out of memory. */
+static fd_ops_t* __fd_ops(sock_async_t *engine, int fd)
+{
+    if ((size_t)fd >= engine->fd_count)
+    {
+        size_t count = (0 == engine->fd_count) ? 1024 : engine->fd_count;
+        fd_ops_t *fds = NULL;
+
+        while (count <= (size_t)fd)
+        {
+            count *= 2;
+        }
+
+        if (NULL == (fds = (fd_ops_t *)realloc(engine->fds, sizeof(fd_ops_t) * count)))
+            return NULL;
+
+        memset(fds + engine->fd_count, 0, sizeof(fd_ops_t) * (count - engine->fd_count));
+        engine->fds = fds;
+        engine->fd_count = count;
+    }
+
+    return &engine->fds[fd];
+}
+
+/* Detaches the operation from its fd before its last callback, which may submit another one. */
+static void __detach_op(sock_async_t *engine, async_op_t *op)
+{
+    fd_ops_t *ops = &engine->fds[op->fd];
+
+    if (ops->reader == op)
+        ops->reader = NULL;
+    else if (ops->writer == op)
+        ops->writer = NULL;
+}
+
+/*
+ * ================
+ *  IO_URING
+ * ================
+ */
+
+#ifdef SOCK_ASYNC_HAS_IO_URING
+
+#define BUF_GROUP_ID                        0
+
+static void __uring_teardown(uring_t *ring)
+{
+    if (NULL != ring->buf_ring)
+        munmap(ring->buf_ring, ring->buf_ring_size);
+    if (NULL != ring->sqes)
+        munmap(ring->sqes, ring->sqes_size);
+    if (NULL != ring->cq_ptr && ring->cq_ptr != ring->sq_ptr)
+        munmap(ring->cq_ptr, ring->cq_size);
+    if (NULL != ring->sq_ptr)
+        munmap(ring->sq_ptr, ring->sq_size);
+    if (ring->fd >= 0)
+        close(ring->fd);
+    memset(ring, 0, sizeof(uring_t));
+    ring->fd = -1;
+}
+
+/* Multishot recv arrived with Linux 6.0, same as IORING_OP_SEND_ZC which can be probed. */
+static int __uring_probe(int ring_fd)
+{
+    size_t size = sizeof(struct io_uring_probe) + sizeof(struct io_uring_probe_op) * 256;
+    struct io_uring_probe *probe = (struct io_uring_probe *)calloc(1, size);
+    int supported = 0;
+
+    if (NULL == probe)
+        return -SOCK_ASYNC_ERR_MEM_ALLOC;
+
+    if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, 256) >= 0)
+    {
+        supported = (probe->ops_len > IORING_OP_SEND_ZC
+            && (probe->ops[IORING_OP_SEND_ZC].flags & IO_URING_OP_SUPPORTED));
+    }
+    free(probe);
+
+    return supported ? 0 : -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+}
+
+static void __uring_provide_buffer(sock_async_t *engine, unsigned int bid)
+{
+    struct io_uring_buf_ring *buf_ring = engine->ring.buf_ring;
+    unsigned short tail = buf_ring->tail;
+    struct io_uring_buf *buf = &buf_ring->bufs[tail & (engine->queue_depth - 1)];
+
+    buf->addr = (uintptr_t)(engine->recv_bufs + bid * engine->recv_buf_size);
+    buf->len = engine->recv_buf_size;
+    buf->bid = bid;
+    __atomic_store_n(&buf_ring->tail, (unsigned short)(tail + 1), __ATOMIC_RELEASE);
+}
+
+static int __uring_setup(sock_async_t *engine)
+{
+    uring_t *ring = &engine->ring;
+    struct io_uring_params params;
+    struct io_uring_buf_reg reg;
+    unsigned int *sq_array;
+    unsigned int i;
+    int err;
+
+    memset(ring, 0, sizeof(uring_t));
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = engine->queue_depth * 4; /* Room for completions of multishot operations. */
+    if ((ring->fd = syscall(__NR_io_uring_setup, engine->queue_depth, &params)) < 0)
+    {
+        ring->fd = -1;
+
+        return (ENOSYS == errno || EPERM == errno) ? -SOCK_ASYNC_ERR_NOT_SUPPORTED : ERRNO_TO_CODE(errno);
+    }
+
+    if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_NODROP)
+        || (err = __uring_probe(ring->fd)) < 0)
+    {
+        err = -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+        goto SETUP_END;
+    }
+
+    ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        ring->sq_size = ring->cq_size = (ring->sq_size > ring->cq_size) ? ring->sq_size : ring->cq_size;
+    ring->sq_ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (MAP_FAILED == ring->sq_ptr)
+    {
+        ring->sq_ptr = NULL;
+        err = ERRNO_TO_CODE(errno);
+        goto SETUP_END;
+    }
+    ring->cq_ptr = (params.features & IORING_FEAT_SINGLE_MMAP) ? ring->sq_ptr
+        : mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    if (MAP_FAILED == ring->cq_ptr)
+    {
+        ring->cq_ptr = NULL;
+        err = ERRNO_TO_CODE(errno);
+        goto SETUP_END;
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe *)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (MAP_FAILED == (void *)ring->sqes)
+    {
+        ring->sqes = NULL;
+        err = ERRNO_TO_CODE(errno);
+        goto SETUP_END;
+    }
+
+    ring->sq_entries = params.sq_entries;
+    ring->sq_mask = *(unsigned int *)((char *)ring->sq_ptr + params.sq_off.ring_mask);
+    ring->sq_head = (unsigned int *)((char *)ring->sq_ptr + params.sq_off.head);
+    ring->sq_tail = (unsigned int *)((char *)ring->sq_ptr + params.sq_off.tail);
+    ring->sqe_tail = *ring->sq_tail;
+    sq_array = (unsigned int *)((char *)ring->sq_ptr + params.sq_off.array);
+    for (i = 0; i < params.sq_entries; ++i)
+    {
+        sq_array[i] = i; /* SQEs are always submitted in order. */
+    }
+    ring->cq_mask = *(unsigned int *)((char *)ring->cq_ptr + params.cq_off.ring_mask);
+    ring->cq_head = (unsigned int *)((char *)ring->cq_ptr + params.cq_off.head);
+    ring->cq_tail = (unsigned int *)((char *)ring->cq_ptr + params.cq_off.tail);
+    ring->cqes = (struct io_uring_cqe *)((char *)ring->cq_ptr + params.cq_off.cqes);
+
+    ring->buf_ring_size = sizeof(struct io_uring_buf) * engine->queue_depth;
+    ring->buf_ring = (struct io_uring_buf_ring *)mmap(NULL, ring->buf_ring_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == (void *)ring->buf_ring)
+    {
+        ring->buf_ring = NULL;
+        err = ERRNO_TO_CODE(errno);
+        goto SETUP_END;
+    }
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uintptr_t)ring->buf_ring;
+    reg.ring_entries = engine->queue_depth;
+    reg.bgid = BUF_GROUP_ID;
+    if (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+    {
+        err = (EINVAL == errno) ? -SOCK_ASYNC_ERR_NOT_SUPPORTED : ERRNO_TO_CODE(errno);
+        goto SETUP_END;
+    }
+    for (i = 0; i < engine->queue_depth; ++i)
+    {
+        __uring_provide_buffer(engine, i);
+    }
+    err = 0;
+
+SETUP_END:
+
+    if (err < 0)
+        __uring_teardown(ring);
+
+    return err;
+}
+
+static int __uring_enter(uring_t *ring, unsigned int min_complete, unsigned int flags, const void *arg, size_t arg_size)
+{
+    unsigned int to_submit = ring->sqe_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    int ret;
+
+    __atomic_store_n(ring->sq_tail, ring->sqe_tail, __ATOMIC_RELEASE);
+    if (0 == to_submit && 0 == min_complete)
+        return 0;
+
+    ret = syscall(__NR_io_uring_enter, ring->fd, to_submit, min_complete, flags, arg, arg_size);
+
+    /* Timed out or interrupted, or completions are to be reaped to make room (EBUSY). */
+    if (ret < 0 && ETIME != errno && EINTR != errno && EBUSY != errno && EAGAIN != errno)
+        return ERRNO_TO_CODE(errno);
+
+    return 0;
+}
+
+static struct io_uring_sqe* __uring_get_sqe(uring_t *ring)
+{
+    struct io_uring_sqe *sqe;
+
+    if (ring->sqe_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries)
+    {
+        __uring_enter(ring, 0, 0, NULL, 0);
+        if (ring->sqe_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries)
+            return NULL;
+    }
+
+    sqe = &ring->sqes[ring->sqe_tail & ring->sq_mask];
+    ring->sqe_tail += 1;
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+    return sqe;
+}
+
+static int __uring_submit(sock_async_t *engine, async_op_t *op)
+{
+    uring_t *ring = &engine->ring;
+    struct io_uring_sqe *sqe = __uring_get_sqe(ring);
+
+    if (NULL == sqe)
+        return -SOCK_ASYNC_ERR_QUEUE_FULL;
+
+    sqe->fd = op->fd;
+    sqe->user_data = (uintptr_t)op;
+    switch (op->type)
+    {
+    case OP_ACCEPT:
+    case OP_ACCEPT_MULTISHOT:
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+        if (OP_ACCEPT_MULTISHOT == op->type)
+            sqe->ioprio |= IORING_ACCEPT_MULTISHOT;
+        break;
+
+    case OP_RECV_MULTISHOT:
+        sqe->opcode = IORING_OP_RECV;
+        sqe->ioprio |= IORING_RECV_MULTISHOT;
+        sqe->flags |= IOSQE_BUFFER_SELECT;
+        sqe->buf_group = BUF_GROUP_ID;
+        break;
+
+    case OP_RECV:
+    case OP_SEND:
+        if (op->fixed)
+        {
+            /* Reading or writing a socket is receiving or sending without flags. */
+            sqe->opcode = (OP_RECV == op->type) ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+            sqe->buf_index = op->buf_index;
+        }
+        else
+        {
+            sqe->opcode = (OP_RECV == op->type) ? IORING_OP_RECV : IORING_OP_SEND;
+            sqe->msg_flags = (OP_SEND == op->type) ? MSG_NOSIGNAL : 0;
+        }
+        sqe->addr = (uintptr_t)op->buf;
+        sqe->len = op->len;
+        break;
+
+    case OP_CLOSE:
+        /* Pending operations hold the file, so closing the fd alone wouldn't stop them. */
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+        sqe->flags |= IOSQE_IO_HARDLINK; /* Closes even if there's nothing to cancel. */
+        sqe->user_data = 0;
+        if (NULL == (sqe = __uring_get_sqe(ring)))
+        {
+            /* The cancellation is submitted without linking, and a retry is up to the caller. */
+            ring->sqes[(ring->sqe_tail - 1) & ring->sq_mask].flags &= ~IOSQE_IO_HARDLINK;
+
+            return -SOCK_ASYNC_ERR_QUEUE_FULL;
+        }
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->fd = op->fd;
+        sqe->user_data = (uintptr_t)op;
+        break;
+
+    case OP_CANCEL:
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+        sqe->user_data = 0;
+        __free_op(engine, op);
+        break;
+
+    default:
+        return -SOCK_ASYNC_ERR_INVALID_PARAM;
+    }
+
+    return 0;
+}
+
+/* Returns the number of callbacks called. */
+static int __uring_complete(sock_async_t *engine, const struct io_uring_cqe *cqe)
+{
+    async_op_t *op = (async_op_t *)(uintptr_t)cqe->user_data;
+    int more = (cqe->flags & IORING_CQE_F_MORE);
+    const void *data = NULL;
+
+    if (NULL == op)
+        return 0; /* Completion of a cancellation request */
+
+    /* Multishot recv stops when all provided buffers are in use, and just continues here. */
+    if (OP_RECV_MULTISHOT == op->type && -ENOBUFS == cqe->res && !more && 0 == __uring_submit(engine, op))
+        return 0;
+
+    if (cqe->flags & IORING_CQE_F_BUFFER)
+        data = engine->recv_bufs + (cqe->flags >> IORING_CQE_BUFFER_SHIFT) * engine->recv_buf_size;
+    else if (cqe->res >= 0 && (OP_RECV == op->type || OP_SEND == op->type))
+        data = op->buf;
+
+    if (!more)
+        __detach_op(engine, op);
+
+    if (NULL != op->cb)
+        op->cb(engine, op->fd, (cqe->res < 0) ? ERRNO_TO_CODE(-cqe->res) : cqe->res, data, more ? SOCK_ASYNC_MORE : 0, op->cb_arg);
+
+    if (cqe->flags & IORING_CQE_F_BUFFER)
+        __uring_provide_buffer(engine, cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+
+    if (!more)
+        __free_op(engine, op);
+
+    return 1;
+}
+
+static int __uring_run_once(sock_async_t *engine, int timeout_ms)
+{
+    uring_t *ring = &engine->ring;
+    unsigned int head = *ring->cq_head;
+    int count = 0;
+    int err;
+
+    if (0 != timeout_ms && head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+    {
+        struct io_uring_getevents_arg arg;
+        struct __kernel_timespec ts;
+
+        memset(&arg, 0, sizeof(arg));
+        if (timeout_ms > 0)
+        {
+            ts.tv_sec = timeout_ms / 1000;
+            ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+            arg.ts = (uintptr_t)&ts;
+        }
+        err = __uring_enter(ring, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    }
+    else
+        err = __uring_enter(ring, 0, 0, NULL, 0);
+
+    if (err < 0)
+        return err;
+
+    while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+    {
+        struct io_uring_cqe cqe = ring->cqes[head & ring->cq_mask];
+
+        /* Released before the callback, since it's a copy and callbacks may take a while. */
+        __atomic_store_n(ring->cq_head, ++head, __ATOMIC_RELEASE);
+        count += __uring_complete(engine, &cqe);
+    }
+
+    return count;
+}
+
+#endif /* #ifdef SOCK_ASYNC_HAS_IO_URING */
+
+/*
+ * ================
+ *  EPOLL
+ * ================
+ */
+
+static void __push_ready(sock_async_t *engine, async_op_t *op)
+{
+    op->next = NULL;
+    op->queued = 1;
+    if (NULL == engine->ready_tail)
+        engine->ready_head = op;
+    else
+        engine->ready_tail->next = op;
+    engine->ready_tail = op;
+}
+
+static void __epoll_callback(sock_async_t *engine, async_op_t *op, int result, const void *data, int flags)
+{
+    if (NULL != op->cb)
+        op->cb(engine, op->fd, result, data, flags, op->cb_arg);
+    engine->callback_count += 1;
+}
+
+static void __epoll_finish(sock_async_t *engine, async_op_t *op, int result, const void *data)
+{
+    __detach_op(engine, op);
+    __epoll_callback(engine, op, result, data, 0);
+    __free_op(engine, op);
+}
+
+/* Performs the operation until it would block. Completed ones are freed. */
+static void __epoll_try(sock_async_t *engine, async_op_t *op)
+{
+    int chunks = 0;
+    ssize_t ret;
+
+    for (;;)
+    {
+        if (op->cancelled)
+            return; /* Finished by the cancellation, which may be submitted by the callback. */
+
+        switch (op->type)
+        {
+        case OP_ACCEPT:
+        case OP_ACCEPT_MULTISHOT:
+            ret = accept4(op->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            break;
+
+        case OP_RECV:
+            ret = recv(op->fd, op->buf, op->len, 0);
+            break;
+
+        case OP_RECV_MULTISHOT:
+            ret = recv(op->fd, engine->recv_bufs, engine->recv_buf_size, 0);
+            break;
+
+        default: /* OP_SEND */
+            ret = send(op->fd, op->buf, op->len, MSG_NOSIGNAL);
+            break;
+        }
+
+        if (ret < 0)
+        {
+            if (SOCK_SHOULD_TRY_LATER(errno))
+                return; /* To be continued on readiness. */
+
+            if (EINTR == errno || ECONNABORTED == errno)
+                continue;
+
+            __epoll_finish(engine, op, ERRNO_TO_CODE(errno), NULL);
+
+            return;
+        }
+
+        if (OP_ACCEPT_MULTISHOT == op->type || (OP_RECV_MULTISHOT == op->type && ret > 0))
+        {
+            __epoll_callback(engine, op, (int)ret, (OP_RECV_MULTISHOT == op->type) ? engine->recv_bufs : NULL, SOCK_ASYNC_MORE);
+            if (++chunks >= SOCK_ASYNC_CHUNKS_PER_TURN && !op->cancelled)
+            {
+                __push_ready(engine, op); /* Gives other fds a chance. */
+
+                return;
+            }
+            continue;
+        }
+
+        __epoll_finish(engine, op, (int)ret, (OP_ACCEPT == op->type) ? NULL
+            : ((OP_RECV_MULTISHOT == op->type) ? engine->recv_bufs : op->buf));
+
+        return;
+    }
+}
+
+static void __epoll_on_event(sock_reactor_t *reactor, int fd, int events, void *cb_arg)
+{
+    sock_async_t *engine = (sock_async_t *)cb_arg;
+    async_op_t *op = engine->fds[fd].reader;
+
+    /* Queued operations are tried later anyway. */
+
+    if ((events & (SOCK_STATUS_READABLE | SOCK_STATUS_ABNORMAL)) && NULL != op && !op->queued)
+        __epoll_try(engine, op);
+
+    op = engine->fds[fd].writer; /* Re-fetched since callbacks may grow the array. */
+    if ((events & (SOCK_STATUS_WRITABLE | SOCK_STATUS_ABNORMAL)) && NULL != op && !op->queued)
+        __epoll_try(engine, op);
+}
+
+/*
+ * Cancels operations submitted before, which are marked on submission of the cancellation
+ * and never queued again since then, so none of them is left in the ready list.
+ * The fd is no longer watched then, in case it's closed by the caller and its number reused.
+ */
+static void __epoll_cancel(sock_async_t *engine, int fd)
+{
+    fd_ops_t *ops = &engine->fds[fd];
+
+    if (NULL != ops->reader && ops->reader->cancelled)
+        __epoll_finish(engine, ops->reader, ERRNO_TO_CODE(ECANCELED), NULL);
+
+    ops = &engine->fds[fd];
+    if (NULL != ops->writer && ops->writer->cancelled)
+        __epoll_finish(engine, ops->writer, ERRNO_TO_CODE(ECANCELED), NULL);
+
+    ops = &engine->fds[fd];
+    if (ops->registered && NULL == ops->reader && NULL == ops->writer)
+    {
+        sock_reactor_remove(engine->reactor, fd);
+        ops->registered = 0;
+    }
+}
+
+static int __epoll_submit(sock_async_t *engine, async_op_t *op)
+{
+    fd_ops_t *ops = &engine->fds[op->fd];
+
+    if (OP_CLOSE == op->type || OP_CANCEL == op->type)
+    {
+        /* A multishot operation may be queued again by its callbacks, but not after this. */
+        if (NULL != ops->reader)
+            ops->reader->cancelled = 1;
+        if (NULL != ops->writer)
+            ops->writer->cancelled = 1;
+    }
+    else if (!ops->registered)
+    {
+        int err = sock_reactor_add(engine->reactor, op->fd, SOCK_STATUS_READABLE | SOCK_STATUS_WRITABLE,
+            __epoll_on_event, engine);
+
+        if (err < 0)
+            return (-SOCK_ASYNC_ERR_MEM_ALLOC == err) ? err : -SOCK_ASYNC_ERR_EVENT_LOOP;
+
+        ops->registered = 1;
+    }
+
+    /* Tried at the next run, since callbacks are never called within submission. */
+    __push_ready(engine, op);
+
+    return 0;
+}
+
+static int __epoll_run_once(sock_async_t *engine, int timeout_ms)
+{
+    async_op_t *op = engine->ready_head;
+    int ret;
+
+    engine->callback_count = 0;
+    engine->ready_head = engine->ready_tail = NULL; /* Operations submitted by callbacks are for the next run. */
+    while (NULL != op)
+    {
+        async_op_t *next = op->next;
+
+        op->queued = 0;
+        if (OP_CANCEL == op->type)
+        {
+            __epoll_cancel(engine, op->fd);
+            __free_op(engine, op);
+        }
+        else if (OP_CLOSE == op->type)
+        {
+            __epoll_cancel(engine, op->fd);
+            __epoll_callback(engine, op, (close(op->fd) < 0) ? ERRNO_TO_CODE(errno) : 0, NULL, 0);
+            __free_op(engine, op);
+        }
+        else
+            __epoll_try(engine, op);
+
+        op = next;
+    }
+
+    ret = sock_reactor_run_once(engine->reactor,
+        (NULL != engine->ready_head || engine->callback_count > 0) ? 0 : timeout_ms);
+
+    return (ret < 0) ? -SOCK_ASYNC_ERR_EVENT_LOOP : engine->callback_count;
+}
+
+/*
+ * ================
+ *  COMMON
+ * ================
+ */
+
+sock_async_t* sock_async_create(int backend, unsigned int queue_depth, size_t recv_buf_size, int *nullable_error)
+{
+    sock_async_t *engine = (sock_async_t *)calloc(1, sizeof(sock_async_t));
+    int err = 0;
+
+    if (NULL == engine)
+    {
+        err = -SOCK_ASYNC_ERR_MEM_ALLOC;
+        goto CREATE_END;
+    }
+
+    if (backend < SOCK_ASYNC_BACKEND_AUTO || backend > SOCK_ASYNC_BACKEND_EPOLL || queue_depth > 32768)
+    {
+        err = -SOCK_ASYNC_ERR_INVALID_PARAM;
+        goto CREATE_END;
+    }
+
+    engine->queue_depth = 1;
+    while (engine->queue_depth < ((0 == queue_depth) ? SOCK_ASYNC_QUEUE_DEPTH_DEFAULT : queue_depth))
+    {
+        engine->queue_depth *= 2;
+    }
+    engine->recv_buf_size = (0 == recv_buf_size) ? SOCK_ASYNC_RECV_BUF_SIZE_DEFAULT : recv_buf_size;
+
+#ifdef SOCK_ASYNC_HAS_IO_URING
+    engine->ring.fd = -1;
+    if (SOCK_ASYNC_BACKEND_EPOLL != backend)
+    {
+        if (NULL == (engine->recv_bufs = (char *)malloc(engine->recv_buf_size * engine->queue_depth)))
+        {
+            err = -SOCK_ASYNC_ERR_MEM_ALLOC;
+            goto CREATE_END;
+        }
+
+        if ((err = __uring_setup(engine)) >= 0 || SOCK_ASYNC_BACKEND_IO_URING == backend)
+        {
+            engine->backend = SOCK_ASYNC_BACKEND_IO_URING;
+            goto CREATE_END;
+        }
+        free(engine->recv_bufs);
+        engine->recv_bufs = NULL;
+    }
+#else
+    if (SOCK_ASYNC_BACKEND_IO_URING == backend)
+    {
+        err = -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+        goto CREATE_END;
+    }
+#endif
+
+    engine->backend = SOCK_ASYNC_BACKEND_EPOLL;
+    if (NULL == (engine->recv_bufs = (char *)malloc(engine->recv_buf_size)))
+    {
+        err = -SOCK_ASYNC_ERR_MEM_ALLOC;
+        goto CREATE_END;
+    }
+    if (NULL == (engine->reactor = sock_reactor_create(0, NULL)))
+        err = -SOCK_ASYNC_ERR_EVENT_LOOP;
+    else
+        err = 0;
+
+CREATE_END:
+
+    if (NULL != nullable_error)
+        *nullable_error = err;
+
+    if (err < 0)
+    {
+        sock_async_destroy(engine);
+
+        return NULL;
+    }
+
+    return engine;
+}
+
+void sock_async_destroy(sock_async_t *engine)
+{
+    if (NULL == engine)
+        return;
+
+#ifdef SOCK_ASYNC_HAS_IO_URING
+    if (SOCK_ASYNC_BACKEND_IO_URING == engine->backend)
+        __uring_teardown(&engine->ring); /* Pending operations are cancelled by the kernel. */
+#endif
+    sock_reactor_destroy(engine->reactor);
+    free(engine->fds);
+    free(engine->recv_bufs);
+    while (NULL != engine->op_blocks)
+    {
+        op_block_t *next = engine->op_blocks->next;
+
+        free(engine->op_blocks);
+        engine->op_blocks = next;
+    }
+    free(engine);
+}
+
+int sock_async_backend(const sock_async_t *engine)
+{
+    return engine->backend;
+}
+
+const char* sock_async_backend_name(const sock_async_t *engine)
+{
+    return (SOCK_ASYNC_BACKEND_IO_URING == engine->backend) ? "io_uring" : "epoll";
+}
+
+static int __submit(sock_async_t *engine, int type, int fd, const void *buf, size_t len,
+    int fixed_buf_index/* = -1 if not fixed */, sock_async_callback_t cb, void *cb_arg)
+{
+    async_op_t *op = NULL;
+    async_op_t **slot = NULL;
+    fd_ops_t *ops = NULL;
+    int err;
+
+    if (fd < 0 || (NULL == cb && OP_CLOSE != type && OP_CANCEL != type) || len > INT32_MAX)
+        return -SOCK_ASYNC_ERR_INVALID_PARAM;
+
+    if (fixed_buf_index >= 0 && (!engine->buffers_registered || NULL == buf || 0 == len))
+        return -SOCK_ASYNC_ERR_INVALID_PARAM;
+
+    if (NULL == (ops = __fd_ops(engine, fd)))
+        return -SOCK_ASYNC_ERR_MEM_ALLOC;
+
+    if (OP_SEND == type)
+        slot = &ops->writer;
+    else if (OP_CLOSE != type && OP_CANCEL != type)
+        slot = &ops->reader;
+
+    if (NULL != slot && NULL != *slot)
+        return -SOCK_ASYNC_ERR_BUSY;
+
+    if (NULL == (op = __alloc_op(engine)))
+        return -SOCK_ASYNC_ERR_MEM_ALLOC;
+
+    op->type = type;
+    op->fd = fd;
+    op->buf = (char *)buf;
+    op->len = len;
+    op->fixed = (fixed_buf_index >= 0);
+    op->buf_index = op->fixed ? fixed_buf_index : 0;
+    op->cb = cb;
+    op->cb_arg = cb_arg;
+
+#ifdef SOCK_ASYNC_HAS_IO_URING
+    if (SOCK_ASYNC_BACKEND_IO_URING == engine->backend)
+        err = __uring_submit(engine, op);
+    else
+#endif
+        err = __epoll_submit(engine, op);
+
+    if (err < 0)
+        __free_op(engine, op);
+    else if (NULL != slot)
+        *slot = op;
+
+    return err;
+}
+
+int sock_async_accept(sock_async_t *engine, int listen_fd, int multishot, sock_async_callback_t cb, void *cb_arg)
+{
+    return __submit(engine, multishot ? OP_ACCEPT_MULTISHOT : OP_ACCEPT, listen_fd, NULL, 0, -1, cb, cb_arg);
+}
+
+int sock_async_recv(sock_async_t *engine, int fd, void *buf, size_t len, sock_async_callback_t cb, void *cb_arg)
+{
+    return (NULL == buf || 0 == len) ? -SOCK_ASYNC_ERR_INVALID_PARAM : __submit(engine, OP_RECV, fd, buf, len, -1, cb, cb_arg);
+}
+
+int sock_async_recv_multishot(sock_async_t *engine, int fd, sock_async_callback_t cb, void *cb_arg)
+{
+    return __submit(engine, OP_RECV_MULTISHOT, fd, NULL, 0, -1, cb, cb_arg);
+}
+
+int sock_async_send(sock_async_t *engine, int fd, const void *buf, size_t len, sock_async_callback_t cb, void *cb_arg)
+{
+    return (NULL == buf || 0 == len) ? -SOCK_ASYNC_ERR_INVALID_PARAM : __submit(engine, OP_SEND, fd, buf, len, -1, cb, cb_arg);
+}
+
+int sock_async_close(sock_async_t *engine, int fd, sock_async_callback_t nullable_cb, void *cb_arg)
+{
+    return __submit(engine, OP_CLOSE, fd, NULL, 0, -1, nullable_cb, cb_arg);
+}
+
+int sock_async_cancel(sock_async_t *engine, int fd)
+{
+    return __submit(engine, OP_CANCEL, fd, NULL, 0, -1, NULL, NULL);
+}
+
+int sock_async_register_buffers(sock_async_t *engine, const void *iovecs, unsigned int count)
+{
+    if (NULL == iovecs || 0 == count)
+        return -SOCK_ASYNC_ERR_INVALID_PARAM;
+
+    if (engine->buffers_registered)
+        return -SOCK_ASYNC_ERR_BUFFERS_REGISTERED;
+
+#ifdef SOCK_ASYNC_HAS_IO_URING
+    if (SOCK_ASYNC_BACKEND_IO_URING == engine->backend
+        && syscall(__NR_io_uring_register, engine->ring.fd, IORING_REGISTER_BUFFERS, iovecs, count) < 0)
+        return ERRNO_TO_CODE(errno);
+#endif
+    engine->buffers_registered = 1;
+
+    return 0;
+}
+
+int sock_async_recv_fixed(sock_async_t *engine, int fd, unsigned int buf_index, void *buf, size_t len,
+    sock_async_callback_t cb, void *cb_arg)
+{
+    return (buf_index > INT32_MAX) ? -SOCK_ASYNC_ERR_INVALID_PARAM : __submit(engine, OP_RECV, fd, buf, len, buf_index, cb, cb_arg);
+}
+
+int sock_async_send_fixed(sock_async_t *engine, int fd, unsigned int buf_index, const void *buf, size_t len,
+    sock_async_callback_t cb, void *cb_arg)
+{
+    return (buf_index > INT32_MAX) ? -SOCK_ASYNC_ERR_INVALID_PARAM : __submit(engine, OP_SEND, fd, buf, len, buf_index, cb, cb_arg);
+}
+
+int sock_async_run_once(sock_async_t *engine, int timeout_ms)
+{
+#ifdef SOCK_ASYNC_HAS_IO_URING
+    if (SOCK_ASYNC_BACKEND_IO_URING == engine->backend)
+        return __uring_run_once(engine, timeout_ms);
+#endif
+
+    return __epoll_run_once(engine, timeout_ms);
+}
+
+#else /* Not Linux */
+
+sock_async_t* sock_async_create(int backend, unsigned int queue_depth, size_t recv_buf_size, int *nullable_error)
+{
+    if (NULL != nullable_error)
+        *nullable_error = -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+
+    return NULL;
+}
+
+void sock_async_destroy(sock_async_t *engine)
+{
+}
+
+int sock_async_backend(const sock_async_t *engine)
+{
+    return SOCK_ASYNC_BACKEND_AUTO;
+}
+
+const char* sock_async_backend_name(const sock_async_t *engine)
+{
+    return "none";
+}
+
+int sock_async_accept(sock_async_t *engine, int listen_fd, int multishot, sock_async_callback_t cb, void *cb_arg)
+{
+    return -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+}
+
+int sock_async_recv(sock_async_t *engine, int fd, void *buf, size_t len, sock_async_callback_t cb, void *cb_arg)
+{
+    return -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+}
+
+int sock_async_recv_multishot(sock_async_t *engine, int fd, sock_async_callback_t cb, void *cb_arg)
+{
+    return -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+}
+
+int sock_async_send(sock_async_t *engine, int fd, const void *buf, size_t len, sock_async_callback_t cb, void *cb_arg)
+{
+    return -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+}
+
+int sock_async_close(sock_async_t *engine, int fd, sock_async_callback_t nullable_cb, void *cb_arg)
+{
+    return -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+}
+
+int sock_async_cancel(sock_async_t *engine, int fd)
+{
+    return -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+}
+
+int sock_async_register_buffers(sock_async_t *engine, const void *iovecs, unsigned int count)
+{
+    return -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+}
+
+int sock_async_recv_fixed(sock_async_t *engine, int fd, unsigned int buf_index, void *buf, size_t len,
+    sock_async_callback_t cb, void *cb_arg)
+{
+    return -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+}
+
+int sock_async_send_fixed(sock_async_t *engine, int fd, unsigned int buf_index, const void *buf, size_t len,
+    sock_async_callback_t cb, void *cb_arg)
+{
+    return -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+}
+
+int sock_async_run_once(sock_async_t *engine, int timeout_ms)
+{
+    return -SOCK_ASYNC_ERR_NOT_SUPPORTED;
+}
+
+#endif /* #if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__) */
+
+#ifdef TEST
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/uio.h>
+
+#include "sleeps.h"
+
+#define CLIENT_COUNT                        32
+#define ROUNDS                              1000
+#define MSG_SIZE                            64
+
+typedef struct bench_t bench_t;
+
+typedef struct peer_t
+{
+    bench_t *bench;
+    int fd;
+    int rounds;
+    size_t pending; /* Bytes to echo, of a server peer */
+    int sending;
+    char buf[MSG_SIZE * 2];
+} peer_t;
+
+struct bench_t
+{
+    int failed;
+    int accepting;
+    int accepted;
+    int closed;
+    long round_trips;
+    peer_t servers[CLIENT_COUNT];
+    peer_t clients[CLIENT_COUNT]; /* buf: MSG_SIZE bytes to send, then MSG_SIZE bytes received. */
+};
+
+static void on_closed(sock_async_t *engine, int fd, int result, const void *data, int flags, void *cb_arg)
+{
+    bench_t *bench = (bench_t *)cb_arg;
+
+    if (result < 0)
+        bench->failed += 1;
+    bench->closed += 1;
+}
+
+static void on_server_sent(sock_async_t *engine, int fd, int result, const void *data, int flags, void *cb_arg);
+
+static void echo(sock_async_t *engine, peer_t *server)
+{
+    if (server->sending || 0 == server->pending)
+        return;
+
+    if (sock_async_send(engine, server->fd, server->buf, server->pending, on_server_sent, server) < 0)
+        server->bench->failed += 1;
+    else
+        server->sending = 1;
+}
+
+static void on_server_sent(sock_async_t *engine, int fd, int result, const void *data, int flags, void *cb_arg)
+{
+    peer_t *server = (peer_t *)cb_arg;
+
+    server->sending = 0;
+    if (result < 0)
+        return; /* Cancelled by closing */
+
+    memmove(server->buf, server->buf + result, server->pending - result);
+    server->pending -= result;
+    echo(engine, server);
+}
+
+static void on_server_recv(sock_async_t *engine, int fd, int result, const void *data, int flags, void *cb_arg)
+{
+    peer_t *server = (peer_t *)cb_arg;
+
+    if (result > 0)
+    {
+        if (server->pending + result > sizeof(server->buf))
+        {
+            server->bench->failed += 1;
+
+            return;
+        }
+        memcpy(server->buf + server->pending, data, result);
+        server->pending += result;
+        echo(engine, server);
+    }
+
+    if (!(flags & SOCK_ASYNC_MORE) && sock_async_close(engine, fd, on_closed, server->bench) < 0)
+        server->bench->failed += 1;
+}
+
+static void on_accept(sock_async_t *engine, int fd, int result, const void *data, int flags, void *cb_arg)
+{
+    bench_t *bench = (bench_t *)cb_arg;
+    peer_t *server = NULL;
+
+    if (!(flags & SOCK_ASYNC_MORE))
+        bench->accepting = 0;
+
+    if (result < 0)
+    {
+        if (result != -(ECANCELED + SOCK_ASYNC_ERR_END))
+            bench->failed += 1;
+
+        return;
+    }
+
+    if (bench->accepted >= CLIENT_COUNT)
+    {
+        close(result);
+        bench->failed += 1;
+
+        return;
+    }
+    server = &bench->servers[bench->accepted++];
+    server->bench = bench;
+    server->fd = result;
+    if (sock_async_recv_multishot(engine, server->fd, on_server_recv, server) < 0)
+        bench->failed += 1;
+}
+
+static void on_client_recv(sock_async_t *engine, int fd, int result, const void *data, int flags, void *cb_arg);
+
+static void on_client_sent(sock_async_t *engine, int fd, int result, const void *data, int flags, void *cb_arg)
+{
+    peer_t *client = (peer_t *)cb_arg;
+
+    if (MSG_SIZE != result)
+        client->bench->failed += 1;
+}
+
+static int start_round(sock_async_t *engine, peer_t *client)
+{
+    client->pending = 0;
+    if (sock_async_send_fixed(engine, client->fd, 0, client->buf, MSG_SIZE, on_client_sent, client) < 0
+        || sock_async_recv_fixed(engine, client->fd, 0, client->buf + MSG_SIZE, MSG_SIZE, on_client_recv, client) < 0)
+        return -1;
+
+    return 0;
+}
+
+static void on_client_recv(sock_async_t *engine, int fd, int result, const void *data, int flags, void *cb_arg)
+{
+    peer_t *client = (peer_t *)cb_arg;
+    bench_t *bench = client->bench;
+    int err = 0;
+
+    if (result <= 0)
+    {
+        bench->failed += 1;
+
+        return;
+    }
+
+    client->pending += result;
+    if (client->pending < MSG_SIZE)
+    {
+        err = sock_async_recv_fixed(engine, fd, 0, client->buf + MSG_SIZE + client->pending, MSG_SIZE - client->pending,
+            on_client_recv, client);
+    }
+    else
+    {
+        if (0 != memcmp(client->buf, client->buf + MSG_SIZE, MSG_SIZE))
+            bench->failed += 1;
+
+        bench->round_trips += 1;
+        if (++client->rounds < ROUNDS)
+            err = start_round(engine, client);
+        else
+            err = sock_async_close(engine, fd, on_closed, bench);
+    }
+
+    if (err < 0)
+        bench->failed += 1;
+}
+
+static int run_bench(int backend)
+{
+    int err = 0;
+    sock_async_t *engine = sock_async_create(backend, 0, 0, &err);
+    bench_t *bench = (bench_t *)calloc(1, sizeof(bench_t));
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    struct iovec iov;
+    double begin = 0;
+    int listen_fd = -1;
+    int one = 1;
+    int i;
+
+    if (NULL == engine || NULL == bench)
+    {
+        printf("[%s] Skipped: %s\n", (SOCK_ASYNC_BACKEND_IO_URING == backend) ? "io_uring" : "epoll", sock_async_error(err));
+        free(bench);
+        sock_async_destroy(engine);
+
+        return (-SOCK_ASYNC_ERR_NOT_SUPPORTED == err) ? 0 : -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if ((listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0
+        || bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0
+        || listen(listen_fd, CLIENT_COUNT) < 0
+        || getsockname(listen_fd, (struct sockaddr *)&addr, &addr_len) < 0)
+    {
+        perror("listen");
+        bench->failed += 1;
+        goto BENCH_END;
+    }
+
+    if ((err = sock_async_accept(engine, listen_fd, 1, on_accept, bench)) < 0)
+    {
+        fprintf(stderr, "sock_async_accept() failed: %s\n", sock_async_error(err));
+        bench->failed += 1;
+        goto BENCH_END;
+    }
+    bench->accepting = 1;
+
+    iov.iov_base = bench->clients;
+    iov.iov_len = sizeof(bench->clients);
+    if ((err = sock_async_register_buffers(engine, &iov, 1)) < 0)
+    {
+        fprintf(stderr, "sock_async_register_buffers() failed: %s\n", sock_async_error(err));
+        bench->failed += 1;
+        goto BENCH_END;
+    }
+
+    for (i = 0; i < CLIENT_COUNT; ++i)
+    {
+        peer_t *client = &bench->clients[i];
+
+        client->bench = bench;
+        memset(client->buf, 'a' + i % 26, MSG_SIZE);
+        if ((client->fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0
+            || connect(client->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 /* Completes before accepted. */
+            || fcntl(client->fd, F_SETFL, O_NONBLOCK) < 0
+            || setsockopt(client->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) < 0)
+        {
+            perror("connect");
+            bench->failed += 1;
+            goto BENCH_END;
+        }
+    }
+
+    begin = monotonic_milliseconds();
+    for (i = 0; i < CLIENT_COUNT; ++i)
+    {
+        if (start_round(engine, &bench->clients[i]) < 0)
+            bench->failed += 1;
+    }
+    /* Clients and servers are all closed in callbacks, then the multishot accept is cancelled. */
+    while (0 == bench->failed && (bench->closed < CLIENT_COUNT * 2 || bench->accepting) && (monotonic_milliseconds() - begin) < 30000)
+    {
+        if (bench->closed == CLIENT_COUNT * 2 && 1 == bench->accepting)
+        {
+            sock_async_cancel(engine, listen_fd);
+            bench->accepting = -1; /* Cancelling */
+        }
+
+        if ((err = sock_async_run_once(engine, 1000)) < 0)
+        {
+            fprintf(stderr, "sock_async_run_once() failed: %s\n", sock_async_error(err));
+            bench->failed += 1;
+        }
+    }
+    printf("[%s] %d connections x %d round trips of %d bytes: %.1f ms, %.0f round trips/s\n",
+        sock_async_backend_name(engine), CLIENT_COUNT, ROUNDS, MSG_SIZE, (monotonic_milliseconds() - begin),
+        bench->round_trips / ((monotonic_milliseconds() - begin) / 1000.0));
+
+    if (bench->round_trips != (long)CLIENT_COUNT * ROUNDS || bench->closed != CLIENT_COUNT * 2 || bench->accepting)
+        bench->failed += 1;
+
+BENCH_END:
+
+    err = bench->failed ? -1 : 0;
+    if (err < 0)
+    {
+        fprintf(stderr, "[%s] Failed: %ld round trips, %d closed\n",
+            sock_async_backend_name(engine), bench->round_trips, bench->closed);
+    }
+    if (listen_fd >= 0)
+        close(listen_fd);
+    sock_async_destroy(engine);
+    free(bench);
+
+    return err;
+}
+
+typedef struct close_test_t
+{
+    int chunks;
+    int cancelled;
+    int closed;
+    int failed;
+} close_test_t;
+
+static void on_test_closed(sock_async_t *engine, int fd, int result, const void *data, int flags, void *cb_arg)
+{
+    close_test_t *test = (close_test_t *)cb_arg;
+
+    if (result < 0)
+        test->failed += 1;
+    test->closed += 1;
+}
+
+static void on_closing_recv(sock_async_t *engine, int fd, int result, const void *data, int flags, void *cb_arg)
+{
+    close_test_t *test = (close_test_t *)cb_arg;
+
+    if (result > 0)
+    {
+        if (0 == test->chunks++ && sock_async_close(engine, fd, on_test_closed, test) < 0)
+            test->failed += 1;
+    }
+    else if (ERRNO_TO_CODE(ECANCELED) == result)
+        test->cancelled += 1;
+    else
+        test->failed += 1;
+}
+
+/* Closes the fd in the first callback of a multishot recv, with more data than a turn of epoll takes. */
+static int test_close_in_callback(int backend)
+{
+    static char data[64 * SOCK_ASYNC_CHUNKS_PER_TURN * 2];
+    int err = 0;
+    sock_async_t *engine = sock_async_create(backend, 0, 64, &err);
+    const char *name = (SOCK_ASYNC_BACKEND_IO_URING == backend) ? "io_uring" : "epoll";
+    close_test_t test;
+    int fds[2] = { -1, -1 };
+    int i;
+
+    memset(&test, 0, sizeof(test));
+    if (NULL == engine)
+        return (-SOCK_ASYNC_ERR_NOT_SUPPORTED == err) ? 0 : -1;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) < 0
+        || write(fds[1], data, sizeof(data)) != (ssize_t)sizeof(data))
+    {
+        perror("socketpair");
+        test.failed += 1;
+        goto CLOSE_TEST_END;
+    }
+
+    /* Only one reader at a time, with either backend. */
+    if (sock_async_recv_multishot(engine, fds[0], on_closing_recv, &test) < 0
+        || -SOCK_ASYNC_ERR_BUSY != sock_async_recv(engine, fds[0], data, sizeof(data), on_closing_recv, &test))
+        test.failed += 1;
+
+    for (i = 0; 0 == test.failed && 0 == test.closed && i < 100; ++i)
+    {
+        if (sock_async_run_once(engine, 100) < 0)
+            test.failed += 1;
+    }
+
+CLOSE_TEST_END:
+
+    sock_async_destroy(engine);
+    if (fds[0] >= 0 && 0 == test.closed)
+        close(fds[0]);
+    if (fds[1] >= 0)
+        close(fds[1]);
+
+    /* Chunks of io_uring may have been received before the closing. */
+    if (test.failed || 1 != test.closed || 1 != test.cancelled || (SOCK_ASYNC_BACKEND_EPOLL == backend && 1 != test.chunks))
+    {
+        fprintf(stderr, "[%s] Closing within a callback failed: %d chunks, %d cancelled, %d closed, %d failed\n",
+            name, test.chunks, test.cancelled, test.closed, test.failed);
+
+        return -1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int err = 0;
+    sock_async_t *engine = sock_async_create(SOCK_ASYNC_BACKEND_AUTO, 0, 0, &err);
+
+    if (NULL == engine)
+    {
+        fprintf(stderr, "sock_async_create() failed: %s\n", sock_async_error(err));
+
+        return -1;
+    }
+    printf("Default backend: %s\n", sock_async_backend_name(engine));
+    sock_async_destroy(engine);
+
+    if (run_bench(SOCK_ASYNC_BACKEND_IO_URING) < 0 || run_bench(SOCK_ASYNC_BACKEND_EPOLL) < 0
+        || test_close_in_callback(SOCK_ASYNC_BACKEND_IO_URING) < 0 || test_close_in_callback(SOCK_ASYNC_BACKEND_EPOLL) < 0)
+        return -1;
+
+    printf("All tests passed.\n");
+
+    return 0;
+}
+
+#endif /* #ifdef TEST */
+
+#ifdef __cplusplus
+}
+#endif
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. Cancel a multishot operation of epoll queued again by its callbacks too,
+ *      which used to be left attached to an fd closed or cancelled meanwhile,
+ *      and allow one pending reader and one writer per fd with io_uring as well.
+ */
+
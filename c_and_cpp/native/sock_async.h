@@ -0,0 +1,138 @@
+/*
+ * Asynchronous accept/recv/send/close of sockets with completion callbacks,
+ * backed by io_uring, or by epoll (sock_reactor) where io_uring is unavailable.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __SOCK_ASYNC_H__
+#define __SOCK_ASYNC_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum
+{
+    SOCK_ASYNC_BACKEND_AUTO = 0 /* io_uring if usable, otherwise epoll. */
+    , SOCK_ASYNC_BACKEND_IO_URING
+    , SOCK_ASYNC_BACKEND_EPOLL
+};
+
+/* Set in flags of a callback if the operation (a multishot one) will complete again. */
+#define SOCK_ASYNC_MORE                             0x1
+
+typedef struct sock_async_t sock_async_t;
+
+/*
+ * Called once for each completion:
+ *  accept: result is the new fd (non-blocking and close-on-exec), data is NULL.
+ *  recv:   result is the number of bytes received (0 on EOF), data points to them.
+ *          Data of a multishot recv belongs to the engine and is valid within the callback only.
+ *  send:   result is the number of bytes sent, which may be less than requested,
+ *          and data is the buffer passed in.
+ *  close:  result is 0, data is NULL.
+ * On failure, result is a negative error code and data is NULL.
+ * Cancelled operations complete with the error code of ECANCELED.
+ */
+typedef void (*sock_async_callback_t)(sock_async_t *engine, int fd, int result, const void *data,
+    int flags/* = 0 or SOCK_ASYNC_MORE */, void *cb_arg);
+
+const char* sock_async_error(int error_code);
+
+/*
+ * io_uring needs Linux 6.0+ for multishot recv with a ring of provided buffers,
+ * otherwise SOCK_ASYNC_BACKEND_AUTO falls back to epoll.
+ * The queue depth is the size of the submission queue, and also the number of
+ * recv_buf_size-byte buffers provided to multishot recv.
+ */
+sock_async_t* sock_async_create(int backend/* = SOCK_ASYNC_BACKEND_AUTO */, unsigned int queue_depth/* = 0 for 256 */,
+    size_t recv_buf_size/* = 0 for 4096 */, int *nullable_error);
+
+/* Pending operations are dropped without their callbacks called. Fds are not closed. */
+void sock_async_destroy(sock_async_t *engine);
+
+int sock_async_backend(const sock_async_t *engine);
+
+const char* sock_async_backend_name(const sock_async_t *engine);
+
+/*
+ * All fds should be non-blocking, which epoll relies on.
+ * At most one accept/recv and one send can be pending on an fd at a time with either backend,
+ * which is required by the epoll backend and keeps a stream in order anyway.
+ * Operation functions return 0 once submitted, or a negative error code.
+ */
+
+/* A multishot accept completes with SOCK_ASYNC_MORE for each connection until cancelled or failed. */
+int sock_async_accept(sock_async_t *engine, int listen_fd, int multishot, sock_async_callback_t cb, void *cb_arg);
+
+/* The buffer must stay valid until completion. */
+int sock_async_recv(sock_async_t *engine, int fd, void *buf, size_t len, sock_async_callback_t cb, void *cb_arg);
+
+/* Completes with SOCK_ASYNC_MORE for each chunk of data, until EOF, an error or cancellation. */
+int sock_async_recv_multishot(sock_async_t *engine, int fd, sock_async_callback_t cb, void *cb_arg);
+
+/* The buffer must stay valid until completion. SIGPIPE is never raised. */
+int sock_async_send(sock_async_t *engine, int fd, const void *buf, size_t len, sock_async_callback_t cb, void *cb_arg);
+
+/*
+ * Pending operations of the fd are cancelled before it's closed.
+ * An fd with operations ever submitted should be closed by this,
+ * or be closed after sock_async_cancel() completes otherwise.
+ */
+int sock_async_close(sock_async_t *engine, int fd, sock_async_callback_t nullable_cb, void *cb_arg);
+
+/* Cancels all pending operations of the fd. */
+int sock_async_cancel(sock_async_t *engine, int fd);
+
+/*
+ * Registers buffers (struct iovec array) with the kernel, so that the *_fixed() functions
+ * save mapping them on each call. The buffers must stay valid until the engine is destroyed.
+ * Can only be called once. The epoll backend accepts and ignores them.
+ */
+int sock_async_register_buffers(sock_async_t *engine, const void *iovecs, unsigned int count);
+
+/* The buffer must lie within the registered one at buf_index. */
+int sock_async_recv_fixed(sock_async_t *engine, int fd, unsigned int buf_index, void *buf, size_t len,
+    sock_async_callback_t cb, void *cb_arg);
+
+int sock_async_send_fixed(sock_async_t *engine, int fd, unsigned int buf_index, const void *buf, size_t len,
+    sock_async_callback_t cb, void *cb_arg);
+
+/*
+ * Submits queued operations, waits at most timeout_ms milliseconds (negative for infinity)
+ * for completions, and calls their callbacks.
+ * Returns the number of callbacks called, or a negative error code.
+ */
+int sock_async_run_once(sock_async_t *engine, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __SOCK_ASYNC_H__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. State that the limit of pending operations per fd applies to io_uring too.
+ */
+
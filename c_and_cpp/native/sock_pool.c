@@ -0,0 +1,861 @@
+/*
+ * Pool of client-side TCP connections keyed by address, which reuses idle connections
+ * so that a request seldom pays for a handshake.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "sock_pool.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/socket.h>
+
+#include "socket_supplements.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum
+{
+    SOCK_POOL_ERR_UNKNOWN = 1
+    , SOCK_POOL_ERR_MEM_ALLOC
+    , SOCK_POOL_ERR_INVALID_PARAM
+    , SOCK_POOL_ERR_THREAD
+    , SOCK_POOL_ERR_EXHAUSTED
+    , SOCK_POOL_ERR_CONNECT_TIMEOUT
+
+    , SOCK_POOL_ERR_END /* NOTE: All error codes should be defined ahead of this. */
+};
+
+static const char* const S_ERRORS[] = {
+    "Unknown error"
+    , "Failed to allocate memory"
+    , "Invalid parameter"
+    , "Failed to create the checker thread"
+    , "All connections to the address are in use"
+    , "Timed out connecting"
+};
+
+const char* sock_pool_error(int error_code)
+{
+    if (error_code >= 0)
+        return "OK";
+
+    if (error_code <= -SOCK_POOL_ERR_END)
+        return strerror(-error_code - SOCK_POOL_ERR_END);
+
+    return S_ERRORS[-error_code - 1];
+}
+
+typedef struct pool_idle_t
+{
+    int fd;
+    unsigned long since_ms; /* Wraps around, which unsigned subtraction tolerates. */
+    unsigned long stamp; /* Tells the connection from a later one reusing its fd. */
+} pool_idle_t;
+
+typedef struct pool_host_t
+{
+    struct sockaddr_storage addr;
+    size_t addr_len;
+    size_t total; /* Idle, in use and being connected */
+    size_t idle_count;
+    pool_idle_t *idle; /* Stack with the most recently released on top */
+} pool_host_t;
+
+typedef struct pool_probe_t
+{
+    pool_host_t *host;
+    pool_idle_t conn;
+    bool dead;
+} pool_probe_t;
+
+struct sock_pool_t
+{
+    sock_pool_config_t config;
+    pthread_mutex_t lock;
+    pthread_cond_t released; /* Signaled whenever a host may have room. */
+    pthread_cond_t checker_cond;
+    pthread_t checker;
+    bool checker_started;
+    bool stopping;
+    pool_host_t **hosts;
+    size_t host_count;
+    size_t host_capacity;
+    pool_host_t **owners; /* Host of each acquired connection, indexed by fd */
+    int owner_capacity;
+    unsigned long releases; /* Stamps of idle connections */
+    sock_pool_stats_t stats;
+};
+
+static unsigned long __now_ms(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (unsigned long)now.tv_sec * 1000UL + now.tv_nsec / 1000000L;
+}
+
+static void __deadline_after(int ms, struct timespec *deadline)
+{
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += ms / 1000;
+    deadline->tv_nsec += (ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L)
+    {
+        deadline->tv_sec += 1;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+/*
+ * A connection idle in the pool should have nothing to read: EOF means the peer has closed it,
+ * and data means a response of an earlier request was left unread, which would confuse the next one.
+ */
+static bool __is_reusable(int fd)
+{
+    char byte;
+    ssize_t ret;
+
+    while ((ret = recv(fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT)) < 0 && EINTR == errno)
+    {
+        ;
+    }
+
+    return ret < 0 && SOCK_SHOULD_TRY_LATER(errno);
+}
+
+static int __connect(const sock_pool_t *pool, const pool_host_t *host)
+{
+    const struct sockaddr *addr = (const struct sockaddr *)&host->addr;
+    int fd = socket(addr->sa_family, SOCK_STREAM, 0);
+    int err = 0;
+
+    if (fd < 0 || sock_set_nonblocking(fd) < 0)
+        err = -(errno + SOCK_POOL_ERR_END);
+    else if (connect(fd, addr, host->addr_len) < 0)
+    {
+        struct pollfd pfd;
+        socklen_t err_len = sizeof(err);
+        int ret;
+
+        if (EINPROGRESS != errno)
+        {
+            err = -(errno + SOCK_POOL_ERR_END);
+            goto CONNECT_END;
+        }
+
+        pfd.fd = fd;
+        pfd.events = POLLOUT;
+        while ((ret = poll(&pfd, 1, pool->config.connect_timeout_ms)) < 0 && EINTR == errno)
+        {
+            ;
+        }
+
+        if (ret < 0 || getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &err_len) < 0)
+            err = -(errno + SOCK_POOL_ERR_END);
+        else if (0 == ret)
+            err = -SOCK_POOL_ERR_CONNECT_TIMEOUT;
+        else if (0 != err)
+            err = -(err + SOCK_POOL_ERR_END);
+    }
+
+    if (0 == err && !pool->config.nonblocking)
+    {
+        int options = fcntl(fd, F_GETFL);
+
+        if (options < 0 || fcntl(fd, F_SETFL, options & ~O_NONBLOCK) < 0)
+            err = -(errno + SOCK_POOL_ERR_END);
+    }
+
+CONNECT_END:
+
+    if (err < 0)
+    {
+        if (fd >= 0)
+            close(fd);
+
+        return err;
+    }
+
+    return fd;
+}
+
+/* Closes a connection found broken, unless it has been acquired (and maybe released again) meanwhile. */
+static void __close_if_still_idle(pool_host_t *host, const pool_idle_t *conn)
+{
+    size_t i;
+
+    for (i = 0; i < host->idle_count; ++i)
+    {
+        if (host->idle[i].fd == conn->fd && host->idle[i].stamp == conn->stamp)
+        {
+            close(conn->fd);
+            host->idle[i].fd = -1;
+            break;
+        }
+    }
+}
+
+/* Removes expired idle connections of a host and those closed above, keeping the order of the rest. */
+static int __evict_idle(sock_pool_t *pool, pool_host_t *host, unsigned long now_ms)
+{
+    size_t kept = 0;
+    size_t i;
+
+    for (i = 0; i < host->idle_count; ++i)
+    {
+        pool_idle_t *conn = &host->idle[i];
+
+        if (conn->fd < 0)
+            continue;
+
+        if (pool->config.idle_timeout_ms > 0 && now_ms - conn->since_ms >= (unsigned long)pool->config.idle_timeout_ms)
+            close(conn->fd);
+        else
+            host->idle[kept++] = *conn;
+    }
+
+    i = host->idle_count - kept;
+    host->idle_count = kept;
+    host->total -= i;
+
+    return (int)i;
+}
+
+int sock_pool_check(sock_pool_t *pool)
+{
+    unsigned long now_ms = __now_ms();
+    pool_probe_t *probes = NULL;
+    size_t count = 0;
+    int closed = 0;
+    size_t i;
+
+    /* Probes cost system calls for each connection, so they are done on a snapshot without the lock. */
+    pthread_mutex_lock(&pool->lock);
+    for (i = 0; i < pool->host_count; ++i)
+    {
+        count += pool->hosts[i]->idle_count;
+    }
+    if (count > 0 && NULL == (probes = (pool_probe_t *)malloc(sizeof(pool_probe_t) * count)))
+    {
+        pthread_mutex_unlock(&pool->lock);
+
+        return -SOCK_POOL_ERR_MEM_ALLOC;
+    }
+    for (count = 0, i = 0; i < pool->host_count; ++i)
+    {
+        size_t j;
+
+        for (j = 0; j < pool->hosts[i]->idle_count; ++j, ++count)
+        {
+            probes[count].host = pool->hosts[i];
+            probes[count].conn = pool->hosts[i]->idle[j];
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    /* An fd acquired meanwhile is only peeked at, and a dead one is left to the acquirer. */
+    for (i = 0; i < count; ++i)
+    {
+        int fd = probes[i].conn.fd;
+
+        probes[i].dead = (sock_check_status(fd, SOCK_STATUS_ABNORMAL, 0) < 0 || !__is_reusable(fd));
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    for (i = 0; i < count; ++i)
+    {
+        if (probes[i].dead)
+            __close_if_still_idle(probes[i].host, &probes[i].conn);
+    }
+    for (i = 0; i < pool->host_count; ++i)
+    {
+        closed += __evict_idle(pool, pool->hosts[i], now_ms);
+    }
+    pool->stats.drops += closed;
+    pool->stats.idle -= closed;
+    if (closed > 0)
+        pthread_cond_broadcast(&pool->released);
+    pthread_mutex_unlock(&pool->lock);
+
+    free(probes);
+
+    return closed;
+}
+
+static void* __checker_thread(void *arg)
+{
+    sock_pool_t *pool = (sock_pool_t *)arg;
+
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stopping)
+    {
+        struct timespec deadline;
+
+        __deadline_after(pool->config.check_interval_ms, &deadline);
+        if (ETIMEDOUT != pthread_cond_timedwait(&pool->checker_cond, &pool->lock, &deadline) || pool->stopping)
+            continue;
+
+        pthread_mutex_unlock(&pool->lock);
+        sock_pool_check(pool);
+        pthread_mutex_lock(&pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+sock_pool_t* sock_pool_create(const sock_pool_config_t *nullable_config, int *nullable_error)
+{
+    sock_pool_t *pool = (sock_pool_t *)calloc(1, sizeof(sock_pool_t));
+    pthread_condattr_t cond_attr;
+    int err = 0;
+
+    if (NULL == pool)
+    {
+        err = -SOCK_POOL_ERR_MEM_ALLOC;
+        goto CREATE_END;
+    }
+
+    if (NULL != nullable_config)
+        pool->config = *nullable_config;
+    if (0 == pool->config.max_per_host)
+        pool->config.max_per_host = 8;
+    if (0 == pool->config.connect_timeout_ms)
+        pool->config.connect_timeout_ms = 3000;
+    if (pool->config.check_interval_ms < 0 || pool->config.idle_timeout_ms < 0)
+    {
+        free(pool);
+        pool = NULL;
+        err = -SOCK_POOL_ERR_INVALID_PARAM;
+        goto CREATE_END;
+    }
+
+    /* Waits are measured by the monotonic clock, so that changes of the system time don't matter. */
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->released, &cond_attr);
+    pthread_cond_init(&pool->checker_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+
+    if (pool->config.check_interval_ms > 0)
+    {
+        if (0 != pthread_create(&pool->checker, NULL, __checker_thread, pool))
+        {
+            err = -SOCK_POOL_ERR_THREAD;
+            sock_pool_destroy(pool);
+            pool = NULL;
+            goto CREATE_END;
+        }
+        pool->checker_started = true;
+    }
+
+CREATE_END:
+
+    if (NULL != nullable_error)
+        *nullable_error = err;
+
+    return pool;
+}
+
+void sock_pool_destroy(sock_pool_t *pool)
+{
+    size_t i;
+
+    if (NULL == pool)
+        return;
+
+    if (pool->checker_started)
+    {
+        pthread_mutex_lock(&pool->lock);
+        pool->stopping = true;
+        pthread_cond_signal(&pool->checker_cond);
+        pthread_mutex_unlock(&pool->lock);
+        pthread_join(pool->checker, NULL);
+    }
+
+    for (i = 0; i < pool->host_count; ++i)
+    {
+        size_t j;
+
+        for (j = 0; j < pool->hosts[i]->idle_count; ++j)
+        {
+            close(pool->hosts[i]->idle[j].fd);
+        }
+        free(pool->hosts[i]->idle);
+        free(pool->hosts[i]);
+    }
+    free(pool->hosts);
+    free(pool->owners);
+    pthread_cond_destroy(&pool->checker_cond);
+    pthread_cond_destroy(&pool->released);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+static pool_host_t* __find_or_add_host(sock_pool_t *pool, const struct sockaddr *addr, size_t addr_len)
+{
+    pool_host_t *host;
+    size_t i;
+
+    for (i = 0; i < pool->host_count; ++i)
+    {
+        host = pool->hosts[i];
+        if (host->addr_len == addr_len && 0 == memcmp(&host->addr, addr, addr_len))
+            return host;
+    }
+
+    if (pool->host_count == pool->host_capacity)
+    {
+        size_t capacity = (0 == pool->host_capacity) ? 8 : pool->host_capacity * 2;
+        pool_host_t **hosts = (pool_host_t **)realloc(pool->hosts, sizeof(pool_host_t *) * capacity);
+
+        if (NULL == hosts)
+            return NULL;
+
+        pool->hosts = hosts;
+        pool->host_capacity = capacity;
+    }
+
+    if (NULL == (host = (pool_host_t *)calloc(1, sizeof(pool_host_t))))
+        return NULL;
+
+    if (NULL == (host->idle = (pool_idle_t *)malloc(sizeof(pool_idle_t) * pool->config.max_per_host)))
+    {
+        free(host);
+
+        return NULL;
+    }
+    memcpy(&host->addr, addr, addr_len);
+    host->addr_len = addr_len;
+    pool->hosts[pool->host_count++] = host;
+
+    return host;
+}
+
+static int __set_owner(sock_pool_t *pool, int fd, pool_host_t *host)
+{
+    if (fd >= pool->owner_capacity)
+    {
+        int capacity = (pool->owner_capacity > 0) ? pool->owner_capacity : 64;
+        pool_host_t **owners;
+
+        while (capacity <= fd)
+        {
+            capacity *= 2;
+        }
+
+        if (NULL == (owners = (pool_host_t **)realloc(pool->owners, sizeof(pool_host_t *) * capacity)))
+            return -SOCK_POOL_ERR_MEM_ALLOC;
+
+        memset(owners + pool->owner_capacity, 0, sizeof(pool_host_t *) * (capacity - pool->owner_capacity));
+        pool->owners = owners;
+        pool->owner_capacity = capacity;
+    }
+
+    pool->owners[fd] = host;
+
+    return 0;
+}
+
+int sock_pool_acquire(sock_pool_t *pool, const struct sockaddr *addr, size_t addr_len, int wait_ms)
+{
+    struct timespec deadline;
+    pool_host_t *host;
+    int fd = -1;
+    int err = 0;
+
+    if (NULL == addr || 0 == addr_len || addr_len > sizeof(struct sockaddr_storage))
+        return -SOCK_POOL_ERR_INVALID_PARAM;
+
+    if (wait_ms > 0)
+        __deadline_after(wait_ms, &deadline);
+
+    pthread_mutex_lock(&pool->lock);
+
+    if (NULL == (host = __find_or_add_host(pool, addr, addr_len)))
+    {
+        err = -SOCK_POOL_ERR_MEM_ALLOC;
+        goto ACQUIRE_END;
+    }
+
+    for (;;)
+    {
+        /* Lazy reconnection: idle connections closed by the peer are dropped here, and replaced below. */
+        while (host->idle_count > 0)
+        {
+            fd = host->idle[--host->idle_count].fd;
+            --pool->stats.idle;
+            if (__is_reusable(fd))
+            {
+                ++pool->stats.reuses;
+                goto ACQUIRE_END;
+            }
+
+            close(fd);
+            fd = -1;
+            --host->total;
+            ++pool->stats.drops;
+        }
+
+        if (host->total < pool->config.max_per_host)
+            break;
+
+        if (0 == wait_ms)
+        {
+            err = -SOCK_POOL_ERR_EXHAUSTED;
+            goto ACQUIRE_END;
+        }
+
+        if (wait_ms < 0)
+            pthread_cond_wait(&pool->released, &pool->lock);
+        else if (ETIMEDOUT == pthread_cond_timedwait(&pool->released, &pool->lock, &deadline)
+            && 0 == host->idle_count && host->total >= pool->config.max_per_host)
+        {
+            err = -SOCK_POOL_ERR_EXHAUSTED;
+            goto ACQUIRE_END;
+        }
+    }
+
+    /* The slot is taken before connecting, which is done without the lock. */
+    ++host->total;
+    pthread_mutex_unlock(&pool->lock);
+    fd = __connect(pool, host);
+    pthread_mutex_lock(&pool->lock);
+    if (fd < 0)
+    {
+        err = fd;
+        fd = -1;
+        --host->total;
+        pthread_cond_broadcast(&pool->released);
+    }
+    else
+        ++pool->stats.connects;
+
+ACQUIRE_END:
+
+    if (fd >= 0 && (err = __set_owner(pool, fd, host)) < 0)
+    {
+        close(fd);
+        --host->total;
+        pthread_cond_broadcast(&pool->released);
+    }
+    if (0 == err)
+        ++pool->stats.in_use;
+
+    pthread_mutex_unlock(&pool->lock);
+
+    return (err < 0) ? err : fd;
+}
+
+int sock_pool_release(sock_pool_t *pool, int fd, bool reusable)
+{
+    pool_host_t *host;
+
+    pthread_mutex_lock(&pool->lock);
+
+    if (fd < 0 || fd >= pool->owner_capacity || NULL == (host = pool->owners[fd]))
+    {
+        pthread_mutex_unlock(&pool->lock);
+
+        return -SOCK_POOL_ERR_INVALID_PARAM;
+    }
+
+    pool->owners[fd] = NULL;
+    --pool->stats.in_use;
+    if (reusable)
+    {
+        host->idle[host->idle_count].fd = fd;
+        host->idle[host->idle_count].since_ms = __now_ms();
+        host->idle[host->idle_count].stamp = ++pool->releases;
+        ++host->idle_count;
+        ++pool->stats.idle;
+    }
+    else
+    {
+        close(fd);
+        --host->total;
+    }
+    pthread_cond_broadcast(&pool->released);
+
+    pthread_mutex_unlock(&pool->lock);
+
+    return 0;
+}
+
+void sock_pool_get_stats(sock_pool_t *pool, sock_pool_stats_t *stats)
+{
+    pthread_mutex_lock(&pool->lock);
+    *stats = pool->stats;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+#ifdef TEST
+
+#include <stdio.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#include "sleeps.h"
+
+#define REQUEST_COUNT                       2000
+
+/* Answers each 4-byte request with the same 4 bytes, for each connection in a forked child. */
+static void serve(int listen_fd)
+{
+    for (;;)
+    {
+        int fd = accept(listen_fd, NULL, NULL);
+        char buf[4];
+
+        if (fd < 0)
+            break;
+
+        if (0 == fork())
+        {
+            close(listen_fd);
+            while (recv(fd, buf, sizeof(buf), MSG_WAITALL) == sizeof(buf) && send(fd, buf, sizeof(buf), 0) == sizeof(buf))
+            {
+                ;
+            }
+            _exit(0);
+        }
+        close(fd);
+    }
+    _exit(0);
+}
+
+static int request(int fd, unsigned int seq)
+{
+    unsigned int reply = 0;
+    int err = 0;
+
+    if (sock_send(fd, &seq, sizeof(seq), 0, &err) != sizeof(seq)
+        || sock_recv(fd, &reply, sizeof(reply), 0, &err) != sizeof(reply) || reply != seq)
+        return -1;
+
+    return 0;
+}
+
+static int test_requests(const struct sockaddr_in *addr)
+{
+    sock_pool_t *pool = sock_pool_create(NULL, NULL);
+    sock_pool_stats_t stats;
+    double begin = 0;
+    unsigned int i;
+    int ret = 0;
+
+    if (NULL == pool)
+        return -1;
+
+    /* Baseline: a new connection per request. */
+    begin = monotonic_milliseconds();
+    for (i = 0; i < REQUEST_COUNT && 0 == ret; ++i)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+        if (fd < 0 || sock_connect(fd, (const struct sockaddr *)addr, sizeof(*addr), 1000000) < 0 || request(fd, i) < 0)
+            ret = -1;
+        if (fd >= 0)
+            close(fd);
+    }
+    printf("%d requests with a connection each: %.3f ms\n", REQUEST_COUNT, (monotonic_milliseconds() - begin));
+
+    begin = monotonic_milliseconds();
+    for (i = 0; i < REQUEST_COUNT && 0 == ret; ++i)
+    {
+        int fd = sock_pool_acquire(pool, (const struct sockaddr *)addr, sizeof(*addr), 0);
+
+        if (fd < 0)
+        {
+            fprintf(stderr, "sock_pool_acquire() failed: %s\n", sock_pool_error(fd));
+            ret = -1;
+            break;
+        }
+
+        ret = request(fd, i);
+        sock_pool_release(pool, fd, (0 == ret));
+    }
+    printf("%d requests with pooled connections: %.3f ms\n", REQUEST_COUNT, (monotonic_milliseconds() - begin));
+
+    sock_pool_get_stats(pool, &stats);
+    if (0 == ret && (1 != stats.connects || REQUEST_COUNT - 1 != stats.reuses || 1 != stats.idle || 0 != stats.in_use))
+    {
+        fprintf(stderr, "Unexpected stats: %lu connects, %lu reuses, %lu idle, %lu in use\n",
+            (unsigned long)stats.connects, (unsigned long)stats.reuses, (unsigned long)stats.idle,
+            (unsigned long)stats.in_use);
+        ret = -1;
+    }
+    sock_pool_destroy(pool);
+
+    return ret;
+}
+
+static int listen_on_loopback(struct sockaddr_in *addr)
+{
+    socklen_t addr_len = sizeof(*addr);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd < 0 || bind(fd, (struct sockaddr *)addr, sizeof(*addr)) < 0 || listen(fd, 128) < 0
+        || getsockname(fd, (struct sockaddr *)addr, &addr_len) < 0)
+    {
+        perror("Failed to listen");
+        if (fd >= 0)
+            close(fd);
+
+        return -1;
+    }
+
+    return fd;
+}
+
+/* Connections are accepted but not served here, and closed by the "server" on purpose. */
+static int test_limit_and_liveness(void)
+{
+    sock_pool_config_t config = { 2, 0, 0, 50, false };
+    sock_pool_t *pool = NULL;
+    sock_pool_stats_t stats;
+    struct sockaddr_in addr;
+    int listen_fd = listen_on_loopback(&addr);
+    const struct sockaddr *paddr = (const struct sockaddr *)&addr;
+    int fds[3] = { -1, -1, -1 };
+    double begin = 0;
+    int ret = -1;
+    int i;
+
+    if (listen_fd < 0 || NULL == (pool = sock_pool_create(&config, NULL)))
+        goto TEST_END;
+
+    for (i = 0; i < 2; ++i)
+    {
+        if ((fds[i] = sock_pool_acquire(pool, paddr, sizeof(addr), 0)) < 0)
+            goto TEST_END;
+    }
+
+    begin = monotonic_milliseconds();
+    if ((fds[2] = sock_pool_acquire(pool, paddr, sizeof(addr), 100)) >= 0 || (monotonic_milliseconds() - begin) < 99)
+    {
+        fprintf(stderr, "A third connection is handed out beyond the limit, or too early: %d\n", fds[2]);
+        goto TEST_END;
+    }
+
+    /* Idle connections closed by the server should be found by the background checker. */
+    for (i = 0; i < 2; ++i)
+    {
+        sock_pool_release(pool, fds[i], true);
+        close(accept(listen_fd, NULL, NULL));
+    }
+    for (i = 0; i < 20; ++i)
+    {
+        sock_pool_get_stats(pool, &stats);
+        if (0 == stats.idle)
+            break;
+        usleep(50 * 1000);
+    }
+    if (2 != stats.drops || 0 != stats.idle)
+    {
+        fprintf(stderr, "Dead connections are not dropped in background: %lu drops, %lu idle\n",
+            (unsigned long)stats.drops, (unsigned long)stats.idle);
+        goto TEST_END;
+    }
+    sock_pool_destroy(pool);
+
+    /* Without the checker, a dead idle connection is replaced on acquisition. */
+    config.check_interval_ms = 0;
+    if (NULL == (pool = sock_pool_create(&config, NULL)) || (fds[0] = sock_pool_acquire(pool, paddr, sizeof(addr), 0)) < 0)
+        goto TEST_END;
+    sock_pool_release(pool, fds[0], true);
+    close(accept(listen_fd, NULL, NULL));
+    usleep(10 * 1000);
+    if ((fds[0] = sock_pool_acquire(pool, paddr, sizeof(addr), 0)) < 0)
+        goto TEST_END;
+    sock_pool_get_stats(pool, &stats);
+    if (2 != stats.connects || 1 != stats.drops || 0 != stats.reuses)
+    {
+        fprintf(stderr, "Dead connection is not replaced: %lu connects, %lu drops, %lu reuses\n",
+            (unsigned long)stats.connects, (unsigned long)stats.drops, (unsigned long)stats.reuses);
+        goto TEST_END;
+    }
+    sock_pool_release(pool, fds[0], false);
+    ret = 0;
+
+TEST_END:
+
+    sock_pool_destroy(pool);
+    if (listen_fd >= 0)
+        close(listen_fd);
+
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    struct sockaddr_in addr;
+    int listen_fd = listen_on_loopback(&addr);
+    pid_t server_pid = -1;
+    int ret = -1;
+
+    if (listen_fd >= 0 && 0 == (server_pid = fork()))
+        serve(listen_fd);
+    if (listen_fd >= 0)
+        close(listen_fd);
+
+    if (server_pid > 0 && 0 == test_requests(&addr) && 0 == test_limit_and_liveness())
+    {
+        printf("All tests passed.\n");
+        ret = 0;
+    }
+
+    if (server_pid > 0)
+    {
+        kill(server_pid, SIGTERM);
+        waitpid(server_pid, NULL, 0);
+    }
+
+    return ret;
+}
+
+#endif /* #ifdef TEST */
+
+#ifdef __cplusplus
+}
+#endif
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. Probe idle connections in sock_pool_check() without holding the pool lock.
+ */
+
@@ -0,0 +1,100 @@
+/*
+ * Pool of client-side TCP connections keyed by address, which reuses idle connections
+ * so that a request seldom pays for a handshake.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __SOCK_POOL_H__
+#define __SOCK_POOL_H__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sockaddr;
+
+typedef struct sock_pool_t sock_pool_t;
+
+typedef struct sock_pool_config_t
+{
+    size_t max_per_host; /* = 0 for 8. Limit of connections to an address, idle and in use. */
+    int connect_timeout_ms; /* = 0 for 3000, negative for infinity */
+    int idle_timeout_ms; /* Idle connections older than this are closed by checks, = 0 for never. */
+    int check_interval_ms; /* Interval of checks of idle connections in a background thread, = 0 for no thread. */
+    bool nonblocking; /* Whether connections handed out are non-blocking. */
+} sock_pool_config_t;
+
+typedef struct sock_pool_stats_t
+{
+    size_t connects; /* Connections established */
+    size_t reuses; /* Acquisitions served by idle connections */
+    size_t drops; /* Idle connections found dead or expired, and closed */
+    size_t idle;
+    size_t in_use;
+} sock_pool_stats_t;
+
+const char* sock_pool_error(int error_code);
+
+/* A NULL config means all defaults. */
+sock_pool_t* sock_pool_create(const sock_pool_config_t *nullable_config, int *nullable_error);
+
+/* Idle connections are closed, while those still acquired are left to their holders, who must not release them. */
+void sock_pool_destroy(sock_pool_t *pool);
+
+/*
+ * Hands out an idle connection to addr (compared byte by byte, so unused fields should be zeroed),
+ * the most recently used one first. Idle ones closed by the peer meanwhile are replaced with new connections.
+ * If max_per_host connections are all in use, it waits at most wait_ms milliseconds
+ * (0 for not waiting, negative for infinity) for one to be released.
+ * Returns the fd, or a negative error code.
+ */
+int sock_pool_acquire(sock_pool_t *pool, const struct sockaddr *addr, size_t addr_len, int wait_ms);
+
+/*
+ * Gives an acquired connection back. It should not be reusable (and is closed then)
+ * after an error, or if a response is not completely read.
+ */
+int sock_pool_release(sock_pool_t *pool, int fd, bool reusable);
+
+/*
+ * Checks all idle connections with sock_check_status() and a peek of incoming data,
+ * and closes those that are broken, closed by the peer, or expired.
+ * Probing is done without the pool lock, so acquisitions and releases are not held up meanwhile.
+ * It's what the background thread does. Returns the number of connections closed, or a negative error code.
+ */
+int sock_pool_check(sock_pool_t *pool);
+
+void sock_pool_get_stats(sock_pool_t *pool, sock_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __SOCK_POOL_H__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. Document that sock_pool_check() probes without the pool lock, and may fail.
+ */
+
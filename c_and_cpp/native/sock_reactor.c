@@ -0,0 +1,734 @@
+/*
+ * Edge-triggered epoll event loop with a timer wheel, for sockets (and other fds)
+ * driven by callbacks in one thread.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "sock_reactor.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum
+{
+    SOCK_REACTOR_ERR_UNKNOWN = 1
+    , SOCK_REACTOR_ERR_NOT_SUPPORTED
+    , SOCK_REACTOR_ERR_MEM_ALLOC
+    , SOCK_REACTOR_ERR_INVALID_PARAM
+    , SOCK_REACTOR_ERR_NOT_REGISTERED
+
+    , SOCK_REACTOR_ERR_END /* NOTE: All error codes should be defined ahead of this. */
+};
+
+static const char* const S_ERRORS[] = {
+    "Unknown error"
+    , "Not supported"
+    , "Failed to allocate memory"
+    , "Invalid parameter"
+    , "Not registered"
+};
+
+const char* sock_reactor_error(int error_code)
+{
+    if (error_code >= 0)
+        return "OK";
+
+    if (error_code <= -SOCK_REACTOR_ERR_END)
+        return strerror(-error_code - SOCK_REACTOR_ERR_END);
+
+    return S_ERRORS[-error_code - 1];
+}
+
+void sock_timer_init(sock_timer_t *timer, sock_timer_callback_t cb, void *cb_arg)
+{
+    timer->prev = NULL;
+    timer->next = NULL;
+    timer->expiry = 0;
+    timer->cb = cb;
+    timer->cb_arg = cb_arg;
+}
+
+int sock_timer_is_pending(const sock_timer_t *timer)
+{
+    return NULL != timer->next;
+}
+
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+
+#define SOCK_REACTOR_EVENTS_DEFAULT     256
+#define SOCK_REACTOR_WHEEL_SLOTS        1024 /* NOTE: Must be a power of 2. */
+#define SOCK_REACTOR_WHEEL_MASK         (SOCK_REACTOR_WHEEL_SLOTS - 1)
+
+typedef struct fd_slot_t
+{
+    sock_reactor_callback_t cb; /* NULL if not registered. */
+    void *cb_arg;
+    uint32_t gen; /* Tells stale events of a removed fd from those of a re-added one. */
+} fd_slot_t;
+
+struct sock_reactor_t
+{
+    int epfd;
+    int wakeup_fd;
+    int stopped;
+    int max_events;
+    struct epoll_event *events;
+    fd_slot_t *slots; /* Indexed by fd. */
+    size_t slot_count;
+    struct timespec base_time;
+    unsigned long current_tick; /* Timers up to this tick have been processed. */
+    size_t timer_count;
+    sock_timer_t wheel[SOCK_REACTOR_WHEEL_SLOTS]; /* Sentinels of circular lists. */
+};
+
+static unsigned long __now_tick(const sock_reactor_t *reactor)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - reactor->base_time.tv_sec) * 1000UL + now.tv_nsec / 1000000L - reactor->base_time.tv_nsec / 1000000L;
+}
+
+sock_reactor_t* sock_reactor_create(int max_events_per_wait, int *nullable_error)
+{
+    sock_reactor_t *reactor = (sock_reactor_t *)calloc(1, sizeof(sock_reactor_t));
+    struct epoll_event event;
+    int err = 0;
+    int i;
+
+    if (NULL == reactor)
+    {
+        err = -SOCK_REACTOR_ERR_MEM_ALLOC;
+        goto CREATE_END;
+    }
+
+    reactor->epfd = -1;
+    reactor->wakeup_fd = -1;
+    reactor->max_events = (max_events_per_wait > 0) ? max_events_per_wait : SOCK_REACTOR_EVENTS_DEFAULT;
+    clock_gettime(CLOCK_MONOTONIC, &reactor->base_time);
+    for (i = 0; i < SOCK_REACTOR_WHEEL_SLOTS; ++i)
+    {
+        reactor->wheel[i].prev = reactor->wheel[i].next = &reactor->wheel[i];
+    }
+
+    if (NULL == (reactor->events = (struct epoll_event *)malloc(sizeof(struct epoll_event) * reactor->max_events)))
+    {
+        err = -SOCK_REACTOR_ERR_MEM_ALLOC;
+        goto CREATE_END;
+    }
+
+    if ((reactor->epfd = epoll_create1(EPOLL_CLOEXEC)) < 0 || (reactor->wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+    {
+        err = -(errno + SOCK_REACTOR_ERR_END);
+        goto CREATE_END;
+    }
+
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u64 = (uint32_t)reactor->wakeup_fd; /* Generation 0, which no registered fd has. */
+    if (epoll_ctl(reactor->epfd, EPOLL_CTL_ADD, reactor->wakeup_fd, &event) < 0)
+        err = -(errno + SOCK_REACTOR_ERR_END);
+
+CREATE_END:
+
+    if (NULL != nullable_error)
+        *nullable_error = err;
+
+    if (err < 0)
+    {
+        sock_reactor_destroy(reactor);
+
+        return NULL;
+    }
+
+    return reactor;
+}
+
+void sock_reactor_destroy(sock_reactor_t *reactor)
+{
+    if (NULL == reactor)
+        return;
+
+    if (reactor->wakeup_fd >= 0)
+        close(reactor->wakeup_fd);
+
+    if (reactor->epfd >= 0)
+        close(reactor->epfd);
+
+    free(reactor->events);
+    free(reactor->slots);
+    free(reactor);
+}
+
+static uint32_t __to_epoll_events(int events)
+{
+    return EPOLLET | ((events & SOCK_STATUS_READABLE) ? (EPOLLIN | EPOLLRDHUP) : 0)
+        | ((events & SOCK_STATUS_WRITABLE) ? EPOLLOUT : 0);
+}
+
+int sock_reactor_add(sock_reactor_t *reactor, int fd, int events, sock_reactor_callback_t cb, void *cb_arg)
+{
+    struct epoll_event event;
+    fd_slot_t *slot = NULL;
+
+    if (fd < 0 || NULL == cb)
+        return -SOCK_REACTOR_ERR_INVALID_PARAM;
+
+    if ((size_t)fd >= reactor->slot_count)
+    {
+        size_t count = (0 == reactor->slot_count) ? 1024 : reactor->slot_count;
+        fd_slot_t *slots = NULL;
+
+        while (count <= (size_t)fd)
+        {
+            count *= 2;
+        }
+
+        if (NULL == (slots = (fd_slot_t *)realloc(reactor->slots, sizeof(fd_slot_t) * count)))
+            return -SOCK_REACTOR_ERR_MEM_ALLOC;
+
+        memset(slots + reactor->slot_count, 0, sizeof(fd_slot_t) * (count - reactor->slot_count));
+        reactor->slots = slots;
+        reactor->slot_count = count;
+    }
+
+    slot = &reactor->slots[fd];
+    if (0 == ++slot->gen)
+        slot->gen = 1;
+
+    memset(&event, 0, sizeof(event));
+    event.events = __to_epoll_events(events);
+    event.data.u64 = ((uint64_t)slot->gen << 32) | (uint32_t)fd;
+    if (epoll_ctl(reactor->epfd, EPOLL_CTL_ADD, fd, &event) < 0)
+        return -(errno + SOCK_REACTOR_ERR_END);
+
+    slot->cb = cb;
+    slot->cb_arg = cb_arg;
+
+    return 0;
+}
+
+int sock_reactor_modify(sock_reactor_t *reactor, int fd, int events)
+{
+    struct epoll_event event;
+
+    if (fd < 0 || (size_t)fd >= reactor->slot_count || NULL == reactor->slots[fd].cb)
+        return -SOCK_REACTOR_ERR_NOT_REGISTERED;
+
+    memset(&event, 0, sizeof(event));
+    event.events = __to_epoll_events(events);
+    event.data.u64 = ((uint64_t)reactor->slots[fd].gen << 32) | (uint32_t)fd;
+
+    return (epoll_ctl(reactor->epfd, EPOLL_CTL_MOD, fd, &event) < 0) ? -(errno + SOCK_REACTOR_ERR_END) : 0;
+}
+
+int sock_reactor_remove(sock_reactor_t *reactor, int fd)
+{
+    struct epoll_event event; /* Ignored, but must not be NULL for kernels before 2.6.9. */
+
+    if (fd < 0 || (size_t)fd >= reactor->slot_count || NULL == reactor->slots[fd].cb)
+        return -SOCK_REACTOR_ERR_NOT_REGISTERED;
+
+    reactor->slots[fd].cb = NULL; /* Events of it left in the current batch are skipped. */
+    reactor->slots[fd].cb_arg = NULL;
+
+    return (epoll_ctl(reactor->epfd, EPOLL_CTL_DEL, fd, &event) < 0) ? -(errno + SOCK_REACTOR_ERR_END) : 0;
+}
+
+/*
+ * ================
+ *  TIMER WHEEL
+ * ================
+ */
+
+static void __unlink_timer(sock_timer_t *timer)
+{
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->prev = timer->next = NULL;
+}
+
+static void __link_timer(sock_timer_t *head, sock_timer_t *timer)
+{
+    timer->prev = head->prev;
+    timer->next = head;
+    head->prev->next = timer;
+    head->prev = timer;
+}
+
+void sock_reactor_start_timer(sock_reactor_t *reactor, sock_timer_t *timer, unsigned int timeout_ms)
+{
+    unsigned long now = __now_tick(reactor);
+
+    sock_reactor_stop_timer(reactor, timer);
+
+    /*
+     * Never earlier than the ticks processed, otherwise it wouldn't be visited until the next round.
+     * And the current tick may be almost over, so one more tick keeps the timer from firing early.
+     */
+    timer->expiry = ((now > reactor->current_tick) ? now : reactor->current_tick) + timeout_ms + 1;
+    __link_timer(&reactor->wheel[timer->expiry & SOCK_REACTOR_WHEEL_MASK], timer);
+    reactor->timer_count += 1;
+}
+
+void sock_reactor_stop_timer(sock_reactor_t *reactor, sock_timer_t *timer)
+{
+    if (NULL == timer->next)
+        return;
+
+    __unlink_timer(timer);
+    reactor->timer_count -= 1;
+}
+
+/* Returns how long to wait for the next timer at most, which is a hint only. */
+static int __next_timer_ms(const sock_reactor_t *reactor, int timeout_ms)
+{
+    unsigned long now = __now_tick(reactor);
+    unsigned long tick;
+
+    if (0 == reactor->timer_count)
+        return timeout_ms;
+
+    for (tick = reactor->current_tick + 1; tick <= reactor->current_tick + SOCK_REACTOR_WHEEL_SLOTS; ++tick)
+    {
+        const sock_timer_t *head = &reactor->wheel[tick & SOCK_REACTOR_WHEEL_MASK];
+
+        if (head->next != head)
+        {
+            int wait_ms = (tick > now) ? (int)(tick - now) : 0;
+
+            return (timeout_ms >= 0 && timeout_ms < wait_ms) ? timeout_ms : wait_ms;
+        }
+    }
+
+    return timeout_ms; /* Not reachable since timer_count > 0. */
+}
+
+static int __process_timers(sock_reactor_t *reactor)
+{
+    sock_timer_t expired;
+    unsigned long now = __now_tick(reactor);
+    unsigned long tick = reactor->current_tick;
+    unsigned long last_tick = (now - tick > SOCK_REACTOR_WHEEL_SLOTS) ? (tick + SOCK_REACTOR_WHEEL_SLOTS) : now;
+    int count = 0;
+
+    if (0 == reactor->timer_count)
+    {
+        reactor->current_tick = now;
+
+        return 0;
+    }
+
+    /*
+     * Expired timers are moved into a separate list before any callback is called,
+     * since callbacks may start or stop timers, including the expired ones.
+     */
+    expired.prev = expired.next = &expired;
+    for (++tick; tick <= last_tick; ++tick)
+    {
+        sock_timer_t *head = &reactor->wheel[tick & SOCK_REACTOR_WHEEL_MASK];
+        sock_timer_t *timer = head->next;
+
+        while (timer != head)
+        {
+            sock_timer_t *next = timer->next;
+
+            if (timer->expiry <= now)
+            {
+                __unlink_timer(timer);
+                __link_timer(&expired, timer);
+            }
+            timer = next;
+        }
+    }
+    reactor->current_tick = now;
+
+    while (expired.next != &expired)
+    {
+        sock_timer_t *timer = expired.next;
+
+        __unlink_timer(timer);
+        reactor->timer_count -= 1;
+        timer->cb(reactor, timer, timer->cb_arg);
+        ++count;
+    }
+
+    return count;
+}
+
+/*
+ * ================
+ *  LOOP
+ * ================
+ */
+
+int sock_reactor_run_once(sock_reactor_t *reactor, int timeout_ms)
+{
+    int count = 0;
+    int ret = epoll_wait(reactor->epfd, reactor->events, reactor->max_events, __next_timer_ms(reactor, timeout_ms));
+    int i;
+
+    if (ret < 0 && EINTR != errno)
+        return -(errno + SOCK_REACTOR_ERR_END);
+
+    for (i = 0; i < ret; ++i)
+    {
+        uint32_t flags = reactor->events[i].events;
+        int fd = (int)(uint32_t)reactor->events[i].data.u64;
+        uint32_t gen = (uint32_t)(reactor->events[i].data.u64 >> 32);
+        fd_slot_t *slot = NULL;
+        int events = 0;
+
+        if (0 == gen) /* The wakeup fd */
+        {
+            uint64_t value;
+
+            if (read(reactor->wakeup_fd, &value, sizeof(value)) < 0 && !SOCK_SHOULD_TRY_LATER(errno))
+                return -(errno + SOCK_REACTOR_ERR_END);
+
+            continue;
+        }
+
+        slot = &reactor->slots[fd];
+        if (NULL == slot->cb || gen != slot->gen)
+            continue; /* Removed, or removed and added again by callbacks before. */
+
+        if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLPRI))
+            events |= SOCK_STATUS_READABLE;
+        if (flags & EPOLLOUT)
+            events |= SOCK_STATUS_WRITABLE;
+        if (flags & (EPOLLERR | EPOLLHUP))
+            events |= SOCK_STATUS_ABNORMAL;
+
+        slot->cb(reactor, fd, events, slot->cb_arg);
+        ++count;
+    }
+
+    return count + __process_timers(reactor);
+}
+
+int sock_reactor_run(sock_reactor_t *reactor)
+{
+    int ret = 0;
+
+    while (!__atomic_load_n(&reactor->stopped, __ATOMIC_ACQUIRE) && ret >= 0)
+    {
+        ret = sock_reactor_run_once(reactor, -1);
+    }
+    __atomic_store_n(&reactor->stopped, 0, __ATOMIC_RELEASE);
+
+    return (ret < 0) ? ret : 0;
+}
+
+int sock_reactor_stop(sock_reactor_t *reactor)
+{
+    __atomic_store_n(&reactor->stopped, 1, __ATOMIC_RELEASE);
+
+    return sock_reactor_wakeup(reactor);
+}
+
+int sock_reactor_wakeup(sock_reactor_t *reactor)
+{
+    uint64_t value = 1;
+
+    /* EAGAIN means the counter is about to overflow, so a wakeup is pending anyway. */
+    if (write(reactor->wakeup_fd, &value, sizeof(value)) < 0 && !SOCK_SHOULD_TRY_LATER(errno))
+        return -(errno + SOCK_REACTOR_ERR_END);
+
+    return 0;
+}
+
+#else /* Not Linux */
+
+sock_reactor_t* sock_reactor_create(int max_events_per_wait, int *nullable_error)
+{
+    if (NULL != nullable_error)
+        *nullable_error = -SOCK_REACTOR_ERR_NOT_SUPPORTED;
+
+    return NULL;
+}
+
+void sock_reactor_destroy(sock_reactor_t *reactor)
+{
+}
+
+int sock_reactor_add(sock_reactor_t *reactor, int fd, int events, sock_reactor_callback_t cb, void *cb_arg)
+{
+    return -SOCK_REACTOR_ERR_NOT_SUPPORTED;
+}
+
+int sock_reactor_modify(sock_reactor_t *reactor, int fd, int events)
+{
+    return -SOCK_REACTOR_ERR_NOT_SUPPORTED;
+}
+
+int sock_reactor_remove(sock_reactor_t *reactor, int fd)
+{
+    return -SOCK_REACTOR_ERR_NOT_SUPPORTED;
+}
+
+void sock_reactor_start_timer(sock_reactor_t *reactor, sock_timer_t *timer, unsigned int timeout_ms)
+{
+}
+
+void sock_reactor_stop_timer(sock_reactor_t *reactor, sock_timer_t *timer)
+{
+}
+
+int sock_reactor_run_once(sock_reactor_t *reactor, int timeout_ms)
+{
+    return -SOCK_REACTOR_ERR_NOT_SUPPORTED;
+}
+
+int sock_reactor_run(sock_reactor_t *reactor)
+{
+    return -SOCK_REACTOR_ERR_NOT_SUPPORTED;
+}
+
+int sock_reactor_stop(sock_reactor_t *reactor)
+{
+    return -SOCK_REACTOR_ERR_NOT_SUPPORTED;
+}
+
+int sock_reactor_wakeup(sock_reactor_t *reactor)
+{
+    return -SOCK_REACTOR_ERR_NOT_SUPPORTED;
+}
+
+#endif /* #if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__) */
+
+#ifdef TEST
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#include "sleeps.h"
+
+typedef struct echo_stats_t
+{
+    int echoed;
+    int closed;
+} echo_stats_t;
+
+/* Echoes until EAGAIN as required by edge triggering, and closes on hang-up. */
+static void on_echo(sock_reactor_t *reactor, int fd, int events, void *cb_arg)
+{
+    echo_stats_t *stats = (echo_stats_t *)cb_arg;
+    char buf[256];
+    ssize_t ret;
+
+    while ((ret = read(fd, buf, sizeof(buf))) > 0)
+    {
+        if (write(fd, buf, ret) == ret)
+            stats->echoed += 1;
+    }
+
+    if (0 == ret || (ret < 0 && !SOCK_SHOULD_TRY_LATER(errno)))
+    {
+        sock_reactor_remove(reactor, fd);
+        close(fd);
+        stats->closed += 1;
+    }
+}
+
+typedef struct timer_record_t
+{
+    sock_timer_t timer;
+    int id;
+    int *order;
+    int *fired;
+} timer_record_t;
+
+static void on_timer(sock_reactor_t *reactor, sock_timer_t *timer, void *cb_arg)
+{
+    timer_record_t *record = (timer_record_t *)cb_arg;
+
+    record->order[(*record->fired)++] = record->id;
+}
+
+static void* stop_later(void *reactor)
+{
+    struct timespec delay = { 0, 20 * 1000 * 1000 };
+
+    nanosleep(&delay, NULL);
+    sock_reactor_stop((sock_reactor_t *)reactor);
+
+    return NULL;
+}
+
+static int test_connections(sock_reactor_t *reactor)
+{
+    const int MAX_PAIRS = 10000;
+    struct rlimit limit;
+    echo_stats_t stats = { 0, 0 };
+    double begin = 0;
+    int (*pairs)[2] = NULL;
+    int pair_count = 0;
+    int i, err = 0;
+
+    /* Up to 10000 connections: twice as many fds as select() can handle at most. */
+    if (0 == getrlimit(RLIMIT_NOFILE, &limit))
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    pair_count = ((long)(limit.rlim_cur - 64) / 2 < MAX_PAIRS) ? (int)(limit.rlim_cur - 64) / 2 : MAX_PAIRS;
+
+    if (NULL == (pairs = (int (*)[2])calloc(pair_count, sizeof(int[2]))))
+        return -1;
+
+    for (i = 0; i < pair_count && 0 == err; ++i)
+    {
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, pairs[i]) < 0)
+        {
+            pair_count = i;
+            break;
+        }
+        err = sock_reactor_add(reactor, pairs[i][0], SOCK_STATUS_READABLE, on_echo, &stats);
+    }
+
+    begin = monotonic_milliseconds();
+    for (i = 0; i < pair_count && 0 == err; ++i)
+    {
+        if (write(pairs[i][1], "ping", 4) != 4)
+            err = -1;
+    }
+    while (0 == err && stats.echoed < pair_count)
+    {
+        if ((err = sock_reactor_run_once(reactor, 1000)) <= 0)
+            err = (0 == err) ? -ETIMEDOUT : err;
+        else
+            err = 0;
+    }
+    printf("Echoed %d connections in one thread: %.1f ms\n", stats.echoed, (monotonic_milliseconds() - begin));
+
+    for (i = 0; i < pair_count; ++i)
+    {
+        close(pairs[i][1]); /* The other end is closed by on_echo() on hang-up. */
+    }
+    while (0 == err && stats.closed < pair_count)
+    {
+        err = (sock_reactor_run_once(reactor, 1000) <= 0) ? -1 : 0;
+    }
+    free(pairs);
+
+    if (err < 0 || pair_count < 1024)
+        fprintf(stderr, "Echo test with %d connections failed: %s\n", pair_count, sock_reactor_error(err));
+
+    return (err < 0 || pair_count < 1024) ? -1 : 0;
+}
+
+static int test_timers(sock_reactor_t *reactor)
+{
+    const unsigned int TIMEOUTS[] = { 30, 10, 20, 2000, 15 };
+    timer_record_t records[5];
+    int order[5] = { 0 };
+    int fired = 0;
+    double begin = 0;
+    int i;
+
+    begin = monotonic_milliseconds();
+    for (i = 0; i < 5; ++i)
+    {
+        records[i].id = i;
+        records[i].order = order;
+        records[i].fired = &fired;
+        sock_timer_init(&records[i].timer, on_timer, &records[i]);
+        sock_reactor_start_timer(reactor, &records[i].timer, TIMEOUTS[i]);
+    }
+    sock_reactor_stop_timer(reactor, &records[4].timer);
+    sock_reactor_start_timer(reactor, &records[3].timer, 40); /* Restarted with a shorter timeout. */
+
+    while (fired < 4 && (monotonic_milliseconds() - begin) < 1000)
+    {
+        sock_reactor_run_once(reactor, -1);
+    }
+
+    if (4 != fired || 1 != order[0] || 2 != order[1] || 0 != order[2] || 3 != order[3]
+        || sock_timer_is_pending(&records[4].timer) || (monotonic_milliseconds() - begin) < 40)
+    {
+        fprintf(stderr, "Timers fired unexpectedly: %d fired, order: %d %d %d %d\n",
+            fired, order[0], order[1], order[2], order[3]);
+
+        return -1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int err = 0;
+    sock_reactor_t *reactor = sock_reactor_create(0, &err);
+    pthread_t tid;
+
+    if (NULL == reactor)
+    {
+        fprintf(stderr, "sock_reactor_create() failed: %s\n", sock_reactor_error(err));
+
+        return -1;
+    }
+
+    if (test_connections(reactor) < 0 || test_timers(reactor) < 0)
+        err = -1;
+    else if (0 != pthread_create(&tid, NULL, stop_later, reactor))
+        err = -1;
+    else
+    {
+        err = sock_reactor_run(reactor); /* Returns after stopped by the other thread. */
+        pthread_join(tid, NULL);
+    }
+
+    sock_reactor_destroy(reactor);
+
+    if (0 == err)
+        printf("All tests passed.\n");
+
+    return err;
+}
+
+#endif /* #ifdef TEST */
+
+#ifdef __cplusplus
+}
+#endif
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. Round the expiry of timers up by one tick, so that they never fire early.
+ */
+
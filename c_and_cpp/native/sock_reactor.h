@@ -0,0 +1,120 @@
+/*
+ * Edge-triggered epoll event loop with a timer wheel, for sockets (and other fds)
+ * driven by callbacks in one thread.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef __SOCK_REACTOR_H__
+#define __SOCK_REACTOR_H__
+
+#include "socket_supplements.h" /* For SOCK_STATUS_* bits. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct sock_reactor_t sock_reactor_t;
+
+/*
+ * Events are SOCK_STATUS_* bits. Since notifications are edge-triggered,
+ * the callback should read or write until SOCK_SHOULD_TRY_LATER(errno),
+ * otherwise it won't be called again for the data left.
+ * The fd may be removed or even closed within the callback.
+ */
+typedef void (*sock_reactor_callback_t)(sock_reactor_t *reactor, int fd, int events, void *cb_arg);
+
+typedef struct sock_timer_t sock_timer_t;
+
+typedef void (*sock_timer_callback_t)(sock_reactor_t *reactor, sock_timer_t *timer, void *cb_arg);
+
+/*
+ * Usually embedded in a per-connection struct, so that starting and stopping
+ * a timer needs no allocation. Fields are private: use sock_timer_*() instead.
+ */
+struct sock_timer_t
+{
+    sock_timer_t *prev;
+    sock_timer_t *next; /* NULL if not pending. */
+    unsigned long expiry; /* In ticks of milliseconds. */
+    sock_timer_callback_t cb;
+    void *cb_arg;
+};
+
+const char* sock_reactor_error(int error_code);
+
+sock_reactor_t* sock_reactor_create(int max_events_per_wait/* = 0 for 256 */, int *nullable_error);
+
+/* Registered fds are not closed, and pending timers are just dropped. */
+void sock_reactor_destroy(sock_reactor_t *reactor);
+
+/*
+ * Watches SOCK_STATUS_READABLE and/or SOCK_STATUS_WRITABLE of a non-blocking fd.
+ * SOCK_STATUS_ABNORMAL (error or hang-up) is always reported.
+ * Returns 0 on success or a negative error code.
+ */
+int sock_reactor_add(sock_reactor_t *reactor, int fd, int events, sock_reactor_callback_t cb, void *cb_arg);
+
+int sock_reactor_modify(sock_reactor_t *reactor, int fd, int events);
+
+/* Must be called before closing a registered fd. */
+int sock_reactor_remove(sock_reactor_t *reactor, int fd);
+
+void sock_timer_init(sock_timer_t *timer, sock_timer_callback_t cb, void *cb_arg);
+
+int sock_timer_is_pending(const sock_timer_t *timer);
+
+/*
+ * Fires the timer once after timeout_ms milliseconds, never earlier but maybe up to 1 ms later.
+ * A pending timer is restarted.
+ */
+void sock_reactor_start_timer(sock_reactor_t *reactor, sock_timer_t *timer, unsigned int timeout_ms);
+
+/* Does nothing if the timer is not pending. */
+void sock_reactor_stop_timer(sock_reactor_t *reactor, sock_timer_t *timer);
+
+/*
+ * Waits at most timeout_ms milliseconds (negative for infinity, but no later than the next timer)
+ * and dispatches events and expired timers.
+ * Returns the number of callbacks called, or a negative error code.
+ */
+int sock_reactor_run_once(sock_reactor_t *reactor, int timeout_ms);
+
+/* Runs until sock_reactor_stop() is called. Returns 0, or a negative error code. */
+int sock_reactor_run(sock_reactor_t *reactor);
+
+/* These two can be called by other threads. */
+
+int sock_reactor_stop(sock_reactor_t *reactor);
+
+/* Makes the waiting sock_reactor_run_once() return at once. */
+int sock_reactor_wakeup(sock_reactor_t *reactor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __SOCK_REACTOR_H__ */
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. State that timers never fire early.
+ */
+
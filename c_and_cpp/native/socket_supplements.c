@@ -1,7 +1,7 @@
 /*
  * Supplements to socket operation.
  *
- * Copyright (c) 2022 Man Hung-Coeng <udc577@126.com>
+ * Copyright (c) 2022-2026 Man Hung-Coeng <udc577@126.com>
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -19,12 +19,23 @@
 #include "socket_supplements.h"
 
 #include <errno.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/select.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <time.h>
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+#include <netinet/in.h>
+#include <sys/sendfile.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/errqueue.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -275,48 +286,1751 @@ size_t sock_recv(int fd, const void *buf, size_t len, int flags, int *nullable_s
     return handled_len;
 }
 
-#ifdef TEST
+/* Resumes where the last call stopped, since an iovec array may be handled partially. */
+typedef struct iov_cursor_t
+{
+    const struct iovec *iov;
+    int count;
+    int index;
+    size_t offset; /* Within iov[index] */
+} iov_cursor_t;
 
-#include <stdio.h>
+#define SOCK_IOV_BATCH                              64
 
-int main(int argc, char **argv)
+/* Copies at most SOCK_IOV_BATCH unhandled entries into batch, and returns the count. */
+static int __iov_cursor_fill(const iov_cursor_t *cursor, struct iovec *batch)
 {
-    printf("TODO: ...\n");
-    return 0;
+    int n = 0;
+    int i;
+
+    for (i = cursor->index; i < cursor->count && n < SOCK_IOV_BATCH; ++i)
+    {
+        size_t offset = (i == cursor->index) ? cursor->offset : 0;
+
+        if (cursor->iov[i].iov_len <= offset)
+            continue; /* Empty ones are skipped. */
+
+        batch[n].iov_base = (char *)cursor->iov[i].iov_base + offset;
+        batch[n].iov_len = cursor->iov[i].iov_len - offset;
+        ++n;
+    }
+
+    return n;
 }
 
-#endif /* #ifdef TEST */
+static void __iov_cursor_advance(iov_cursor_t *cursor, size_t len)
+{
+    while (cursor->index < cursor->count)
+    {
+        size_t left = cursor->iov[cursor->index].iov_len - cursor->offset;
 
-#ifdef __cplusplus
+        if (len < left)
+        {
+            cursor->offset += len;
+            break;
+        }
+
+        len -= left;
+        cursor->index += 1;
+        cursor->offset = 0;
+    }
+}
+
+static size_t __sock_transfer_v(int fd, const struct iovec *iov, int iov_count, int flags, int is_send,
+    int *nullable_standard_errno)
+{
+    iov_cursor_t cursor;
+    struct iovec batch[SOCK_IOV_BATCH];
+    struct msghdr msg;
+    size_t handled_len = 0;
+    int err;
+    int *err_ptr = nullable_standard_errno ? nullable_standard_errno : &err;
+
+    *err_ptr = 0;
+    cursor.iov = iov;
+    cursor.count = iov_count;
+    cursor.index = 0;
+    cursor.offset = 0;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = batch;
+
+    while ((msg.msg_iovlen = __iov_cursor_fill(&cursor, batch)) > 0)
+    {
+        ssize_t ret = is_send ? sendmsg(fd, &msg, flags) : recvmsg(fd, &msg, flags);
+
+        if ((ret < 0 && EINTR != errno) || 0 == ret)
+        {
+            *err_ptr = (0 == ret && !is_send) ? EPIPE : errno;
+            break;
+        }
+
+        if (ret > 0)
+        {
+            handled_len += ret;
+            __iov_cursor_advance(&cursor, ret);
+        }
+    }
+
+    return handled_len;
+}
+
+size_t sock_sendv(int fd, const struct iovec *iov, int iov_count, int flags, int *nullable_standard_errno)
+{
+    return __sock_transfer_v(fd, iov, iov_count, flags, 1, nullable_standard_errno);
+}
+
+size_t sock_recvv(int fd, const struct iovec *iov, int iov_count, int flags, int *nullable_standard_errno)
+{
+    return __sock_transfer_v(fd, iov, iov_count, flags, 0, nullable_standard_errno);
+}
+
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+
+/* Unlike sock_check_status(), poll() has no limit of FD_SETSIZE on the fd value. */
+static int __wait_for(int fd, short events, int timeout_usecs)
+{
+    struct pollfd pfd;
+    int ret;
+
+    pfd.fd = fd;
+    pfd.events = events;
+    pfd.revents = 0;
+    ret = poll(&pfd, 1, (timeout_usecs < 0) ? -1 : (timeout_usecs + 999) / 1000);
+
+    if (ret < 0)
+        return (EINTR == errno) ? 0 : -(errno + SOCK_ERR_END);
+
+    return ret;
+}
+
+int sock_recvmmsg(int fd, struct mmsghdr *msgs, unsigned int vlen, int flags, int timeout_usecs)
+{
+    int ret;
+
+    /*
+     * The timeout argument of recvmmsg() is only checked after a datagram arrives,
+     * so poll() is used to wait for the first one instead.
+     */
+    if (0 != timeout_usecs && (ret = __wait_for(fd, POLLIN, timeout_usecs)) <= 0)
+        return ret;
+
+    while ((ret = recvmmsg(fd, msgs, vlen, flags | MSG_DONTWAIT, NULL)) < 0)
+    {
+        if (SOCK_SHOULD_TRY_LATER(errno))
+            return 0;
+
+        if (EINTR != errno)
+            return -(errno + SOCK_ERR_END);
+    }
+
+    return ret;
+}
+
+int sock_sendmmsg(int fd, struct mmsghdr *msgs, unsigned int vlen, int flags, int timeout_usecs)
+{
+    struct timespec deadline;
+    unsigned int sent = 0;
+
+    if (timeout_usecs > 0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout_usecs / 1000000;
+        deadline.tv_nsec += (timeout_usecs % 1000000) * 1000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    while (sent < vlen)
+    {
+        int ret = sendmmsg(fd, msgs + sent, vlen - sent, flags | MSG_DONTWAIT);
+        int wait_usecs = timeout_usecs;
+
+        if (ret > 0)
+        {
+            sent += ret;
+            continue;
+        }
+
+        if (EINTR == errno)
+            continue;
+
+        if (!SOCK_SHOULD_TRY_LATER(errno))
+            return (sent > 0) ? (int)sent : -(errno + SOCK_ERR_END);
+
+        if (timeout_usecs > 0)
+        {
+            struct timespec now;
+
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            wait_usecs = (deadline.tv_sec - now.tv_sec) * 1000000 + (deadline.tv_nsec - now.tv_nsec) / 1000;
+            if (wait_usecs <= 0)
+                break;
+        }
+
+        if (0 == wait_usecs || (ret = __wait_for(fd, POLLOUT, wait_usecs)) < 0)
+            return (sent > 0 || 0 == wait_usecs) ? (int)sent : ret;
+    }
+
+    return sent;
 }
-#endif
 
 /*
  * ================
- *   CHANGE LOG
+ *  ZERO COPY
  * ================
- *
- * >>> 2022-02-20, Man Hung-Coeng:
- *  01. Create.
- *
- * >>> 2022-02-21, Man Hung-Coeng:
- *  01. Add sock_create(), sock_destroy(), sock_bind(), sock_listen()
- *      and sock_accept().
- *
- * >>> 2022-02-24, Man Hung-Coeng:
- *  01. Fix the incorrect error code of sock_recv()
- *      when the inside recv() returns 0.
- *
- * >>> 2022-02-25, Man Hung-Coeng:
- *  01. Add the handling of "Connection reset by peer" error for sock_recv().
- *
- * >>> 2022-03-27, Man Hung-Coeng:
- *  01. Rename the parameter nullable_error_code of sock_send() and sock_recv()
- *      to nullable_standard_errno, and change its meaning and value as well.
- *
- * >>> 2022-03-28, Man Hung-Coeng:
- *  01. Set value of argument nullable_standard_errno of sock_recv() to EPIPE
- *      when the underlying recv() returns 0, so as to let the caller know
- *      that the connection-oriented remote endpoint has shut down.
+ */
+
+size_t sock_sendfile(int sock_fd, int file_fd, off_t *nullable_offset, size_t count, int *nullable_standard_errno)
+{
+    size_t handled_len = 0;
+    int err;
+    int *err_ptr = nullable_standard_errno ? nullable_standard_errno : &err;
+
+    *err_ptr = 0;
+
+    while (handled_len < count)
+    {
+        ssize_t ret = sendfile(sock_fd, file_fd, nullable_offset, count - handled_len);
+
+        if ((ret < 0 && EINTR != errno) || 0 == ret)
+        {
+            *err_ptr = (0 == ret) ? 0 : errno;
+            break;
+        }
+
+        if (ret > 0)
+            handled_len += ret;
+    }
+
+    return handled_len;
+}
+
+int sock_relay_init(sock_relay_t *relay, size_t pipe_size)
+{
+    relay->pending = 0;
+    if (pipe2(relay->pipe_fds, O_CLOEXEC) < 0)
+        return -(errno + SOCK_ERR_END);
+
+    /* A bigger pipe means fewer splice() calls per byte. Failures (e.g., over the limit) are ignored. */
+    if (pipe_size > 0)
+        fcntl(relay->pipe_fds[1], F_SETPIPE_SZ, (int)pipe_size);
+
+    return 0;
+}
+
+void sock_relay_destroy(sock_relay_t *relay)
+{
+    close(relay->pipe_fds[0]);
+    close(relay->pipe_fds[1]);
+    relay->pipe_fds[0] = relay->pipe_fds[1] = -1;
+    relay->pending = 0;
+}
+
+size_t sock_relay(sock_relay_t *relay, int in_fd, int out_fd, size_t max_len, int *nullable_standard_errno)
+{
+    size_t handled_len = 0;
+    int err;
+    int *err_ptr = nullable_standard_errno ? nullable_standard_errno : &err;
+
+    *err_ptr = 0;
+
+    /* The pipe is drained before refilled, so neither end of it blocks. */
+    while (handled_len < max_len)
+    {
+        ssize_t ret;
+
+        if (relay->pending > 0)
+        {
+            ret = splice(relay->pipe_fds[0], NULL, out_fd, NULL,
+                (relay->pending < max_len - handled_len) ? relay->pending : max_len - handled_len, SPLICE_F_MOVE);
+            if (ret > 0)
+            {
+                relay->pending -= ret;
+                handled_len += ret;
+                continue;
+            }
+        }
+        else
+        {
+            ret = splice(in_fd, NULL, relay->pipe_fds[1], NULL, max_len - handled_len, SPLICE_F_MOVE);
+            if (ret > 0)
+            {
+                relay->pending += ret;
+                continue;
+            }
+
+            if (0 == ret)
+            {
+                *err_ptr = EPIPE;
+                break;
+            }
+        }
+
+        if (EINTR != errno)
+        {
+            *err_ptr = errno;
+            break;
+        }
+    }
+
+    return handled_len;
+}
+
+#else
+
+int sock_recvmmsg(int fd, struct mmsghdr *msgs, unsigned int vlen, int flags, int timeout_usecs)
+{
+    return -SOCK_ERR_NOT_SUPPORTED;
+}
+
+int sock_sendmmsg(int fd, struct mmsghdr *msgs, unsigned int vlen, int flags, int timeout_usecs)
+{
+    return -SOCK_ERR_NOT_SUPPORTED;
+}
+
+size_t sock_sendfile(int sock_fd, int file_fd, off_t *nullable_offset, size_t count, int *nullable_standard_errno)
+{
+    if (NULL != nullable_standard_errno)
+        *nullable_standard_errno = ENOSYS;
+
+    return 0;
+}
+
+int sock_relay_init(sock_relay_t *relay, size_t pipe_size)
+{
+    relay->pipe_fds[0] = relay->pipe_fds[1] = -1;
+    relay->pending = 0;
+
+    return -SOCK_ERR_NOT_SUPPORTED;
+}
+
+void sock_relay_destroy(sock_relay_t *relay)
+{
+}
+
+size_t sock_relay(sock_relay_t *relay, int in_fd, int out_fd, size_t max_len, int *nullable_standard_errno)
+{
+    if (NULL != nullable_standard_errno)
+        *nullable_standard_errno = ENOSYS;
+
+    return 0;
+}
+
+#endif /* #if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__) */
+
+#ifdef SO_ZEROCOPY
+
+typedef struct zc_record_t
+{
+    const void *buf;
+    size_t len;
+    sock_zerocopy_release_t cb; /* Never NULL until released */
+    void *cb_arg;
+    unsigned int first_seq; /* Each successful send() with MSG_ZEROCOPY takes a sequence number. */
+    unsigned int seq_count;
+    unsigned int done_count;
+    bool was_copied;
+} zc_record_t;
+
+struct sock_zerocopy_t
+{
+    int fd;
+    unsigned int next_seq;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    zc_record_t *records; /* Ring in sending order */
+};
+
+sock_zerocopy_t* sock_zerocopy_create(int fd, size_t max_pending, int *nullable_error)
+{
+    const int ENABLED = 1;
+    sock_zerocopy_t *zc = (sock_zerocopy_t *)calloc(1, sizeof(sock_zerocopy_t));
+    int err = 0;
+
+    if (NULL == zc)
+        err = -(ENOMEM + SOCK_ERR_END);
+    else if (setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &ENABLED, sizeof(ENABLED)) < 0)
+        err = (ENOPROTOOPT == errno || EOPNOTSUPP == errno) ? -SOCK_ERR_NOT_SUPPORTED : -(errno + SOCK_ERR_END);
+    else
+    {
+        zc->fd = fd;
+        zc->capacity = (0 == max_pending) ? 256 : max_pending;
+        if (NULL == (zc->records = (zc_record_t *)malloc(sizeof(zc_record_t) * zc->capacity)))
+            err = -(ENOMEM + SOCK_ERR_END);
+    }
+
+    if (NULL != nullable_error)
+        *nullable_error = err;
+
+    if (err < 0)
+    {
+        sock_zerocopy_destroy(zc);
+
+        return NULL;
+    }
+
+    return zc;
+}
+
+void sock_zerocopy_destroy(sock_zerocopy_t *zc)
+{
+    if (NULL == zc)
+        return;
+
+    free(zc->records);
+    free(zc);
+}
+
+static void __zerocopy_track(sock_zerocopy_t *zc, const void *buf, size_t len, unsigned int seq_count,
+    sock_zerocopy_release_t release_cb, void *cb_arg)
+{
+    zc_record_t *record = &zc->records[(zc->head + zc->count) % zc->capacity];
+
+    record->buf = buf;
+    record->len = len;
+    record->cb = release_cb;
+    record->cb_arg = cb_arg;
+    record->first_seq = zc->next_seq;
+    record->seq_count = seq_count;
+    record->done_count = 0;
+    record->was_copied = false;
+    zc->next_seq += seq_count;
+    zc->count += 1;
+}
+
+size_t sock_zerocopy_send(sock_zerocopy_t *zc, const void *buf, size_t len, int flags,
+    sock_zerocopy_release_t release_cb, void *cb_arg, int *nullable_standard_errno)
+{
+    size_t handled_len = 0;
+    unsigned int seq_count = 0;
+    int err;
+    int *err_ptr = nullable_standard_errno ? nullable_standard_errno : &err;
+
+    *err_ptr = 0;
+
+    if (NULL == release_cb)
+    {
+        *err_ptr = EINVAL;
+
+        return 0;
+    }
+
+    if (zc->count >= zc->capacity)
+    {
+        *err_ptr = ENOBUFS;
+
+        return 0;
+    }
+
+    while (handled_len < len)
+    {
+        int ret = send(zc->fd, (char *)buf + handled_len, len - handled_len, flags | MSG_ZEROCOPY);
+
+        if ((ret < 0 && EINTR != errno) || 0 == ret)
+        {
+            *err_ptr = errno;
+            break;
+        }
+
+        if (ret > 0)
+        {
+            handled_len += ret;
+            ++seq_count;
+        }
+    }
+
+    if (handled_len > 0)
+        __zerocopy_track(zc, buf, handled_len, seq_count, release_cb, cb_arg);
+
+    return handled_len;
+}
+
+/* Marks sequence numbers [lo, hi] done, which may be coalesced across records, and returns the number released. */
+static int __zerocopy_complete(sock_zerocopy_t *zc, unsigned int lo, unsigned int hi, bool was_copied)
+{
+    int released = 0;
+    unsigned int base, done_lo, done_hi;
+    size_t i;
+
+    if (0 == zc->count)
+        return 0;
+
+    /* Offsets to the first pending sequence number, so that wrapping around makes no difference. */
+    base = zc->records[zc->head].first_seq;
+    done_lo = lo - base;
+    done_hi = hi - base;
+    if (done_lo > done_hi)
+        done_lo = 0; /* The range begins before the first pending one, which is only possible if it's all done. */
+
+    for (i = 0; i < zc->count; ++i)
+    {
+        zc_record_t *record = &zc->records[(zc->head + i) % zc->capacity];
+        unsigned int record_lo = record->first_seq - base;
+        unsigned int record_hi = record_lo + record->seq_count - 1;
+
+        if (done_lo > record_hi || done_hi < record_lo || NULL == record->cb)
+            continue;
+
+        record->done_count += ((done_hi < record_hi) ? done_hi : record_hi) - ((done_lo > record_lo) ? done_lo : record_lo) + 1;
+        record->was_copied |= was_copied;
+        if (record->done_count >= record->seq_count)
+        {
+            sock_zerocopy_release_t cb = record->cb;
+
+            record->cb = NULL;
+            cb(record->buf, record->len, record->was_copied, record->cb_arg);
+            ++released;
+        }
+    }
+
+    while (zc->count > 0 && NULL == zc->records[zc->head].cb)
+    {
+        zc->head = (zc->head + 1) % zc->capacity;
+        zc->count -= 1;
+    }
+
+    return released;
+}
+
+int sock_zerocopy_reap(sock_zerocopy_t *zc, int timeout_usecs)
+{
+    int released = 0;
+    int ret;
+
+    /* Notifications raise POLLERR, which is always reported. */
+    if (0 != timeout_usecs && zc->count > 0 && (ret = __wait_for(zc->fd, 0, timeout_usecs)) < 0)
+        return ret;
+
+    for (;;)
+    {
+        char control[CMSG_SPACE(sizeof(struct sock_extended_err)) * 2];
+        struct msghdr msg;
+        struct cmsghdr *cmsg;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(zc->fd, &msg, MSG_ERRQUEUE) < 0)
+        {
+            if (EINTR == errno)
+                continue;
+
+            if (SOCK_SHOULD_TRY_LATER(errno))
+                break;
+
+            return -(errno + SOCK_ERR_END);
+        }
+
+        for (cmsg = CMSG_FIRSTHDR(&msg); NULL != cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            const struct sock_extended_err *ee = (const struct sock_extended_err *)CMSG_DATA(cmsg);
+
+            if (!((SOL_IP == cmsg->cmsg_level && IP_RECVERR == cmsg->cmsg_type)
+                || (SOL_IPV6 == cmsg->cmsg_level && IPV6_RECVERR == cmsg->cmsg_type))
+                || SO_EE_ORIGIN_ZEROCOPY != ee->ee_origin || 0 != ee->ee_errno)
+                continue;
+
+            released += __zerocopy_complete(zc, ee->ee_info, ee->ee_data, (ee->ee_code & SO_EE_CODE_ZEROCOPY_COPIED));
+        }
+    }
+
+    return released;
+}
+
+size_t sock_zerocopy_pending(const sock_zerocopy_t *zc)
+{
+    return zc->count;
+}
+
+#else
+
+sock_zerocopy_t* sock_zerocopy_create(int fd, size_t max_pending, int *nullable_error)
+{
+    if (NULL != nullable_error)
+        *nullable_error = -SOCK_ERR_NOT_SUPPORTED;
+
+    return NULL;
+}
+
+void sock_zerocopy_destroy(sock_zerocopy_t *zc)
+{
+}
+
+size_t sock_zerocopy_send(sock_zerocopy_t *zc, const void *buf, size_t len, int flags,
+    sock_zerocopy_release_t release_cb, void *cb_arg, int *nullable_standard_errno)
+{
+    if (NULL != nullable_standard_errno)
+        *nullable_standard_errno = ENOSYS;
+
+    return 0;
+}
+
+int sock_zerocopy_reap(sock_zerocopy_t *zc, int timeout_usecs)
+{
+    return -SOCK_ERR_NOT_SUPPORTED;
+}
+
+size_t sock_zerocopy_pending(const sock_zerocopy_t *zc)
+{
+    return 0;
+}
+
+#endif /* #ifdef SO_ZEROCOPY */
+
+typedef struct conn_ring_t
+{
+    char *data;
+    size_t size; /* Power of 2 */
+    size_t head; /* Free-running counters, where tail - head is the number of bytes in the ring. */
+    size_t tail;
+    bool mirrored;
+} conn_ring_t;
+
+struct sock_conn_t
+{
+    int fd;
+    conn_ring_t rx;
+    conn_ring_t tx;
+};
+
+#define CONN_DEFAULT_BUF_SIZE                       (64 * 1024)
+#define CONN_MIN_BUF_SIZE                           64
+
+#define RING_USED(ring)                             ((ring)->tail - (ring)->head)
+#define RING_FREE(ring)                             ((ring)->size - RING_USED(ring))
+#define RING_OFFSET(ring, counter)                  ((counter) & ((ring)->size - 1))
+
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+
+/* Maps a memory file twice back to back, so that accesses past the end wrap to the beginning. */
+static char* __map_mirrored(size_t size)
+{
+#ifdef SYS_memfd_create
+    int fd = syscall(SYS_memfd_create, "sock_conn", 1U/* MFD_CLOEXEC */);
+    char *base = (char *)MAP_FAILED;
+
+    if (fd < 0)
+        return NULL;
+
+    if (ftruncate(fd, size) < 0
+        || MAP_FAILED == (base = (char *)mmap(NULL, size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)))
+        goto MAP_END;
+
+    if (MAP_FAILED == mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0)
+        || MAP_FAILED == mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0))
+    {
+        munmap(base, size * 2);
+        base = (char *)MAP_FAILED;
+    }
+
+MAP_END:
+
+    close(fd);
+
+    return (MAP_FAILED == base) ? NULL : base;
+#else
+    return NULL;
+#endif
+}
+
+#endif
+
+static int __ring_init(conn_ring_t *ring, size_t size, bool mirrored)
+{
+    size_t actual_size = CONN_MIN_BUF_SIZE;
+
+    while (actual_size < size)
+    {
+        actual_size <<= 1;
+    }
+
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+    if (mirrored)
+    {
+        size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+        size_t mirrored_size = (actual_size < page_size) ? page_size : actual_size;
+
+        if (0 == (mirrored_size & (mirrored_size - 1)) && NULL != (ring->data = __map_mirrored(mirrored_size)))
+        {
+            ring->size = mirrored_size;
+            ring->mirrored = true;
+
+            return 0;
+        }
+    }
+#endif
+
+    if (NULL == (ring->data = (char *)malloc(actual_size)))
+        return -(ENOMEM + SOCK_ERR_END);
+
+    ring->size = actual_size;
+    ring->mirrored = false;
+
+    return 0;
+}
+
+static void __ring_destroy(conn_ring_t *ring)
+{
+    if (NULL == ring->data)
+        return;
+
+#if defined(__linux) || defined(__linux__) || defined(linux) || defined(__gnu_linux__)
+    if (ring->mirrored)
+    {
+        munmap(ring->data, ring->size * 2);
+
+        return;
+    }
+#endif
+
+    free(ring->data);
+}
+
+/* Describes used (or free) bytes of the ring with at most 2 iovec entries, and returns the count. */
+static int __ring_to_iov(const conn_ring_t *ring, bool used, struct iovec *iov)
+{
+    size_t begin = used ? ring->head : ring->tail;
+    size_t len = used ? RING_USED(ring) : RING_FREE(ring);
+    size_t offset = RING_OFFSET(ring, begin);
+
+    if (0 == len)
+        return 0;
+
+    iov[0].iov_base = ring->data + offset;
+    if (ring->mirrored || offset + len <= ring->size)
+    {
+        iov[0].iov_len = len;
+
+        return 1;
+    }
+
+    iov[0].iov_len = ring->size - offset;
+    iov[1].iov_base = ring->data;
+    iov[1].iov_len = len - iov[0].iov_len;
+
+    return 2;
+}
+
+static void __ring_put(conn_ring_t *ring, const void *buf, size_t len)
+{
+    size_t offset = RING_OFFSET(ring, ring->tail);
+    size_t first_len = (ring->mirrored || offset + len <= ring->size) ? len : ring->size - offset;
+
+    memcpy(ring->data + offset, buf, first_len);
+    memcpy(ring->data, (const char *)buf + first_len, len - first_len);
+    ring->tail += len;
+}
+
+sock_conn_t* sock_conn_create(int fd, size_t read_buf_size, size_t write_buf_size, bool mirrored, int *nullable_error)
+{
+    sock_conn_t *conn = (sock_conn_t *)calloc(1, sizeof(sock_conn_t));
+    int err = 0;
+
+    if (NULL == conn)
+        err = -(ENOMEM + SOCK_ERR_END);
+    else if ((err = __ring_init(&conn->rx, (0 == read_buf_size) ? CONN_DEFAULT_BUF_SIZE : read_buf_size, mirrored)) >= 0)
+        err = __ring_init(&conn->tx, (0 == write_buf_size) ? CONN_DEFAULT_BUF_SIZE : write_buf_size, mirrored);
+
+    if (NULL != nullable_error)
+        *nullable_error = err;
+
+    if (err < 0)
+    {
+        sock_conn_destroy(conn);
+
+        return NULL;
+    }
+
+    conn->fd = fd;
+
+    return conn;
+}
+
+void sock_conn_destroy(sock_conn_t *conn)
+{
+    if (NULL == conn)
+        return;
+
+    __ring_destroy(&conn->rx);
+    __ring_destroy(&conn->tx);
+    free(conn);
+}
+
+int sock_conn_fd(const sock_conn_t *conn)
+{
+    return conn->fd;
+}
+
+bool sock_conn_is_mirrored(const sock_conn_t *conn)
+{
+    return conn->rx.mirrored && conn->tx.mirrored;
+}
+
+size_t sock_conn_fill(sock_conn_t *conn, int *nullable_standard_errno)
+{
+    struct iovec iov[2];
+    int iov_count = __ring_to_iov(&conn->rx, false, iov);
+    ssize_t ret;
+    int err;
+    int *err_ptr = nullable_standard_errno ? nullable_standard_errno : &err;
+
+    *err_ptr = 0;
+
+    if (0 == iov_count)
+    {
+        *err_ptr = ENOBUFS;
+
+        return 0;
+    }
+
+    while ((ret = readv(conn->fd, iov, iov_count)) < 0 && EINTR == errno)
+    {
+        ;
+    }
+
+    if (ret <= 0)
+    {
+        *err_ptr = (0 == ret) ? EPIPE : errno;
+
+        return 0;
+    }
+
+    conn->rx.tail += ret;
+
+    return ret;
+}
+
+size_t sock_conn_readable(const sock_conn_t *conn)
+{
+    return RING_USED(&conn->rx);
+}
+
+const void* sock_conn_peek(const sock_conn_t *conn, size_t *len)
+{
+    struct iovec iov[2];
+
+    if (0 == __ring_to_iov(&conn->rx, true, iov))
+    {
+        *len = 0;
+
+        return conn->rx.data;
+    }
+
+    *len = iov[0].iov_len;
+
+    return iov[0].iov_base;
+}
+
+size_t sock_conn_copy(const sock_conn_t *conn, void *buf, size_t len)
+{
+    struct iovec iov[2];
+    int iov_count = __ring_to_iov(&conn->rx, true, iov);
+    size_t copied = 0;
+    int i;
+
+    for (i = 0; i < iov_count && copied < len; ++i)
+    {
+        size_t n = (iov[i].iov_len < len - copied) ? iov[i].iov_len : len - copied;
+
+        memcpy((char *)buf + copied, iov[i].iov_base, n);
+        copied += n;
+    }
+
+    return copied;
+}
+
+void sock_conn_consume(sock_conn_t *conn, size_t len)
+{
+    conn->rx.head += (len < RING_USED(&conn->rx)) ? len : RING_USED(&conn->rx);
+}
+
+size_t sock_conn_read(sock_conn_t *conn, void *buf, size_t len, int *nullable_standard_errno)
+{
+    size_t handled_len = sock_conn_copy(conn, buf, len);
+    int err;
+    int *err_ptr = nullable_standard_errno ? nullable_standard_errno : &err;
+
+    *err_ptr = 0;
+    sock_conn_consume(conn, handled_len);
+
+    /*
+     * The ring is empty now. The rest goes straight into buf, and whatever arrives beyond it
+     * lands in the ring, both with one readv().
+     */
+    while (handled_len < len)
+    {
+        struct iovec iov[3];
+        int iov_count;
+        ssize_t ret;
+
+        iov[0].iov_base = (char *)buf + handled_len;
+        iov[0].iov_len = len - handled_len;
+        iov_count = 1 + __ring_to_iov(&conn->rx, false, iov + 1);
+
+        ret = readv(conn->fd, iov, iov_count);
+        if ((ret < 0 && EINTR != errno) || 0 == ret)
+        {
+            *err_ptr = (0 == ret) ? EPIPE : errno;
+            break;
+        }
+
+        if (ret > 0)
+        {
+            if ((size_t)ret > len - handled_len)
+            {
+                conn->rx.tail += ret - (len - handled_len);
+                ret = len - handled_len;
+            }
+            handled_len += ret;
+        }
+    }
+
+    return handled_len;
+}
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL                                0
+#endif
+
+/* Like writev(), but never raises SIGPIPE when the peer has gone. */
+static ssize_t __conn_sendv(int fd, struct iovec *iov, int iov_count)
+{
+    struct msghdr msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iov_count;
+
+    return sendmsg(fd, &msg, MSG_NOSIGNAL);
+}
+
+size_t sock_conn_write(sock_conn_t *conn, const void *buf, size_t len, int *nullable_standard_errno)
+{
+    size_t handled_len = 0;
+    size_t n;
+    int err;
+    int *err_ptr = nullable_standard_errno ? nullable_standard_errno : &err;
+
+    *err_ptr = 0;
+
+    while (len - handled_len > RING_FREE(&conn->tx))
+    {
+        struct iovec iov[3];
+        int iov_count = __ring_to_iov(&conn->tx, true, iov);
+        size_t pending = RING_USED(&conn->tx);
+        ssize_t ret;
+
+        iov[iov_count].iov_base = (char *)buf + handled_len;
+        iov[iov_count].iov_len = len - handled_len;
+        ret = __conn_sendv(conn->fd, iov, iov_count + 1);
+        if ((ret < 0 && EINTR != errno) || 0 == ret)
+        {
+            *err_ptr = errno;
+            break;
+        }
+
+        if (ret > 0)
+        {
+            n = ((size_t)ret < pending) ? (size_t)ret : pending;
+            conn->tx.head += n;
+            handled_len += ret - n;
+        }
+    }
+
+    /* On errors, the part that fits is still taken, so that the caller resumes after it. */
+    n = (len - handled_len < RING_FREE(&conn->tx)) ? len - handled_len : RING_FREE(&conn->tx);
+    __ring_put(&conn->tx, (const char *)buf + handled_len, n);
+
+    return handled_len + n;
+}
+
+size_t sock_conn_flush(sock_conn_t *conn, int *nullable_standard_errno)
+{
+    size_t handled_len = 0;
+    int err;
+    int *err_ptr = nullable_standard_errno ? nullable_standard_errno : &err;
+
+    *err_ptr = 0;
+
+    while (RING_USED(&conn->tx) > 0)
+    {
+        struct iovec iov[2];
+        int iov_count = __ring_to_iov(&conn->tx, true, iov);
+        ssize_t ret = __conn_sendv(conn->fd, iov, iov_count);
+
+        if ((ret < 0 && EINTR != errno) || 0 == ret)
+        {
+            *err_ptr = errno;
+            break;
+        }
+
+        if (ret > 0)
+        {
+            conn->tx.head += ret;
+            handled_len += ret;
+        }
+    }
+
+    return handled_len;
+}
+
+size_t sock_conn_pending(const sock_conn_t *conn)
+{
+    return RING_USED(&conn->tx);
+}
+
+#ifdef TEST
+
+#include <stdio.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/wait.h>
+
+#include "sleeps.h"
+
+static int test_vectored_io(void)
+{
+    static char body[1024 * 1024];
+    char header[16] = "HEADER:";
+    char received_header[16];
+    static char received_body[sizeof(body)];
+    struct iovec send_iov[3];
+    struct iovec recv_iov[2];
+    size_t sent = 0;
+    size_t received = 0;
+    int send_err = 0;
+    int recv_err = 0;
+    int fds[2];
+    pid_t pid;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+        return -1;
+
+    memset(body, 'b', sizeof(body));
+    send_iov[0].iov_base = header;
+    send_iov[0].iov_len = sizeof(header);
+    send_iov[1].iov_base = NULL; /* Empty entries are fine. */
+    send_iov[1].iov_len = 0;
+    send_iov[2].iov_base = body;
+    send_iov[2].iov_len = sizeof(body);
+    recv_iov[0].iov_base = received_header;
+    recv_iov[0].iov_len = sizeof(received_header);
+    recv_iov[1].iov_base = received_body;
+    recv_iov[1].iov_len = sizeof(received_body);
+
+    /* The body is far bigger than the socket buffer, so both sides progress partially. */
+    if (0 == (pid = fork()))
+    {
+        close(fds[1]);
+        sent = sock_sendv(fds[0], send_iov, 3, 0, &send_err);
+        _exit((sizeof(header) + sizeof(body) == sent && 0 == send_err) ? 0 : 1);
+    }
+    close(fds[0]);
+    received = sock_recvv(fds[1], recv_iov, 2, 0, &recv_err);
+    close(fds[1]);
+    if (pid > 0)
+    {
+        int status = 0;
+
+        waitpid(pid, &status, 0);
+        send_err = (WIFEXITED(status) && 0 == WEXITSTATUS(status)) ? 0 : -1;
+    }
+
+    if (pid < 0 || send_err || recv_err || received != sizeof(header) + sizeof(body)
+        || 0 != memcmp(header, received_header, sizeof(header)) || 0 != memcmp(body, received_body, sizeof(body)))
+    {
+        fprintf(stderr, "Vectored I/O failed: %lu bytes received, errno: %d\n", (unsigned long)received, recv_err);
+
+        return -1;
+    }
+
+    return 0;
+}
+
+#define DATAGRAM_BATCH                              64
+#define DATAGRAM_ROUNDS                             2000
+
+static int test_batched_datagrams(void)
+{
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    struct mmsghdr msgs[DATAGRAM_BATCH];
+    struct iovec iovs[DATAGRAM_BATCH];
+    char bufs[DATAGRAM_BATCH][64];
+    double begin = 0;
+    int rx = sock_create(AF_INET, SOCK_DGRAM, 0, false);
+    int tx = sock_create(AF_INET, SOCK_DGRAM, 0, false);
+    int i, round, ret = 0;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (rx < 0 || tx < 0 || sock_bind(rx, false, (struct sockaddr *)&addr, sizeof(addr)) < 0
+        || getsockname(rx, (struct sockaddr *)&addr, &addr_len) < 0
+        || sock_connect(tx, (struct sockaddr *)&addr, sizeof(addr), 0) < 0)
+    {
+        ret = -1;
+        goto TEST_END;
+    }
+
+    if (0 != sock_recvmmsg(rx, msgs, DATAGRAM_BATCH, 0, 1000))
+    {
+        fprintf(stderr, "sock_recvmmsg() should time out with nothing received.\n");
+        ret = -1;
+        goto TEST_END;
+    }
+
+    begin = monotonic_milliseconds();
+    for (round = 0; round < DATAGRAM_ROUNDS && 0 == ret; ++round)
+    {
+        for (i = 0; i < DATAGRAM_BATCH; ++i)
+        {
+            memset(bufs[i], i, sizeof(bufs[i]));
+            if (send(tx, bufs[i], sizeof(bufs[i]), 0) < 0)
+                ret = -1;
+        }
+        for (i = 0; i < DATAGRAM_BATCH; ++i)
+        {
+            if (recv(rx, bufs[i], sizeof(bufs[i]), 0) != sizeof(bufs[i]))
+                ret = -1;
+        }
+    }
+    printf("%d datagrams with one syscall each: %.1f ms\n", DATAGRAM_BATCH * DATAGRAM_ROUNDS, (monotonic_milliseconds() - begin));
+
+    begin = monotonic_milliseconds();
+    for (round = 0; round < DATAGRAM_ROUNDS && 0 == ret; ++round)
+    {
+        int received = 0;
+
+        memset(msgs, 0, sizeof(msgs));
+        for (i = 0; i < DATAGRAM_BATCH; ++i)
+        {
+            memset(bufs[i], i, sizeof(bufs[i]));
+            iovs[i].iov_base = bufs[i];
+            iovs[i].iov_len = sizeof(bufs[i]);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        if (sock_sendmmsg(tx, msgs, DATAGRAM_BATCH, 0, 1000000) != DATAGRAM_BATCH)
+            ret = -1;
+
+        memset(bufs, 0, sizeof(bufs));
+        while (0 == ret && received < DATAGRAM_BATCH)
+        {
+            int n = sock_recvmmsg(rx, msgs + received, DATAGRAM_BATCH - received, 0, 1000000);
+
+            if (n <= 0)
+                ret = -1;
+            else
+                received += n;
+        }
+
+        for (i = 0; i < DATAGRAM_BATCH && 0 == ret; ++i)
+        {
+            if (sizeof(bufs[i]) != msgs[i].msg_len || i != bufs[i][0] || i != bufs[i][sizeof(bufs[i]) - 1])
+                ret = -1;
+        }
+    }
+    printf("%d datagrams in batches of %d: %.1f ms\n", DATAGRAM_BATCH * DATAGRAM_ROUNDS, DATAGRAM_BATCH, (monotonic_milliseconds() - begin));
+
+    if (ret < 0)
+        fprintf(stderr, "Batched datagrams failed at round %d.\n", round);
+
+TEST_END:
+
+    if (rx >= 0)
+        close(rx);
+    if (tx >= 0)
+        close(tx);
+
+    return ret;
+}
+
+#define STREAM_SIZE                                 (16 * 1024 * 1024)
+
+/* Reads everything from fd in a child process, which exits with 0 if the bytes are as generated. */
+static pid_t fork_verifying_reader(int fd, int *fds_to_close, int close_count)
+{
+    pid_t pid = fork();
+
+    if (0 == pid)
+    {
+        static char buf[64 * 1024];
+        size_t total = 0;
+        int bad = 0;
+        int i;
+
+        for (i = 0; i < close_count; ++i)
+        {
+            close(fds_to_close[i]);
+        }
+
+        for (;;)
+        {
+            ssize_t ret = read(fd, buf, sizeof(buf));
+
+            if (ret <= 0)
+                break;
+
+            for (i = 0; i < ret; ++i)
+            {
+                bad |= (buf[i] != (char)((total + i) % 251));
+            }
+            total += ret;
+        }
+        _exit((STREAM_SIZE == total && !bad) ? 0 : 1);
+    }
+
+    return pid;
+}
+
+static int wait_child(pid_t pid)
+{
+    int status = 0;
+
+    if (pid < 0 || waitpid(pid, &status, 0) < 0)
+        return -1;
+
+    return (WIFEXITED(status) && 0 == WEXITSTATUS(status)) ? 0 : -1;
+}
+
+static char* generate_stream(void)
+{
+    char *buf = (char *)malloc(STREAM_SIZE);
+    size_t i;
+
+    for (i = 0; NULL != buf && i < STREAM_SIZE; ++i)
+    {
+        buf[i] = (char)(i % 251);
+    }
+
+    return buf;
+}
+
+static int test_sendfile(const char *data)
+{
+    char path[] = "/tmp/sock_sendfile_XXXXXX";
+    int file_fd = mkstemp(path);
+    int fds[2] = { -1, -1 };
+    double begin = 0;
+    off_t offset = 0;
+    size_t sent = 0;
+    int err = 0;
+    pid_t pid;
+    int i, ret = 0;
+
+    if (file_fd < 0 || write(file_fd, data, STREAM_SIZE) != STREAM_SIZE)
+    {
+        perror("Failed to prepare a file for sock_sendfile()");
+        ret = -1;
+        goto TEST_END;
+    }
+
+    /* Compared with reading into user space and sending with sock_send(). */
+    for (i = 0; i < 2 && 0 == ret; ++i)
+    {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+        {
+            ret = -1;
+            break;
+        }
+        pid = fork_verifying_reader(fds[1], fds, 1);
+        close(fds[1]);
+
+        begin = monotonic_milliseconds();
+        if (0 == i)
+        {
+            static char buf[64 * 1024];
+            ssize_t len;
+
+            lseek(file_fd, 0, SEEK_SET);
+            for (sent = 0; 0 == err && (len = read(file_fd, buf, sizeof(buf))) > 0; sent += len)
+            {
+                sock_send(fds[0], buf, len, 0, &err);
+            }
+        }
+        else
+        {
+            offset = 0;
+            sent = sock_sendfile(fds[0], file_fd, &offset, STREAM_SIZE + 1, &err); /* One more byte to hit EOF */
+        }
+        close(fds[0]);
+        if (wait_child(pid) < 0 || STREAM_SIZE != sent || 0 != err || (1 == i && STREAM_SIZE != offset))
+        {
+            fprintf(stderr, "%s failed: %lu bytes sent, errno: %d\n",
+                (0 == i) ? "read() + sock_send()" : "sock_sendfile()", (unsigned long)sent, err);
+            ret = -1;
+        }
+        printf("%d MiB with %s: %.1f ms\n", STREAM_SIZE >> 20, (0 == i) ? "read() + sock_send()" : "sock_sendfile()",
+            (monotonic_milliseconds() - begin));
+    }
+
+TEST_END:
+
+    if (file_fd >= 0)
+    {
+        close(file_fd);
+        unlink(path);
+    }
+
+    return ret;
+}
+
+static int test_relay(const char *data)
+{
+    sock_relay_t relay;
+    int src[2] = { -1, -1 };
+    int dst[2] = { -1, -1 };
+    int fds_to_close[3];
+    size_t relayed = 0;
+    int err = 0;
+    pid_t writer, reader;
+    int ret = 0;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, src) < 0 || socketpair(AF_UNIX, SOCK_STREAM, 0, dst) < 0
+        || sock_relay_init(&relay, 1024 * 1024) < 0)
+        return -1;
+
+    /* Writer -> src[0] ~ src[1] -> relay -> dst[0] ~ dst[1] -> reader */
+    if (0 == (writer = fork()))
+    {
+        close(src[1]);
+        close(dst[0]);
+        close(dst[1]);
+        _exit((STREAM_SIZE == sock_send(src[0], data, STREAM_SIZE, 0, NULL)) ? 0 : 1);
+    }
+    fds_to_close[0] = src[0];
+    fds_to_close[1] = src[1];
+    fds_to_close[2] = dst[0];
+    reader = fork_verifying_reader(dst[1], fds_to_close, 3);
+    close(src[0]);
+    close(dst[1]);
+
+    while (0 == err)
+    {
+        relayed += sock_relay(&relay, src[1], dst[0], 256 * 1024, &err);
+    }
+    close(src[1]);
+    close(dst[0]);
+    sock_relay_destroy(&relay);
+
+    if (wait_child(writer) < 0 || wait_child(reader) < 0 || EPIPE != err || STREAM_SIZE != relayed)
+    {
+        fprintf(stderr, "sock_relay() failed: %lu bytes relayed, errno: %d\n", (unsigned long)relayed, err);
+        ret = -1;
+    }
+
+    return ret;
+}
+
+typedef struct release_stats_t
+{
+    size_t buffers;
+    size_t bytes;
+    bool was_copied;
+} release_stats_t;
+
+static void on_release(const void *buf, size_t len, bool was_copied, void *cb_arg)
+{
+    release_stats_t *stats = (release_stats_t *)cb_arg;
+
+    stats->buffers += 1;
+    stats->bytes += len;
+    stats->was_copied |= was_copied;
+}
+
+#ifdef SO_ZEROCOPY
+/* Completion ranges may be coalesced across records, and sequence numbers may wrap around. */
+static int test_zerocopy_completion(void)
+{
+    const unsigned int SEQ_COUNTS[] = { 2, 1, 2 };
+    zc_record_t records[4];
+    sock_zerocopy_t zc;
+    release_stats_t stats = { 0, 0, false };
+    char buf[8] = { 0 };
+    size_t i;
+
+    memset(&zc, 0, sizeof(zc));
+    zc.capacity = sizeof(records) / sizeof(records[0]);
+    zc.records = records;
+    zc.head = zc.capacity - 1;
+    zc.next_seq = (unsigned int)-2;
+    for (i = 0; i < sizeof(SEQ_COUNTS) / sizeof(SEQ_COUNTS[0]); ++i)
+    {
+        __zerocopy_track(&zc, buf, SEQ_COUNTS[i], SEQ_COUNTS[i], on_release, &stats);
+    }
+
+    /* Done out of order, which is kept until the ones ahead are done. */
+    if (1 != __zerocopy_complete(&zc, 1, 2, false) || 3 != sock_zerocopy_pending(&zc)
+        || 2 != __zerocopy_complete(&zc, (unsigned int)-2, 0, true) || 0 != sock_zerocopy_pending(&zc)
+        || 3 != stats.buffers || 5 != stats.bytes || !stats.was_copied)
+    {
+        fprintf(stderr, "Zero copy completion failed: %lu buffers released\n", (unsigned long)stats.buffers);
+
+        return -1;
+    }
+
+    return 0;
+}
+#else
+#define test_zerocopy_completion()                  0
+#endif
+
+static int test_zerocopy(const char *data)
+{
+    const size_t CHUNK_SIZE = 256 * 1024;
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    release_stats_t stats = { 0, 0, false };
+    sock_zerocopy_t *zc = NULL;
+    int listen_fd = sock_create(AF_INET, SOCK_STREAM, 0, false);
+    int fds[2] = { -1, -1 };
+    size_t sent = 0;
+    size_t sends = 0;
+    int err = 0;
+    pid_t pid = -1;
+    int ret = 0;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (listen_fd < 0 || sock_bind(listen_fd, false, (struct sockaddr *)&addr, sizeof(addr)) < 0
+        || sock_listen(listen_fd, 1) < 0 || getsockname(listen_fd, (struct sockaddr *)&addr, &addr_len) < 0
+        || (fds[0] = sock_create(AF_INET, SOCK_STREAM, 0, false)) < 0
+        || sock_connect(fds[0], (struct sockaddr *)&addr, sizeof(addr), 0) < 0
+        || (fds[1] = accept(listen_fd, NULL, NULL)) < 0)
+    {
+        ret = -1;
+        goto TEST_END;
+    }
+
+    if (NULL == (zc = sock_zerocopy_create(fds[0], 0, &err)))
+    {
+        printf("Zero copy skipped: %s\n", sock_error(err));
+        goto TEST_END;
+    }
+
+    if (0 != sock_zerocopy_send(zc, data, 1, 0, NULL, NULL, &err) || EINVAL != err)
+    {
+        fprintf(stderr, "Zero copy without a release callback should fail with EINVAL.\n");
+        ret = -1;
+        goto TEST_END;
+    }
+
+    pid = fork_verifying_reader(fds[1], fds, 1);
+    close(fds[1]);
+    fds[1] = -1;
+
+    while (sent < STREAM_SIZE && 0 == ret)
+    {
+        size_t len = (STREAM_SIZE - sent < CHUNK_SIZE) ? STREAM_SIZE - sent : CHUNK_SIZE;
+        size_t ret_len = sock_zerocopy_send(zc, data + sent, len, 0, on_release, &stats, &err);
+
+        sends += (ret_len > 0);
+        sent += ret_len;
+        if (ENOBUFS == err)
+            ret = (sock_zerocopy_reap(zc, -1) < 0) ? -1 : 0; /* Too many pending, or out of the optmem limit */
+        else if (0 != err)
+            ret = -1;
+    }
+    shutdown(fds[0], SHUT_WR);
+    while (0 == ret && sock_zerocopy_pending(zc) > 0)
+    {
+        if (sock_zerocopy_reap(zc, 1000000) <= 0)
+            ret = -1;
+    }
+    printf("Zero copy: %lu buffers sent and released (%s by the kernel).\n", (unsigned long)stats.buffers,
+        stats.was_copied ? "copied" : "not copied");
+
+    if (wait_child(pid) < 0 || STREAM_SIZE != sent || sends != stats.buffers || STREAM_SIZE != stats.bytes)
+    {
+        fprintf(stderr, "Zero copy failed: %lu bytes sent, %lu bytes released, errno: %d\n",
+            (unsigned long)sent, (unsigned long)stats.bytes, err);
+        ret = -1;
+    }
+
+TEST_END:
+
+    sock_zerocopy_destroy(zc);
+    if (listen_fd >= 0)
+        close(listen_fd);
+    if (fds[0] >= 0)
+        close(fds[0]);
+    if (fds[1] >= 0)
+        close(fds[1]);
+
+    return ret;
+}
+
+#define RECORD_COUNT                                100000
+#define RECORD_MAX_LEN                              300
+
+/* Each record is a 2-byte length followed by that many bytes derived from the index. */
+static unsigned short record_len(size_t index)
+{
+    return (unsigned short)(index % RECORD_MAX_LEN + 1);
+}
+
+static char record_byte(size_t index, size_t offset)
+{
+    return (char)((index + offset) & 0xff);
+}
+
+/* Writes all records field by field through a small write ring in a child process. */
+static pid_t fork_record_writer(int fd, int close_fd)
+{
+    pid_t pid = fork();
+
+    if (0 == pid)
+    {
+        sock_conn_t *conn = sock_conn_create(fd, 0, 4096, false, NULL);
+        char payload[RECORD_MAX_LEN];
+        size_t i;
+        size_t j;
+        int err = 0;
+
+        close(close_fd);
+        for (i = 0; NULL != conn && i < RECORD_COUNT && 0 == err; ++i)
+        {
+            unsigned short len = record_len(i);
+
+            for (j = 0; j < len; ++j)
+            {
+                payload[j] = record_byte(i, j);
+            }
+            sock_conn_write(conn, &len, sizeof(len), &err);
+            if (0 == err)
+                sock_conn_write(conn, payload, len, &err);
+        }
+        if (NULL != conn && 0 == err)
+            sock_conn_flush(conn, &err);
+        _exit((NULL != conn && 0 == err && 0 == sock_conn_pending(conn)) ? 0 : 1);
+    }
+
+    return pid;
+}
+
+static int verify_record(size_t index, const char *payload, unsigned short len)
+{
+    size_t i;
+
+    if (record_len(index) != len)
+        return -1;
+
+    for (i = 0; i < len; ++i)
+    {
+        if (payload[i] != record_byte(index, i))
+            return -1;
+    }
+
+    return 0;
+}
+
+/* mode: 0 for sock_recv() field by field, 1 for sock_conn_read(), 2 for peeking into a mirrored ring. */
+static int test_record_parsing(int mode)
+{
+    static const char *S_MODE_NAMES[] = { "sock_recv()", "sock_conn_read()", "sock_conn_peek()" };
+    sock_conn_t *conn = NULL;
+    char payload[RECORD_MAX_LEN];
+    size_t fills = 0;
+    size_t i = 0;
+    int err = 0;
+    int fds[2];
+    pid_t pid;
+    double begin = 0;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+        return -1;
+
+    /* A small read ring wraps often, to cover data split across its end. */
+    if (mode > 0 && NULL == (conn = sock_conn_create(fds[0], 4096, 0, (2 == mode), &err)))
+    {
+        fprintf(stderr, "sock_conn_create() failed: %s\n", sock_error(err));
+        close(fds[0]);
+        close(fds[1]);
+
+        return -1;
+    }
+
+    begin = monotonic_milliseconds();
+    pid = fork_record_writer(fds[1], fds[0]);
+    close(fds[1]);
+
+    for (i = 0; i < RECORD_COUNT && 0 == err; ++i)
+    {
+        unsigned short len = 0;
+
+        if (0 == mode)
+        {
+            if (sock_recv(fds[0], &len, sizeof(len), 0, &err) == sizeof(len))
+                sock_recv(fds[0], payload, len, 0, &err);
+            fills += 2;
+        }
+        else if (1 == mode)
+        {
+            if (sock_conn_read(conn, &len, sizeof(len), &err) == sizeof(len))
+                sock_conn_read(conn, payload, len, &err);
+        }
+        else
+        {
+            const char *data;
+            size_t readable = 0;
+
+            while (0 == err && ((readable = sock_conn_readable(conn)) < sizeof(len)
+                || sock_conn_copy(conn, &len, sizeof(len)) + len > readable))
+            {
+                sock_conn_fill(conn, &err);
+                ++fills;
+            }
+            if (0 != err)
+                break;
+
+            data = (const char *)sock_conn_peek(conn, &readable);
+            if (readable != sock_conn_readable(conn))
+            {
+                fprintf(stderr, "Peeked %lu bytes of %lu readable ones from a mirrored ring\n",
+                    (unsigned long)readable, (unsigned long)sock_conn_readable(conn));
+                err = -1;
+                break;
+            }
+            memcpy(payload, data + sizeof(len), len);
+            sock_conn_consume(conn, sizeof(len) + len);
+        }
+
+        if (0 == err && verify_record(i, payload, len) < 0)
+        {
+            fprintf(stderr, "Record %lu is corrupted\n", (unsigned long)i);
+            err = -1;
+        }
+    }
+    if (1 == mode)
+        printf("[%s] %d records parsed in %.3f ms.\n", S_MODE_NAMES[mode], RECORD_COUNT, (monotonic_milliseconds() - begin));
+    else
+    {
+        printf("[%s] %d records parsed in %.3f ms with %lu reads.\n", S_MODE_NAMES[mode], RECORD_COUNT,
+            (monotonic_milliseconds() - begin), (unsigned long)fills);
+    }
+
+    sock_conn_destroy(conn);
+    close(fds[0]);
+
+    if (wait_child(pid) < 0 || 0 != err || RECORD_COUNT != i)
+    {
+        fprintf(stderr, "Record parsing with %s failed: %lu records parsed, error: %d\n",
+            S_MODE_NAMES[mode], (unsigned long)i, err);
+
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_conn_closed_peer(void)
+{
+    static char buf[CONN_MIN_BUF_SIZE * 2];
+    sock_conn_t *conn = NULL;
+    size_t written = 0;
+    int write_err = 0;
+    int flush_err = 0;
+    int fds[2];
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+        return -1;
+
+    close(fds[1]);
+    if (NULL == (conn = sock_conn_create(fds[0], 0, CONN_MIN_BUF_SIZE, false, &write_err)))
+    {
+        close(fds[0]);
+        fprintf(stderr, "sock_conn_create() failed: %s\n", sock_error(write_err));
+
+        return -1;
+    }
+
+    /* It doesn't fit into the write ring, so it's sent at once, and SIGPIPE would kill the process. */
+    written = sock_conn_write(conn, buf, sizeof(buf), &write_err);
+    sock_conn_flush(conn, &flush_err);
+    sock_conn_destroy(conn);
+    close(fds[0]);
+
+    if (EPIPE != write_err || EPIPE != flush_err || written >= sizeof(buf))
+    {
+        fprintf(stderr, "Writing to a closed peer failed: %lu bytes written, errno: %d, %d\n",
+            (unsigned long)written, write_err, flush_err);
+
+        return -1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    char *data = generate_stream();
+    int ret = 0;
+
+    if (NULL == data || test_vectored_io() < 0 || test_batched_datagrams() < 0
+        || test_sendfile(data) < 0 || test_relay(data) < 0 || test_zerocopy_completion() < 0 || test_zerocopy(data) < 0
+        || test_record_parsing(0) < 0 || test_record_parsing(1) < 0 || test_record_parsing(2) < 0
+        || test_conn_closed_peer() < 0)
+        ret = -1;
+    else
+        printf("All tests passed.\n");
+
+    free(data);
+
+    return ret;
+}
+
+#endif /* #ifdef TEST */
+
+#ifdef __cplusplus
+}
+#endif
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2022-02-20, Man Hung-Coeng:
+ *  01. Create.
+ *
+ * >>> 2022-02-21, Man Hung-Coeng:
+ *  01. Add sock_create(), sock_destroy(), sock_bind(), sock_listen()
+ *      and sock_accept().
+ *
+ * >>> 2022-02-24, Man Hung-Coeng:
+ *  01. Fix the incorrect error code of sock_recv()
+ *      when the inside recv() returns 0.
+ *
+ * >>> 2022-02-25, Man Hung-Coeng:
+ *  01. Add the handling of "Connection reset by peer" error for sock_recv().
+ *
+ * >>> 2022-03-27, Man Hung-Coeng:
+ *  01. Rename the parameter nullable_error_code of sock_send() and sock_recv()
+ *      to nullable_standard_errno, and change its meaning and value as well.
+ *
+ * >>> 2022-03-28, Man Hung-Coeng:
+ *  01. Set value of argument nullable_standard_errno of sock_recv() to EPIPE
+ *      when the underlying recv() returns 0, so as to let the caller know
+ *      that the connection-oriented remote endpoint has shut down.
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Add sock_sendv() and sock_recvv() which resume partial progress,
+ *      and sock_recvmmsg() and sock_sendmmsg() for batches of datagrams.
+ *  02. Replace the placeholder test with tests of the functions above.
+ *  03. Add zero-copy helpers: sock_sendfile(), sock_relay*() and sock_zerocopy*().
+ *  04. Add sock_conn_*() for buffered reading and writing through ring buffers,
+ *      optionally mirrored by mapping memory twice.
+ *  05. Reject a NULL release callback of sock_zerocopy_send(), which used to
+ *      mark its buffer released before its completion.
+ *  06. Send with sendmsg() and MSG_NOSIGNAL instead of writev() in sock_conn_write()
+ *      and sock_conn_flush(), so that a closed peer doesn't raise SIGPIPE.
  */
 
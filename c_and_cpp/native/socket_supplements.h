@@ -1,7 +1,7 @@
 /*
  * Supplements to socket operation.
  *
- * Copyright (c) 2022 Man Hung-Coeng <udc577@126.com>
+ * Copyright (c) 2022-2026 Man Hung-Coeng <udc577@126.com>
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -21,12 +21,15 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <sys/types.h> /* For off_t */
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct sockaddr;
+struct iovec;
+struct mmsghdr;
 typedef void* socklen_ptr_t; /* The argument type should be "socklen_t *". */
 
 enum
@@ -102,6 +105,173 @@ size_t sock_send(int fd, const void *buf, size_t len, int flags, int *nullable_s
 /* EXTRA: For a connection-oriented socket, return value of 0 and errno of EPIPE means (orderly) shutdown. */
 size_t sock_recv(int fd, const void *buf, size_t len, int flags, int *nullable_standard_errno);
 
+/*
+ * Scatter/gather versions of sock_send() and sock_recv(), with the same return value and errno,
+ * e.g., to send a header and a body with one call and no copying.
+ * Partial progress is resumed until all buffers are handled, and the iovec array is left intact.
+ */
+size_t sock_sendv(int fd, const struct iovec *iov, int iov_count, int flags, int *nullable_standard_errno);
+
+size_t sock_recvv(int fd, const struct iovec *iov, int iov_count, int flags, int *nullable_standard_errno);
+
+/*
+ * Receives up to vlen datagrams with one system call (recvmmsg() of Linux),
+ * after waiting at most timeout_usecs (0 for not waiting, negative for infinity) for the first one.
+ * The msg_len of each received message is set to its length.
+ * Returns the number of datagrams received (0 on timeout), or a negative error code.
+ */
+int sock_recvmmsg(int fd, struct mmsghdr *msgs, unsigned int vlen, int flags, int timeout_usecs);
+
+/*
+ * Sends vlen datagrams with as few system calls (sendmmsg() of Linux) as possible,
+ * waiting at most timeout_usecs in total (0 for not waiting, negative for infinity)
+ * while the socket buffer is full.
+ * Returns the number of datagrams sent, which is less than vlen on timeout,
+ * or a negative error code if none is sent.
+ */
+int sock_sendmmsg(int fd, struct mmsghdr *msgs, unsigned int vlen, int flags, int timeout_usecs);
+
+/*
+ * ================
+ *  ZERO COPY
+ * ================
+ */
+
+/*
+ * Sends count bytes of a file from *nullable_offset (advanced then), or from its current offset if NULL,
+ * without copying them through user space (sendfile() of Linux).
+ * Returns the number of bytes sent, with the same errno convention as sock_send(),
+ * except that fewer bytes than count with errno of 0 means EOF of the file.
+ */
+size_t sock_sendfile(int sock_fd, int file_fd, off_t *nullable_offset, size_t count, int *nullable_standard_errno);
+
+/* A pipe through which sock_relay() moves data between 2 fds (e.g., sockets of a proxy) within the kernel. */
+typedef struct sock_relay_t
+{
+    int pipe_fds[2];
+    size_t pending; /* Bytes in the pipe waiting for out_fd to be writable. */
+} sock_relay_t;
+
+int sock_relay_init(sock_relay_t *relay, size_t pipe_size/* = 0 for the system default */);
+
+void sock_relay_destroy(sock_relay_t *relay);
+
+/*
+ * Moves at most max_len bytes from in_fd to out_fd with splice() of Linux, and returns the number moved out.
+ * It stops early on errors (including EAGAIN of either non-blocking fd), with the same errno convention
+ * as sock_recv(): EPIPE means EOF of in_fd after all pending data is moved out.
+ * Bytes read but not written yet stay in the pipe, and go first on the next call.
+ */
+size_t sock_relay(sock_relay_t *relay, int in_fd, int out_fd, size_t max_len, int *nullable_standard_errno);
+
+/*
+ * Tracks buffers sent with MSG_ZEROCOPY until the kernel no longer refers to them,
+ * which is notified through the error queue of the socket.
+ */
+typedef struct sock_zerocopy_t sock_zerocopy_t;
+
+/* was_copied is true if the kernel fell back to copying, e.g., on loopback, where zero copy brings no benefit. */
+typedef void (*sock_zerocopy_release_t)(const void *buf, size_t len, bool was_copied, void *cb_arg);
+
+/* Enables SO_ZEROCOPY of the socket (a TCP or UDP one, Linux 4.14+), and tracks at most max_pending buffers. */
+sock_zerocopy_t* sock_zerocopy_create(int fd, size_t max_pending/* = 0 for 256 */, int *nullable_error);
+
+/*
+ * Pending buffers are dropped without their callbacks called, so this should be done
+ * after sock_zerocopy_pending() drops to 0, or after the socket is closed and no longer sends.
+ */
+void sock_zerocopy_destroy(sock_zerocopy_t *zc);
+
+/*
+ * Same as sock_send() with MSG_ZEROCOPY, except that the bytes sent must stay untouched
+ * until release_cb (which must not be NULL, or it fails with errno of EINVAL)
+ * is called for them by sock_zerocopy_reap().
+ * Fails with errno of ENOBUFS if too many buffers are pending, and sock_zerocopy_reap() should be called first.
+ * Small buffers are better sent with sock_send(), since tracking costs more than copying them.
+ */
+size_t sock_zerocopy_send(sock_zerocopy_t *zc, const void *buf, size_t len, int flags,
+    sock_zerocopy_release_t release_cb, void *cb_arg, int *nullable_standard_errno);
+
+/*
+ * Reads completion notifications after waiting at most timeout_usecs (0 for not waiting, negative for infinity),
+ * and calls release callbacks of completed buffers.
+ * Returns the number of buffers released, or a negative error code.
+ */
+int sock_zerocopy_reap(sock_zerocopy_t *zc, int timeout_usecs);
+
+size_t sock_zerocopy_pending(const sock_zerocopy_t *zc);
+
+/*
+ * ================
+ *  BUFFERED CONNECTION
+ * ================
+ */
+
+/*
+ * A connection with a ring buffer for each direction: small fields are parsed out of data
+ * received in large chunks, and small writes are coalesced until flushed.
+ * Not thread-safe. The fd is not owned, and can be of a pipe or anything else readv()/writev() accept.
+ */
+typedef struct sock_conn_t sock_conn_t;
+
+/*
+ * Sizes are rounded up to powers of 2.
+ * If mirrored, each ring is mapped twice back to back (Linux 3.17+, by memfd_create()),
+ * so that peeked data and free space are always contiguous; it falls back to plain rings silently
+ * if that fails, which sock_conn_is_mirrored() tells.
+ */
+sock_conn_t* sock_conn_create(int fd, size_t read_buf_size/* = 0 for 65536 */, size_t write_buf_size/* = 0 for 65536 */,
+    bool mirrored, int *nullable_error);
+
+/* Unflushed data is dropped, and the fd is not closed. */
+void sock_conn_destroy(sock_conn_t *conn);
+
+int sock_conn_fd(const sock_conn_t *conn);
+
+bool sock_conn_is_mirrored(const sock_conn_t *conn);
+
+/*
+ * Reads as much as available into free space of the read ring with one system call (retried on EINTR only),
+ * and returns the number of bytes read, with the same errno convention as sock_recv(),
+ * plus ENOBUFS if the ring is full.
+ */
+size_t sock_conn_fill(sock_conn_t *conn, int *nullable_standard_errno);
+
+/* Number of bytes received but not consumed yet. */
+size_t sock_conn_readable(const sock_conn_t *conn);
+
+/*
+ * Returns the first contiguous part of readable bytes and stores its length into *len,
+ * which is all of them if mirrored. The data stays valid until the next fill or read.
+ */
+const void* sock_conn_peek(const sock_conn_t *conn, size_t *len);
+
+/* Copies at most len readable bytes into buf without consuming them, and returns the number copied. */
+size_t sock_conn_copy(const sock_conn_t *conn, void *buf, size_t len);
+
+/* Discards len (no more than readable) bytes. */
+void sock_conn_consume(sock_conn_t *conn, size_t len);
+
+/*
+ * Buffered version of sock_recv(), with the same return value and errno:
+ * buffered bytes go first, and the ring is refilled while more is needed.
+ */
+size_t sock_conn_read(sock_conn_t *conn, void *buf, size_t len, int *nullable_standard_errno);
+
+/*
+ * Appends len bytes to the write ring. When they don't fit, pending bytes and this buffer
+ * are sent together with sendmsg() until the rest fits. SIGPIPE is never raised.
+ * Returns the number of bytes sent or buffered, with the same errno convention as sock_send()
+ * (EAGAIN of a non-blocking fd included) when it's less than len.
+ */
+size_t sock_conn_write(sock_conn_t *conn, const void *buf, size_t len, int *nullable_standard_errno);
+
+/* Sends pending bytes until none is left or an error occurs, and returns the number of bytes sent. */
+size_t sock_conn_flush(sock_conn_t *conn, int *nullable_standard_errno);
+
+/* Number of bytes written but not flushed yet. */
+size_t sock_conn_pending(const sock_conn_t *conn);
+
 #ifdef __cplusplus
 }
 #endif
@@ -127,5 +297,12 @@ size_t sock_recv(int fd, const void *buf, size_t len, int flags, int *nullable_s
  * >>> 2022-03-28, Man Hung-Coeng:
  *  01. Add several macros: SOCK_IS_DISCONNECTED(), SOCK_IS_OFFLINE(),
  *      SOCK_CONNECTION_IS_LOST() and SOCK_SHOULD_TRY_LATER().
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Add sock_sendv(), sock_recvv(), sock_recvmmsg() and sock_sendmmsg().
+ *  02. Add zero-copy helpers: sock_sendfile(), sock_relay*() and sock_zerocopy*().
+ *  03. Add sock_conn_*() for buffered reading and writing through ring buffers.
+ *  04. Require a non-NULL release callback of sock_zerocopy_send().
+ *  05. State that sock_conn_write() never raises SIGPIPE.
  */
 
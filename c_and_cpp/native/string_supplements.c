@@ -1,7 +1,7 @@
 /*
  * Supplements to string operation of ANSI C.
  *
- * Copyright (c) 2021-2023 Man Hung-Coeng <udc577@126.com>
+ * Copyright (c) 2021-2026 Man Hung-Coeng <udc577@126.com>
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -18,8 +18,20 @@
 
 #include "string_supplements.h"
 
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h> /* For vsnprintf(), which needs C99. */
 #include <string.h>
 #include <stdlib.h>
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#if !defined(STR_NO_SIMD) && defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#define STR_SIMD_SSE2
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -57,6 +69,55 @@ const char* str_error(int error_code)
     return S_ERRORS[-error_code - 1];
 }
 
+/*
+ * Returns the first occurrence of the delimiter within [pos, end), or NULL if not found.
+ * A single character is left to memchr(), which is vectorized by libc.
+ * For longer ones, 16 candidate positions are filtered at a time by comparing
+ * both the first and the last characters of the delimiter with SSE2, then verified by memcmp().
+ * The O(n*m) worst case of it doesn't matter for delimiters as short as usual.
+ */
+static const char* __find_delimiter(const char *pos, const char *end, const char *delimiter, size_t delimiter_len)
+{
+    if (pos > end || (size_t)(end - pos) < delimiter_len)
+        return NULL;
+
+    if (1 == delimiter_len)
+        return (const char *)memchr(pos, *delimiter, end - pos);
+
+#ifdef STR_SIMD_SSE2
+    {
+        const __m128i first = _mm_set1_epi8(delimiter[0]);
+        const __m128i last = _mm_set1_epi8(delimiter[delimiter_len - 1]);
+
+        for (; (size_t)(end - pos) >= delimiter_len + 15; pos += 16)
+        {
+            __m128i heads = _mm_cmpeq_epi8(first, _mm_loadu_si128((const __m128i *)pos));
+            __m128i tails = _mm_cmpeq_epi8(last, _mm_loadu_si128((const __m128i *)(pos + delimiter_len - 1)));
+            int mask = _mm_movemask_epi8(_mm_and_si128(heads, tails));
+
+            for (; 0 != mask; mask &= mask - 1)
+            {
+                const char *candidate = pos + __builtin_ctz(mask);
+
+                if (0 == memcmp(candidate + 1, delimiter + 1, delimiter_len - 2))
+                    return candidate;
+            }
+        }
+    }
+#endif
+
+    for (; (size_t)(end - pos) >= delimiter_len; ++pos)
+    {
+        if (NULL == (pos = (const char *)memchr(pos, *delimiter, end - pos - delimiter_len + 1)))
+            return NULL;
+
+        if (0 == memcmp(pos + 1, delimiter + 1, delimiter_len - 1))
+            return pos;
+    }
+
+    return NULL;
+}
+
 static char** __str_split(const char *str, size_t str_len, const char *delimiter, size_t delimiter_len,
     size_t *inout_splits, char **nullable_result_holder, size_t capacity_per_holder_item, int *errcode)
 {
@@ -82,14 +143,8 @@ static char** __str_split(const char *str, size_t str_len, const char *delimiter
             if (head > STOP)
                 break;
 
-            if (1 == delimiter_len)
-                while ((tail < STOP) && (*delimiter != *tail)) ++tail;
-            else
-            {
-                tail = strstr(head, delimiter);
-                if (NULL == tail || tail > STOP)
-                    tail = STOP;
-            }
+            if (NULL == (tail = __find_delimiter(head, STOP, delimiter, delimiter_len)))
+                tail = STOP;
 
             if (is_dynamic_alloc && (NULL == pptr || splits + 1 > capacity))
             {
@@ -187,12 +242,1022 @@ int str_split_to_fixed_buffer(const char *str, size_t str_len, const char *delim
     return (err < 0) ? err : (int)splits;
 }
 
+int str_splitter_init(str_splitter_t *splitter, const char *str, size_t str_len,
+    const char *delimiter, size_t delimiter_len)
+{
+    if (0 == delimiter_len)
+        return -STR_ERR_ZERO_LENGTH;
+
+    splitter->str = str;
+    splitter->str_len = str_len;
+    splitter->delimiter = delimiter;
+    splitter->delimiter_len = delimiter_len;
+    splitter->pos = 0;
+
+    return 0;
+}
+
+int str_splitter_next(str_splitter_t *splitter, str_span_t *span)
+{
+    const char *head = splitter->str + splitter->pos;
+    const char *STOP = splitter->str + splitter->str_len;
+    const char *tail = NULL;
+
+    if (splitter->pos > splitter->str_len)
+        return 0;
+
+    if (NULL == (tail = __find_delimiter(head, STOP, splitter->delimiter, splitter->delimiter_len)))
+        tail = STOP;
+
+    span->offset = splitter->pos;
+    span->length = tail - head;
+    splitter->pos += span->length + splitter->delimiter_len; /* Beyond str_len if no delimiter was found. */
+
+    return 1;
+}
+
+int str_split_spans(const char *str, size_t str_len, const char *delimiter, size_t delimiter_len,
+    str_span_t *spans, size_t span_count)
+{
+    str_splitter_t splitter;
+    size_t count = 0;
+    int err = (0 == span_count) ? -STR_ERR_ZERO_LENGTH : str_splitter_init(&splitter, str, str_len, delimiter, delimiter_len);
+
+    if (err < 0)
+        return err;
+
+    while (count + 1 < span_count && str_splitter_next(&splitter, &spans[count]))
+    {
+        ++count;
+    }
+
+    if (count + 1 == span_count && splitter.pos <= str_len)
+    {
+        spans[count].offset = splitter.pos;
+        spans[count].length = str_len - splitter.pos;
+        ++count;
+    }
+
+    return (int)count;
+}
+
+/*
+ * ================
+ *  PARALLEL SPLITTING
+ * ================
+ */
+
+#define STR_PARALLEL_PART_MIN   (1024 * 1024)
+#define STR_PARALLEL_THREADS_MAX    64
+
+typedef struct split_part_t
+{
+    const char *str;
+    size_t begin;
+    size_t end; /* Not including the delimiter after the part. */
+    const char *delimiter;
+    size_t delimiter_len;
+    str_span_t *spans;
+    size_t count;
+    int err;
+} split_part_t;
+
+static void* __split_part(void *arg)
+{
+    split_part_t *part = (split_part_t *)arg;
+    str_splitter_t splitter;
+    str_span_t span;
+    size_t capacity = 0;
+
+    str_splitter_init(&splitter, part->str + part->begin, part->end - part->begin, part->delimiter, part->delimiter_len);
+    while (str_splitter_next(&splitter, &span))
+    {
+        if (part->count == capacity)
+        {
+            size_t new_capacity = (0 == capacity) ? ((part->end - part->begin) / 64 + 16) : capacity * 2;
+            str_span_t *spans = (str_span_t *)realloc(part->spans, new_capacity * sizeof(str_span_t));
+
+            if (NULL == spans)
+            {
+                part->err = -STR_ERR_MEM_ALLOC;
+
+                return NULL;
+            }
+
+            part->spans = spans;
+            capacity = new_capacity;
+        }
+
+        span.offset += part->begin;
+        part->spans[part->count++] = span;
+    }
+
+    return NULL;
+}
+
+/* Tells whether a proper prefix of the delimiter is also a suffix of it. */
+static int __is_self_overlapping(const char *delimiter, size_t delimiter_len)
+{
+    size_t i;
+
+    for (i = 1; i < delimiter_len; ++i)
+    {
+        if (0 == memcmp(delimiter, delimiter + delimiter_len - i, i))
+            return 1;
+    }
+
+    return 0;
+}
+
+int str_split_parallel(const char *str, size_t str_len, const char *delimiter, size_t delimiter_len,
+    int threads, str_span_t **spans, size_t *span_count)
+{
+    split_part_t parts[STR_PARALLEL_THREADS_MAX];
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+    pthread_t tids[STR_PARALLEL_THREADS_MAX];
+    int created[STR_PARALLEL_THREADS_MAX] = { 0 };
+    long thread_count = (threads > 0) ? threads : sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    long thread_count = 1;
+#endif
+    size_t max_count = str_len / STR_PARALLEL_PART_MIN;
+    size_t total = 0;
+    size_t pos = 0;
+    int count = 0;
+    int err = 0;
+    int i;
+
+    if (0 == delimiter_len)
+        return -STR_ERR_ZERO_LENGTH;
+
+    if (thread_count > STR_PARALLEL_THREADS_MAX)
+        thread_count = STR_PARALLEL_THREADS_MAX;
+    if (max_count > (size_t)thread_count)
+        max_count = (size_t)thread_count;
+    if (0 == max_count || __is_self_overlapping(delimiter, delimiter_len))
+        max_count = 1;
+
+    while (pos <= str_len && (size_t)count < max_count)
+    {
+        size_t target = str_len / max_count * (count + 1);
+        const char *found = ((size_t)count + 1 == max_count) ? NULL
+            : __find_delimiter(str + ((target > pos) ? target : pos), str + str_len, delimiter, delimiter_len);
+
+        memset(&parts[count], 0, sizeof(split_part_t));
+        parts[count].str = str;
+        parts[count].begin = pos;
+        parts[count].end = (NULL == found) ? str_len : (size_t)(found - str);
+        parts[count].delimiter = delimiter;
+        parts[count].delimiter_len = delimiter_len;
+        ++count;
+        pos = (NULL == found) ? (str_len + 1) : (parts[count - 1].end + delimiter_len);
+    }
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+    for (i = 1; i < count; ++i)
+    {
+        created[i] = (0 == pthread_create(&tids[i], NULL, __split_part, &parts[i]));
+    }
+#endif
+
+    __split_part(&parts[0]);
+
+    for (i = 1; i < count; ++i)
+    {
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+        if (created[i])
+            pthread_join(tids[i], NULL);
+        else
+#endif
+            __split_part(&parts[i]); /* Runs in the current thread if failed to create one. */
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        total += parts[i].count;
+        if (parts[i].err < 0)
+            err = parts[i].err;
+    }
+
+    /* Results of the first part are enlarged to hold all of them, saving a copy of the biggest part. */
+    if (0 == err)
+    {
+        str_span_t *all = (str_span_t *)realloc(parts[0].spans, total * sizeof(str_span_t));
+
+        if (NULL == all)
+            err = -STR_ERR_MEM_ALLOC;
+        else
+        {
+            parts[0].spans = all;
+            for (i = 1, total = parts[0].count; i < count; total += parts[i].count, ++i)
+            {
+                memcpy(all + total, parts[i].spans, parts[i].count * sizeof(str_span_t));
+            }
+        }
+    }
+
+    for (i = (0 == err) ? 1 : 0; i < count; ++i)
+    {
+        free(parts[i].spans);
+    }
+
+    *spans = (0 == err) ? parts[0].spans : NULL;
+    *span_count = (0 == err) ? total : 0;
+
+    return err;
+}
+
+/*
+ * ================
+ *  STREAMING SPLITTING
+ * ================
+ */
+
+#define STR_STREAM_BLOCK_SIZE   (1024 * 1024)
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS)
+
+int str_stream_splitter_init(str_stream_splitter_t *splitter, int fd, const char *delimiter, size_t delimiter_len,
+    size_t block_size)
+{
+    if (0 == delimiter_len)
+        return -STR_ERR_ZERO_LENGTH;
+
+    splitter->fd = fd;
+    splitter->delimiter = delimiter;
+    splitter->delimiter_len = delimiter_len;
+    /* A delimiter must fit in a block together with at least 1 more byte. */
+    splitter->buf_size = (0 == block_size) ? STR_STREAM_BLOCK_SIZE
+        : ((block_size > delimiter_len) ? block_size : delimiter_len + 1);
+    splitter->head = 0;
+    splitter->scanned = 0;
+    splitter->tail = 0;
+    splitter->state = 0;
+
+    if (NULL == (splitter->buf = (char *)malloc(splitter->buf_size)))
+        return -STR_ERR_MEM_ALLOC;
+
+    return 0;
+}
+
+/* Moves the unfinished token to the beginning of the buffer, or enlarges the buffer if it's all a token. */
+static int __make_room(str_stream_splitter_t *splitter)
+{
+    if (splitter->head > 0)
+    {
+        memmove(splitter->buf, splitter->buf + splitter->head, splitter->tail - splitter->head);
+        splitter->tail -= splitter->head;
+        splitter->scanned -= splitter->head;
+        splitter->head = 0;
+    }
+
+    if (splitter->tail == splitter->buf_size)
+    {
+        char *buf = (char *)realloc(splitter->buf, splitter->buf_size * 2);
+
+        if (NULL == buf)
+            return -STR_ERR_MEM_ALLOC;
+
+        splitter->buf = buf;
+        splitter->buf_size *= 2;
+    }
+
+    return 0;
+}
+
+int str_stream_splitter_next(str_stream_splitter_t *splitter, const char **token, size_t *len)
+{
+    while (splitter->state < 2)
+    {
+        const char *found = __find_delimiter(splitter->buf + splitter->scanned, splitter->buf + splitter->tail,
+            splitter->delimiter, splitter->delimiter_len);
+        ssize_t ret;
+        int err;
+
+        if (NULL != found || 1 == splitter->state)
+        {
+            *token = splitter->buf + splitter->head;
+            *len = ((NULL == found) ? (splitter->buf + splitter->tail) : found) - *token;
+            if (NULL == found)
+                splitter->state = 2;
+            else
+                splitter->head = splitter->scanned = found - splitter->buf + splitter->delimiter_len;
+
+            return 1;
+        }
+
+        /* The tail may hold the beginning of a delimiter, so scan it again along with more data. */
+        splitter->scanned = (splitter->tail - splitter->head >= splitter->delimiter_len)
+            ? (splitter->tail - splitter->delimiter_len + 1) : splitter->head;
+
+        if ((err = __make_room(splitter)) < 0)
+            return err;
+
+        do
+        {
+            ret = read(splitter->fd, splitter->buf + splitter->tail, splitter->buf_size - splitter->tail);
+        }
+        while (ret < 0 && EINTR == errno);
+
+        if (ret < 0)
+            return -(errno + STR_ERR_END);
+
+        if (0 == ret)
+            splitter->state = 1;
+        else
+            splitter->tail += ret;
+    }
+
+    return 0;
+}
+
+void str_stream_splitter_destroy(str_stream_splitter_t *splitter)
+{
+    free(splitter->buf);
+    splitter->buf = NULL;
+}
+
+#else /* Windows */
+
+int str_stream_splitter_init(str_stream_splitter_t *splitter, int fd, const char *delimiter, size_t delimiter_len,
+    size_t block_size)
+{
+    splitter->buf = NULL;
+
+    return -STR_ERR_NOT_IMPLEMENTED;
+}
+
+int str_stream_splitter_next(str_stream_splitter_t *splitter, const char **token, size_t *len)
+{
+    return -STR_ERR_NOT_IMPLEMENTED;
+}
+
+void str_stream_splitter_destroy(str_stream_splitter_t *splitter)
+{
+}
+
+#endif /* #if !defined(WIN32) && !defined(_WIN32) && !defined(windows) && !defined(WINDOWS) */
+
+/*
+ * ================
+ *  STRING BUILDER
+ * ================
+ */
+
+#define STR_DATA(builder)       ((NULL == (builder)->heap) ? (builder)->inline_buf : (builder)->heap)
+
+void str_builder_init(str_builder_t *builder)
+{
+    builder->heap = NULL;
+    builder->len = 0;
+    builder->capacity = STR_BUILDER_INLINE_SIZE;
+    builder->inline_buf[0] = '\0';
+}
+
+void str_builder_destroy(str_builder_t *builder)
+{
+    free(builder->heap);
+    str_builder_init(builder);
+}
+
+void str_builder_clear(str_builder_t *builder)
+{
+    builder->len = 0;
+    STR_DATA(builder)[0] = '\0';
+}
+
+int str_builder_reserve(str_builder_t *builder, size_t extra_len)
+{
+    size_t needed = builder->len + extra_len + 1;
+    size_t capacity = builder->capacity;
+    char *heap = NULL;
+
+    if (needed <= capacity)
+        return 0;
+
+    if (needed < builder->len)
+        return -STR_ERR_STRING_TOO_LONG;
+
+    while (capacity < needed)
+    {
+        capacity = (capacity * 2 > capacity) ? (capacity * 2) : needed;
+    }
+
+    if (NULL == (heap = (char *)realloc(builder->heap, capacity)))
+        return -STR_ERR_MEM_ALLOC;
+
+    if (NULL == builder->heap)
+        memcpy(heap, builder->inline_buf, builder->len + 1);
+
+    builder->heap = heap;
+    builder->capacity = capacity;
+
+    return 0;
+}
+
+int str_builder_append_n(str_builder_t *builder, const char *str, size_t len)
+{
+    int err = str_builder_reserve(builder, len);
+    char *data = STR_DATA(builder);
+
+    if (err < 0)
+        return err;
+
+    memcpy(data + builder->len, str, len);
+    builder->len += len;
+    data[builder->len] = '\0';
+
+    return 0;
+}
+
+int str_builder_append(str_builder_t *builder, const char *str)
+{
+    return str_builder_append_n(builder, str, strlen(str));
+}
+
+int str_builder_append_char(str_builder_t *builder, char ch)
+{
+    return str_builder_append_n(builder, &ch, 1);
+}
+
+int str_builder_append_fmt(str_builder_t *builder, const char *fmt, ...)
+{
+    va_list args;
+    int len;
+    int err;
+
+    /* Formats into the spare room directly, and only formats again if it doesn't fit. */
+    va_start(args, fmt);
+    len = vsnprintf(STR_DATA(builder) + builder->len, builder->capacity - builder->len, fmt, args);
+    va_end(args);
+
+    if (len >= 0 && (size_t)len >= builder->capacity - builder->len)
+    {
+        if ((err = str_builder_reserve(builder, len)) < 0)
+        {
+            STR_DATA(builder)[builder->len] = '\0';
+
+            return err;
+        }
+
+        va_start(args, fmt);
+        len = vsnprintf(STR_DATA(builder) + builder->len, builder->capacity - builder->len, fmt, args);
+        va_end(args);
+    }
+
+    if (len < 0)
+    {
+        STR_DATA(builder)[builder->len] = '\0';
+
+        return -STR_ERR_UNKNOWN;
+    }
+
+    builder->len += len;
+
+    return 0;
+}
+
+const char* str_builder_cstr(const str_builder_t *builder)
+{
+    return (NULL == builder->heap) ? builder->inline_buf : builder->heap;
+}
+
+size_t str_builder_len(const str_builder_t *builder)
+{
+    return builder->len;
+}
+
+char* str_builder_detach(str_builder_t *builder)
+{
+    char *str = builder->heap;
+
+    if (NULL == str && NULL != (str = (char *)malloc(builder->len + 1)))
+        memcpy(str, builder->inline_buf, builder->len + 1);
+
+    if (NULL != str)
+        str_builder_init(builder);
+
+    return str;
+}
+
+/*
+ * ================
+ *  INTERNING
+ * ================
+ */
+
+#define STR_INTERN_BLOCK_SIZE   (16 * 1024)
+
+typedef struct intern_slot_t
+{
+    size_t hash;
+    size_t len;
+    const char *str; /* NULL if the slot is free. */
+} intern_slot_t;
+
+typedef struct intern_block_t
+{
+    struct intern_block_t *next;
+    size_t used;
+    size_t size; /* Followed by the data. */
+} intern_block_t;
+
+struct str_intern_table_t
+{
+    intern_slot_t *slots;
+    size_t slot_count; /* Always a power of 2. */
+    size_t count;
+    intern_block_t *blocks; /* The first one is the current. */
+};
+
+static size_t __hash_of_n(const char *str, size_t len)
+{
+    size_t hash = 2166136261UL; /* FNV-1a */
+    size_t i;
+
+    for (i = 0; i < len; ++i)
+    {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+static int __rehash(str_intern_table_t *table, size_t slot_count)
+{
+    intern_slot_t *slots = (intern_slot_t *)calloc(slot_count, sizeof(intern_slot_t));
+    size_t i;
+
+    if (NULL == slots)
+        return -STR_ERR_MEM_ALLOC;
+
+    for (i = 0; i < table->slot_count; ++i)
+    {
+        size_t j = table->slots[i].hash & (slot_count - 1);
+
+        if (NULL == table->slots[i].str)
+            continue;
+
+        while (NULL != slots[j].str)
+        {
+            j = (j + 1) & (slot_count - 1);
+        }
+        slots[j] = table->slots[i];
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->slot_count = slot_count;
+
+    return 0;
+}
+
+str_intern_table_t* str_intern_table_create(size_t expected_count)
+{
+    str_intern_table_t *table = (str_intern_table_t *)calloc(1, sizeof(str_intern_table_t));
+    size_t slot_count = 64;
+
+    while (slot_count / 4 * 3 < expected_count)
+    {
+        slot_count *= 2;
+    }
+
+    if (NULL != table && __rehash(table, slot_count) < 0)
+    {
+        free(table);
+
+        return NULL;
+    }
+
+    return table;
+}
+
+void str_intern_table_destroy(str_intern_table_t *table)
+{
+    if (NULL == table)
+        return;
+
+    while (NULL != table->blocks)
+    {
+        intern_block_t *next = table->blocks->next;
+
+        free(table->blocks);
+        table->blocks = next;
+    }
+
+    free(table->slots);
+    free(table);
+}
+
+static const char* __copy_into_blocks(str_intern_table_t *table, const char *str, size_t len)
+{
+    intern_block_t *block = table->blocks;
+    char *copy = NULL;
+
+    if (NULL == block || block->size - block->used < len + 1)
+    {
+        size_t size = (len + 1 > STR_INTERN_BLOCK_SIZE) ? (len + 1) : STR_INTERN_BLOCK_SIZE;
+
+        if (NULL == (block = (intern_block_t *)malloc(sizeof(intern_block_t) + size)))
+            return NULL;
+
+        block->used = 0;
+        block->size = size;
+        block->next = table->blocks;
+        table->blocks = block;
+    }
+
+    copy = (char *)(block + 1) + block->used;
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    block->used += len + 1;
+
+    return copy;
+}
+
+const char* str_intern(str_intern_table_t *table, const char *str, size_t len)
+{
+    size_t hash = __hash_of_n(str, len);
+    size_t i = hash & (table->slot_count - 1);
+
+    for (; NULL != table->slots[i].str; i = (i + 1) & (table->slot_count - 1))
+    {
+        const intern_slot_t *slot = &table->slots[i];
+
+        if (hash == slot->hash && len == slot->len && 0 == memcmp(slot->str, str, len))
+            return slot->str;
+    }
+
+    /* Keeps the load factor under 3/4. */
+    if ((table->count + 1) > table->slot_count / 4 * 3)
+    {
+        if (__rehash(table, table->slot_count * 2) < 0)
+            return NULL;
+
+        for (i = hash & (table->slot_count - 1); NULL != table->slots[i].str; i = (i + 1) & (table->slot_count - 1))
+            ;
+    }
+
+    if (NULL == (table->slots[i].str = __copy_into_blocks(table, str, len)))
+        return NULL;
+
+    table->slots[i].hash = hash;
+    table->slots[i].len = len;
+    table->count += 1;
+
+    return table->slots[i].str;
+}
+
+size_t str_intern_count(const str_intern_table_t *table)
+{
+    return table->count;
+}
+
 #ifdef TEST
 
-#include <stdio.h>
+#include <time.h>
+#include <fcntl.h>
+
+#include "sleeps.h"
 
 #define BUF_ITEM_COUNT      8
 #define BUF_ITEM_SIZE       4
+#define SPAN_COUNT          16
+
+/* Tokens of str_split_spans() should be the same as those of str_split(). */
+static int compare_with_str_split(void)
+{
+    const char* const CASES[][2] = {
+        { "a,b,,c,", "," }
+        , { "key :: value :: ::", "::" }
+        , { "one line of a log, 2026-10-18 12:00:00 <ERROR> <WARN> something happened, repeated...", "> <" }
+        , { "|||||||||||||||||||||||||||||||||||||||||||||||||", "||" }
+        , { "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxy", "xy" }
+        , { "ends with the delimiter, which is long enough to cross a block.<<end>>", "<<end>>" }
+    };
+    str_span_t spans[64];
+    size_t i;
+
+    for (i = 0; i < sizeof(CASES) / sizeof(CASES[0]); ++i)
+    {
+        size_t len = strlen(CASES[i][0]);
+        char **pptr = str_split(CASES[i][0], len, CASES[i][1], strlen(CASES[i][1]), 0, NULL);
+        int count = str_split_spans(CASES[i][0], len, CASES[i][1], strlen(CASES[i][1]), spans, 64);
+        int j = 0;
+
+        for (; NULL != pptr && NULL != pptr[j] && j < count; ++j)
+        {
+            if (strlen(pptr[j]) != spans[j].length || 0 != memcmp(pptr[j], CASES[i][0] + spans[j].offset, spans[j].length))
+                break;
+        }
+
+        if (NULL == pptr || NULL != pptr[j] || j != count)
+        {
+            fprintf(stderr, "Case [%s] split by [%s]: spans mismatched at %d\n", CASES[i][0], CASES[i][1], j);
+            str_split_destroy(pptr);
+
+            return -1;
+        }
+
+        str_split_destroy(pptr);
+    }
+
+    printf(">>> Spans are consistent with str_split().\n");
+
+    return 0;
+}
+
+static int benchmark(void)
+{
+    const char *LINE = "2026-10-18 12:00:00.123 | INFO | worker-7 | request handled | path=/api/v1/items | status=200\n";
+    const size_t LINE_LEN = strlen(LINE);
+    const int LINES = 200000;
+    str_span_t spans[SPAN_COUNT];
+    size_t checksums[2] = { 0, 0 };
+    clock_t ticks[2];
+    int i;
+
+    ticks[0] = clock();
+    for (i = 0; i < LINES; ++i)
+    {
+        char **pptr = str_split(LINE, LINE_LEN, " | ", 3, 0, NULL);
+        int j;
+
+        for (j = 0; NULL != pptr && NULL != pptr[j]; ++j)
+        {
+            checksums[0] += strlen(pptr[j]);
+        }
+        str_split_destroy(pptr);
+    }
+    ticks[0] = clock() - ticks[0];
+
+    ticks[1] = clock();
+    for (i = 0; i < LINES; ++i)
+    {
+        int count = str_split_spans(LINE, LINE_LEN, " | ", 3, spans, SPAN_COUNT);
+        int j;
+
+        for (j = 0; j < count; ++j)
+        {
+            checksums[1] += spans[j].length;
+        }
+    }
+    ticks[1] = clock() - ticks[1];
+
+    printf(">>> Splitting %d log lines: str_split(): %.1f ms, str_split_spans(): %.1f ms\n", LINES,
+        ticks[0] * 1000.0 / CLOCKS_PER_SEC, ticks[1] * 1000.0 / CLOCKS_PER_SEC);
+
+    return (checksums[0] == checksums[1]) ? 0 : -1;
+}
+
+/* Tokens should be the same as those of str_splitter_next() on the whole content, whatever the block size is. */
+static int stream_equals_whole(const char *path, const char *content, size_t content_len,
+    const char *delimiter, size_t block_size, size_t *throughput_tokens)
+{
+    str_stream_splitter_t stream_splitter;
+    str_splitter_t splitter;
+    str_span_t span;
+    const char *token = NULL;
+    size_t len = 0;
+    int fd = open(path, O_RDONLY);
+    int ret = (fd < 0) ? -1 : str_stream_splitter_init(&stream_splitter, fd, delimiter, strlen(delimiter), block_size);
+
+    if (ret < 0)
+    {
+        if (fd >= 0)
+            close(fd);
+
+        return ret;
+    }
+
+    str_splitter_init(&splitter, content, content_len, delimiter, strlen(delimiter));
+    while ((ret = str_stream_splitter_next(&stream_splitter, &token, &len)) > 0)
+    {
+        if (NULL == content)
+            *throughput_tokens += 1;
+        else if (!str_splitter_next(&splitter, &span) || span.length != len || 0 != memcmp(content + span.offset, token, len))
+        {
+            ret = -1;
+            break;
+        }
+    }
+
+    if (0 == ret && NULL != content && str_splitter_next(&splitter, &span))
+        ret = -1;
+
+    str_stream_splitter_destroy(&stream_splitter);
+    close(fd);
+
+    return ret;
+}
+
+static int test_stream_splitter(void)
+{
+    const char *PATH = "string_supplements_test.csv";
+    const size_t BLOCK_SIZES[] = { 1, 2, 3, 7, 64, 0 };
+    char content[4096] = { 0 };
+    size_t content_len = 0;
+    FILE *stream = NULL;
+    size_t tokens = 0;
+    clock_t ticks;
+    size_t i;
+    int err = -1;
+
+    for (i = 0; content_len + 64 < sizeof(content); ++i)
+    {
+        content_len += sprintf(content + content_len, "%d,row-%d,,%s\r\n", (int)i, (int)i, (i % 7) ? "x" : "longer value\r");
+    }
+
+    if (NULL == (stream = fopen(PATH, "wb")))
+        return -1;
+    fwrite(content, 1, content_len, stream);
+    fclose(stream);
+
+    for (i = 0; i < sizeof(BLOCK_SIZES) / sizeof(BLOCK_SIZES[0]); ++i)
+    {
+        if (stream_equals_whole(PATH, content, content_len, ",", BLOCK_SIZES[i], NULL) < 0
+            || stream_equals_whole(PATH, content, content_len, "\r\n", BLOCK_SIZES[i], NULL) < 0
+            || stream_equals_whole(PATH, content, content_len, ",,x\r\n", BLOCK_SIZES[i], NULL) < 0)
+        {
+            fprintf(stderr, "Stream splitting with block size %d differs from splitting the whole content\n",
+                (int)BLOCK_SIZES[i]);
+            goto STREAM_TEST_END;
+        }
+    }
+    printf(">>> Stream splitting is consistent with splitting the whole content.\n");
+
+    if (NULL == (stream = fopen(PATH, "ab")))
+        goto STREAM_TEST_END;
+    for (i = 0; i < 16 * 1024; ++i) /* 64 MiB in total */
+    {
+        fwrite(content, 1, content_len, stream);
+    }
+    fclose(stream);
+
+    ticks = clock();
+    if (stream_equals_whole(PATH, NULL, 0, "\r\n", 0, &tokens) < 0)
+        goto STREAM_TEST_END;
+    ticks = clock() - ticks;
+    printf(">>> Stream splitting of %d MiB into %d lines: %.1f ms\n", (int)(content_len * (16 * 1024 + 1) >> 20),
+        (int)tokens, ticks * 1000.0 / CLOCKS_PER_SEC);
+    err = 0;
+
+STREAM_TEST_END:
+
+    remove(PATH);
+
+    return err;
+}
+
+/* Results of any thread count should be the same as the sequential one. Also prints scaling numbers. */
+static int test_parallel_splitting(void)
+{
+    const int THREAD_COUNTS[] = { 1, 2, 4, 8, 16 };
+    const size_t SIZE = 64 * 1024 * 1024;
+    const char* const DELIMITERS[] = { "\n", ", ", "==" };
+    char *buf = (char *)malloc(SIZE);
+    str_span_t *expected = NULL;
+    size_t expected_count = 0;
+    size_t len = 0;
+    size_t i, j;
+    int err = (NULL == buf) ? -STR_ERR_MEM_ALLOC : 0;
+
+    for (i = 0; NULL != buf && len + 128 < SIZE; ++i)
+    {
+        len += sprintf(buf + len, "%d, 2026-10-18 12:00:00, worker-%d, status===%d, bytes=%d\n",
+            (int)i, (int)(i % 16), (i % 5) ? 200 : 404, (int)(i * 7 % 100000));
+    }
+
+    for (i = 0; 0 == err && i < sizeof(DELIMITERS) / sizeof(DELIMITERS[0]); ++i)
+    {
+        size_t delimiter_len = strlen(DELIMITERS[i]);
+
+        if ((err = str_split_parallel(buf, len, DELIMITERS[i], delimiter_len, 1, &expected, &expected_count)) < 0)
+            break;
+
+        for (j = 0; 0 == err && j < sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0]); ++j)
+        {
+            str_span_t *spans = NULL;
+            size_t count = 0;
+            double begin = 0;
+            double ms = 0;
+
+            begin = monotonic_milliseconds();
+            err = str_split_parallel(buf, len, DELIMITERS[i], delimiter_len, THREAD_COUNTS[j], &spans, &count);
+            ms = monotonic_milliseconds() - begin;
+
+            if (0 == err && (count != expected_count || 0 != memcmp(spans, expected, count * sizeof(str_span_t))))
+                err = -STR_ERR_UNKNOWN;
+
+            printf(">>> str_split_parallel(%d MiB, [%s], %2d threads): %d tokens, %.1f ms, %s\n", (int)(len >> 20),
+                ('\n' == DELIMITERS[i][0]) ? "\\n" : DELIMITERS[i], THREAD_COUNTS[j], (int)count, ms,
+                (0 == err) ? "same as sequential" : "DIFFERENT RESULTS!");
+            free(spans);
+        }
+
+        free(expected);
+        expected = NULL;
+    }
+
+    free(buf);
+
+    return err;
+}
+
+static int test_builder_and_interning(void)
+{
+    const int ROUNDS = 1000000;
+    str_builder_t builder;
+    str_intern_table_t *table = str_intern_table_create(0);
+    const char *key = NULL;
+    char *detached = NULL;
+    size_t checksums[2] = { 0, 0 };
+    clock_t ticks[2];
+    int i, err = 0;
+
+    str_builder_init(&builder);
+    for (i = 0; 0 == err && i < 100; ++i)
+    {
+        err = str_builder_append_fmt(&builder, "[%d]%s", i, (i % 10) ? "" : "0123456789");
+    }
+    str_builder_append_n(&builder, "<end>!", 5);
+    str_builder_append_char(&builder, '.');
+    if (0 != err || NULL == builder.heap || str_builder_len(&builder) != strlen(str_builder_cstr(&builder))
+        || 0 != strncmp(str_builder_cstr(&builder), "[0]0123456789[1][2]", 19)
+        || 0 != strcmp(str_builder_cstr(&builder) + str_builder_len(&builder) - 10, "[99]<end>.")
+        || NULL == (detached = str_builder_detach(&builder)) || 0 != str_builder_len(&builder)
+        || 0 != str_builder_append(&builder, "short") || NULL != builder.heap || 0 != strcmp(str_builder_cstr(&builder), "short"))
+    {
+        fprintf(stderr, "String builder gave unexpected results: %s\n", (NULL == detached) ? "" : detached);
+        err = -1;
+    }
+    free(detached);
+
+    for (i = 0; 0 == err && NULL != table && i < 10000; ++i)
+    {
+        char buf[32];
+        size_t len = sprintf(buf, "key%d", i % 1000);
+
+        if (NULL == (key = str_intern(table, buf, len)) || 0 != strcmp(key, buf)
+            || (i >= 1000 && key != str_intern(table, buf, len)))
+            err = -1;
+    }
+    if (NULL == table || 0 != err || 1000 != str_intern_count(table) || key == str_intern(table, "key9", 3)
+        || str_intern(table, "key9", 3) != str_intern(table, "key", 3))
+    {
+        fprintf(stderr, "Interning gave unexpected results\n");
+        err = -1;
+    }
+    str_intern_table_destroy(table);
+
+    /* Assembling "section.key = value" lines by fragments vs by a reused builder. */
+    ticks[0] = clock();
+    for (i = 0; 0 == err && i < ROUNDS; ++i)
+    {
+        const char *fragments[] = { "network", ".", "timeout", " = ", "30s" };
+        char *line = (char *)malloc(1);
+        size_t len = 0, j;
+
+        line[0] = '\0';
+        for (j = 0; j < sizeof(fragments) / sizeof(fragments[0]); ++j)
+        {
+            size_t frag_len = strlen(fragments[j]);
+            char *tmp = (char *)malloc(len + frag_len + 1);
+
+            memcpy(tmp, line, len);
+            strncpy(tmp + len, fragments[j], frag_len + 1);
+            len += frag_len;
+            free(line);
+            line = tmp;
+        }
+        checksums[0] += strlen(line);
+        free(line);
+    }
+    ticks[0] = clock() - ticks[0];
+
+    ticks[1] = clock();
+    for (i = 0; 0 == err && i < ROUNDS; ++i)
+    {
+        str_builder_clear(&builder);
+        str_builder_append_n(&builder, "network", 7);
+        str_builder_append_char(&builder, '.');
+        str_builder_append_n(&builder, "timeout", 7);
+        str_builder_append_n(&builder, " = ", 3);
+        str_builder_append_n(&builder, "30s", 3);
+        checksums[1] += strlen(str_builder_cstr(&builder));
+    }
+    ticks[1] = clock() - ticks[1];
+    str_builder_destroy(&builder);
+
+    if (0 == err)
+    {
+        printf(">>> Assembling %d lines: malloc() per fragment: %.1f ms, string builder: %.1f ms\n", ROUNDS,
+            ticks[0] * 1000.0 / CLOCKS_PER_SEC, ticks[1] * 1000.0 / CLOCKS_PER_SEC);
+    }
+
+    return (0 == err && checksums[0] == checksums[1]) ? 0 : -1;
+}
 
 int main(int argc, char **argv)
 {
@@ -205,6 +1270,7 @@ int main(int argc, char **argv)
     char **pptr = NULL;
     char buf[BUF_ITEM_COUNT][BUF_ITEM_SIZE] = { { 0 } };
     char *buf_ptr[BUF_ITEM_COUNT]; /* TODO: Any easier initialization ?? */
+    str_span_t spans[SPAN_COUNT];
     size_t i = 0;
 
     for (i = 0; i < sizeof(buf_ptr) / sizeof(char *); ++i)
@@ -295,7 +1361,24 @@ int main(int argc, char **argv)
         printf("    [%d]: %s\n", (int)i, buf[i]);
     }
 
-    return 0;
+    printf(">>> Case 9: spans with a 1-char delimiter.\n");
+    splits = str_split_spans(simple_str, simple_len, "/", 1, spans, SPAN_COUNT);
+    printf("str_split_spans(%s, /): %d spans, err: %s\n", simple_str, splits, str_error(splits));
+    for (i = 0; splits > 0 && i < (size_t)splits; ++i)
+    {
+        printf("    [%d]: %.*s\n", (int)i, (int)spans[i].length, simple_str + spans[i].offset);
+    }
+
+    printf(">>> Case 10: spans with a multi-char delimiter, limited to 4 spans.\n");
+    splits = str_split_spans(complex_str, complex_len, "*|*", 3, spans, 4);
+    printf("str_split_spans(%s, *|*): %d spans, err: %s\n", complex_str, splits, str_error(splits));
+    for (i = 0; splits > 0 && i < (size_t)splits; ++i)
+    {
+        printf("    [%d]: %.*s\n", (int)i, (int)spans[i].length, complex_str + spans[i].offset);
+    }
+
+    return (compare_with_str_split() < 0 || benchmark() < 0 || test_stream_splitter() < 0
+        || test_parallel_splitting() < 0 || test_builder_and_interning() < 0) ? -1 : 0;
 }
 
 #endif /* #ifdef TEST */
@@ -334,5 +1417,14 @@ int main(int argc, char **argv)
  * >>> 2023-11-08, Man Hung-Coeng:
  *  01. Eliminate the -Wmissing-braces warning caused by initialization of
  *      a 2-dimension array @buf in main() of test.
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Add str_split_spans() and str_splitter_*() for splitting into spans
+ *      of the original string without allocation or copying.
+ *  02. Search delimiters with memchr() and SSE2 instead of byte loops and strstr(),
+ *      which also fixes str_split() for strings not null-terminated at str_len.
+ *  03. Add str_stream_splitter_*() for splitting large files block by block.
+ *  04. Add str_split_parallel().
+ *  05. Add str_builder_*() and str_intern*().
  */
 
@@ -1,7 +1,7 @@
 /*
  * Supplements to string operation of ANSI C.
  *
- * Copyright (c) 2021 Man Hung-Coeng <udc577@126.com>
+ * Copyright (c) 2021-2026 Man Hung-Coeng <udc577@126.com>
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -35,6 +35,182 @@ int str_split_destroy(char **pptr);
 int str_split_to_fixed_buffer(const char *str, size_t str_len, const char *delimiter, size_t delimiter_len,
     char **buf, size_t buf_items, size_t capacity_per_item);
 
+/*
+ * ================
+ *  ZERO-COPY SPLITTING
+ * ================
+ */
+
+/* A token within the original string, which is not null-terminated. */
+typedef struct str_span_t
+{
+    size_t offset;
+    size_t length;
+} str_span_t;
+
+typedef struct str_splitter_t
+{
+    const char *str;
+    size_t str_len;
+    const char *delimiter;
+    size_t delimiter_len;
+    size_t pos; /* Greater than str_len after the last token. */
+} str_splitter_t;
+
+/*
+ * Neither the string nor the delimiter needs to be null-terminated, and both must outlive the splitter.
+ * Unlike str_split(), a string shorter than the delimiter is still split (into itself).
+ * Returns 0 on success, or -STR_ERR_ZERO_LENGTH if delimiter_len is 0.
+ */
+int str_splitter_init(str_splitter_t *splitter, const char *str, size_t str_len,
+    const char *delimiter, size_t delimiter_len);
+
+/*
+ * Returns 1 with the next token stored in span, or 0 if there's no more.
+ * N delimiters make N + 1 tokens, including empty ones.
+ */
+int str_splitter_next(str_splitter_t *splitter, str_span_t *span);
+
+/*
+ * Splits without any allocation or copying into at most span_count tokens,
+ * the last of which holds the rest of the string if there are more delimiters.
+ * Returns the number of tokens stored, or a negative error code.
+ */
+int str_split_spans(const char *str, size_t str_len, const char *delimiter, size_t delimiter_len,
+    str_span_t *spans, size_t span_count);
+
+/*
+ * Splits a huge buffer by parts in threads, each part beginning right after a delimiter,
+ * with the same result as str_split_spans() without limit, stored in *spans which should be released by free().
+ * Parts are at least 1 MiB each, so a smaller buffer is split in the current thread.
+ * Delimiters overlapping with themselves (e.g., "aa", "abab") are always split in one thread,
+ * because an occurrence found in the middle of the buffer may not be a real split point.
+ * Returns 0 on success, or a negative error code.
+ */
+int str_split_parallel(const char *str, size_t str_len, const char *delimiter, size_t delimiter_len,
+    int threads/* = 0 for the number of online CPUs */, str_span_t **spans, size_t *span_count);
+
+/*
+ * ================
+ *  STREAMING SPLITTING
+ * ================
+ */
+
+/*
+ * Splits what is read from a file descriptor block by block, e.g., a multi-GB CSV or log file,
+ * with memory bounded by the block size or the longest token.
+ * For a file mapped into memory, use str_splitter_*() on the mapping instead.
+ */
+typedef struct str_stream_splitter_t
+{
+    int fd;
+    const char *delimiter;
+    size_t delimiter_len;
+    char *buf;
+    size_t buf_size;
+    size_t head; /* Beginning of the current token. */
+    size_t scanned; /* Where searching for the delimiter goes on. */
+    size_t tail; /* End of data read. */
+    int state; /* 0: reading, 1: end of file, 2: finished. */
+} str_stream_splitter_t;
+
+/*
+ * The delimiter must outlive the splitter, and the fd is not closed by it.
+ * Returns 0 on success, or a negative error code.
+ */
+int str_stream_splitter_init(str_stream_splitter_t *splitter, int fd, const char *delimiter, size_t delimiter_len,
+    size_t block_size/* = 0 for 1 MiB */);
+
+/*
+ * Returns 1 with the next token stored in *token and *len, 0 if there's no more, or a negative error code.
+ * The token is not null-terminated, and is only valid until the next call.
+ * Tokens are the same as those from str_splitter_next() on the whole content.
+ */
+int str_stream_splitter_next(str_stream_splitter_t *splitter, const char **token, size_t *len);
+
+void str_stream_splitter_destroy(str_stream_splitter_t *splitter);
+
+/*
+ * ================
+ *  STRING BUILDER
+ * ================
+ */
+
+#ifndef STR_BUILDER_INLINE_SIZE
+#define STR_BUILDER_INLINE_SIZE     64
+#endif
+
+/*
+ * Strings shorter than STR_BUILDER_INLINE_SIZE are kept inside the struct without any allocation,
+ * and longer ones go to the heap, whose capacity grows geometrically.
+ * The result is always null-terminated. Use str_builder_cstr() rather than the fields.
+ */
+typedef struct str_builder_t
+{
+    char *heap; /* NULL if using inline_buf. */
+    size_t len;
+    size_t capacity; /* Including the null terminator. */
+    char inline_buf[STR_BUILDER_INLINE_SIZE];
+} str_builder_t;
+
+void str_builder_init(str_builder_t *builder);
+
+void str_builder_destroy(str_builder_t *builder);
+
+/* Empties the string but keeps the capacity for reuse. */
+void str_builder_clear(str_builder_t *builder);
+
+/* Makes room for extra_len more characters. Returns 0 on success or -STR_ERR_MEM_ALLOC. */
+int str_builder_reserve(str_builder_t *builder, size_t extra_len);
+
+/* These return 0 on success or a negative error code, with the string unchanged on failure. */
+int str_builder_append_n(str_builder_t *builder, const char *str, size_t len);
+
+int str_builder_append(str_builder_t *builder, const char *str);
+
+int str_builder_append_char(str_builder_t *builder, char ch);
+
+int str_builder_append_fmt(str_builder_t *builder, const char *fmt, ...)
+#ifdef __GNUC__
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+const char* str_builder_cstr(const str_builder_t *builder);
+
+size_t str_builder_len(const str_builder_t *builder);
+
+/*
+ * Hands over the string as a heap block to be released by free(), or returns NULL on allocation failure.
+ * The builder is empty afterwards and can be reused.
+ */
+char* str_builder_detach(str_builder_t *builder);
+
+/*
+ * ================
+ *  INTERNING
+ * ================
+ */
+
+/*
+ * Keeps one copy of each distinct string, e.g., keys repeated across many records,
+ * so that they can be stored as pointers and compared by ==.
+ * Copies are packed into large blocks, which are released only by str_intern_table_destroy().
+ */
+typedef struct str_intern_table_t str_intern_table_t;
+
+str_intern_table_t* str_intern_table_create(size_t expected_count/* = 0 if unknown */);
+
+void str_intern_table_destroy(str_intern_table_t *table);
+
+/*
+ * Returns the null-terminated copy of the string within the table, which is the same pointer
+ * for equal strings and lives until the table is destroyed, or NULL on allocation failure.
+ */
+const char* str_intern(str_intern_table_t *table, const char *str, size_t len);
+
+size_t str_intern_count(const str_intern_table_t *table);
+
 #ifdef __cplusplus
 }
 #endif
@@ -57,6 +233,13 @@ int str_split_to_fixed_buffer(const char *str, size_t str_len, const char *delim
  *      result only, and add a new one named str_split_to_fixed_buffer()
  *      for storing the result in the static buffer specified by the parameter.
  *  02. Add str_split_destroy() for releasing the memory from str_split().
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Add str_split_spans() and str_splitter_*() for splitting into spans
+ *      of the original string without allocation or copying.
+ *  02. Add str_stream_splitter_*() for splitting large files block by block.
+ *  03. Add str_split_parallel().
+ *  04. Add str_builder_*() and str_intern*().
  */
 
 
@@ -0,0 +1,411 @@
+/*
+ * Tests and a look-up benchmark of ini_map_c and ini_flat_map_c.
+ *
+ * Copyright (c) 2026 Man Hung-Coeng <udc577@126.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ini_map.hpp"
+#include "ini_flat_map.hpp"
+#include "ini_hot_config.hpp"
+
+static const int SECTION_COUNT = 64;
+static const int ITEM_COUNT = 32;
+static const int ROUNDS = 200;
+
+static std::string make_ini_text(void)
+{
+    std::string text("; generated for test\n");
+
+    for (int i = 0; i < SECTION_COUNT; ++i)
+    {
+        text += "[section" + std::to_string(i) + "]\n";
+        for (int j = 0; j < ITEM_COUNT; ++j)
+        {
+            text += "key" + std::to_string(j) + " = value" + std::to_string(i * ITEM_COUNT + j) + "\n";
+        }
+    }
+    text += "[section0]\nkey0 = repeated\nextra = merged\n";
+    text += "[typed]\nnumber = 0x20\nratio = 0.25\nenabled = On\ntimeout = 1.5s\nbuffer = 64KiB\nlabel = 5\xc3\xa9\n";
+
+    return text;
+}
+
+template<typename M>
+static long long benchmark(const M &map, const std::vector<std::pair<std::string, std::string>> &keys, size_t *checksum)
+{
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        for (auto &pair : keys)
+        {
+            *checksum += map[pair.first.c_str()][pair.second.c_str()][0];
+        }
+    }
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+}
+
+static bool throws(const ini_flat_map_c &map, const char *section, const char *key)
+{
+    try
+    {
+        (nullptr == key) ? (void)map[section] : (void)map[section][key];
+    }
+    catch (const std::invalid_argument &)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+template<typename F>
+static bool throws_invalid(F f)
+{
+    try
+    {
+        f();
+    }
+    catch (const std::invalid_argument &)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+static bool write_versioned_file(const char *path, int version)
+{
+    std::string tmp_path = std::string(path) + ".tmp";
+    FILE *stream = fopen(tmp_path.c_str(), "w");
+
+    if (nullptr == stream)
+        return false;
+
+    fprintf(stream, "[versioned]\na = %d\nb = %d\n", version, version);
+    fclose(stream);
+
+    return 0 == rename(tmp_path.c_str(), path); // Readers of the file never see a half-written one.
+}
+
+// Typed accessors of the same snapshot are called by several readers at the same time.
+static bool same_versions(const ini_map_c &map)
+{
+    return map.get<int>("versioned", "a") == map.get<int>("versioned", "b");
+}
+
+static bool same_versions(const ini_flat_map_c &map)
+{
+    return 0 == strcmp(map["versioned"]["a"], map["versioned"]["b"]);
+}
+
+template<typename M>
+static int hot_reload_test(const char *path)
+{
+    const int RELOAD_TIMES = 50;
+    std::atomic<bool> stopped(false);
+    std::atomic<int> errors(0);
+    std::vector<std::thread> readers;
+
+    if (!write_versioned_file(path, 0))
+        return -1;
+
+    ini_hot_config_c<M> cfg(path);
+
+    if (cfg.error_code() < 0 || 1 != cfg.version())
+        return -1;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        readers.push_back(std::thread([&cfg, &stopped, &errors]{
+            unsigned long last_version = 0;
+
+            while (!stopped.load())
+            {
+                auto snapshot = cfg.read();
+
+                // Both items must come from the same file, and versions must never go back.
+                if (!same_versions(*snapshot) || snapshot.version() < last_version)
+                    errors.fetch_add(1);
+                last_version = snapshot.version();
+            }
+        }));
+    }
+
+    for (int i = 1; i <= RELOAD_TIMES; ++i)
+    {
+        if (!write_versioned_file(path, i) || ((i % 2) ? cfg.reload() : cfg.reload_async().get()) < 0)
+            errors.fetch_add(1);
+    }
+
+    stopped = true;
+    for (auto &t : readers)
+    {
+        t.join();
+    }
+
+    if (0 != strcmp((*cfg.read())["versioned"]["a"], std::to_string(RELOAD_TIMES).c_str())
+        || (unsigned long)RELOAD_TIMES + 1 != cfg.version())
+        errors.fetch_add(1);
+
+    remove(path);
+
+    return (0 == errors.load()) ? 0 : -1;
+}
+
+static bool same_maps(const ini_map_c &map1, const ini_map_c &map2)
+{
+    size_t sec_count[2] = { 0, 0 };
+
+    for (auto &sec : map1)
+    {
+        size_t item_count = 0;
+
+        ++sec_count[0];
+        for (auto &item : sec.second)
+        {
+            ++item_count;
+            try
+            {
+                if (0 != strcmp(item.second, map2[sec.first][item.first]))
+                    return false;
+            }
+            catch (const std::invalid_argument &)
+            {
+                return false;
+            }
+        }
+        if (item_count != map2[sec.first].size())
+            return false;
+    }
+
+    for (auto &sec : map2)
+    {
+        (void)sec;
+        ++sec_count[1];
+    }
+
+    return sec_count[0] == sec_count[1];
+}
+
+static int sync_test(void)
+{
+    char text[] = "[a]\nx = 1\ny = 2\n[b]\nz = 3\n[c]\nw = 4\n";
+    ini_doc_t *doc = ini_parse_from_buffer(text, strlen(text), INI_PARSE_STRIP_BLANKS, nullptr);
+    size_t count = 0;
+    int err = -1;
+
+    if (nullptr == doc)
+        return -1;
+
+    {
+        ini_map_c map(doc);
+        ini_node_t *sec = ini_section_find(doc, "a", 0);
+
+        // Items added, modified and removed, and sections added, removed and renamed.
+        ini_item_set_value("10", 2, ini_item_find(sec, "x", 0));
+        ini_item_add("added", 5, "new", 3, sec);
+        ini_item_remove("y", 0, sec);
+        ini_section_add("d", 1, doc);
+        ini_item_add("k", 1, "on", 2, ini_section_find(doc, "d", 0));
+        ini_section_remove("b", 0, doc);
+        ini_section_rename("c2", 2, (sec = ini_section_find(doc, "c", 0)));
+        ini_item_set_key("w2", 2, ini_item_find(sec, "w", 0));
+
+        if (nullptr == ini_changes_since(doc, 0, &count) || 0 == count || map.sync() < 0)
+            goto TEST_END;
+
+        {
+            ini_map_c rebuilt(doc);
+
+            if (rebuilt.error_code() < 0 || !same_maps(map, rebuilt) || !same_maps(rebuilt, map)
+                || 10 != map.get<int>("a", "x") || 4 != map.get<int>("c2", "w2") || !map.get<bool>("d", "k"))
+                goto TEST_END;
+        }
+
+        // Tracking stays on for this map after the rebuilt one is gone.
+        ini_item_set_value("11", 2, ini_item_find(ini_section_find(doc, "a", 0), "x", 0));
+        if (map.sync() < 0 || 11 != map.get<int>("a", "x"))
+            goto TEST_END;
+
+        // Strings replaced meanwhile stay readable by a map until it syncs, even if another one syncs first.
+        {
+            ini_map_c other(doc);
+            const char *old_value = other["a"]["x"];
+
+            ini_item_set_value("12", 2, ini_item_find(ini_section_find(doc, "a", 0), "x", 0));
+            if (map.sync() < 0 || 0 != strcmp(old_value, "11")
+                || other.sync() < 0 || 12 != other.get<int>("a", "x") || map.sync() < 0 || 12 != map.get<int>("a", "x"))
+                goto TEST_END;
+        }
+
+        err = 0;
+    }
+
+TEST_END:
+
+    // Nobody tracks changes once all maps are gone.
+    if (0 == err && nullptr != ini_changes_since(doc, 0, &count))
+        err = -1;
+    ini_destroy(doc);
+
+    return err;
+}
+
+/* Maps must be destroyed ahead of the document, so they live in here. */
+static int map_test(ini_doc_t *doc)
+{
+    std::vector<std::pair<std::string, std::string>> keys;
+    size_t checksums[2] = { 0, 0 };
+    long long nanoseconds[2];
+    int err = 0;
+    ini_map_c map(doc);
+    ini_flat_map_c flat_map(doc);
+
+    if (map.error_code() < 0 || flat_map.error_code() < 0)
+    {
+        std::cerr << "Failed to build maps: " << map.error_string() << ", " << flat_map.error_string() << std::endl;
+        err = -1;
+        goto TEST_END;
+    }
+
+    for (auto &sec : map)
+    {
+        if (sec.second.size() != flat_map[sec.first].size())
+        {
+            std::cerr << "Item count mismatched in section [" << sec.first << "]" << std::endl;
+            err = -1;
+            goto TEST_END;
+        }
+
+        for (auto &item : sec.second)
+        {
+            if (0 != strcmp(item.second, flat_map[sec.first][item.first]))
+            {
+                std::cerr << "Value mismatched: [" << sec.first << "] " << item.first << std::endl;
+                err = -1;
+                goto TEST_END;
+            }
+            keys.push_back(std::make_pair(std::string(sec.first), std::string(item.first)));
+        }
+    }
+
+    if (flat_map.size() != (size_t)SECTION_COUNT + 1)
+        err = -1;
+    else if (0 != strcmp(flat_map["section0"]["key0"], "value0") || 0 != strcmp(flat_map["section0"]["extra"], "merged"))
+        err = -1;
+    else if (!throws(flat_map, "section", nullptr) || !throws(flat_map, "section1", "extra") || !throws(flat_map, nullptr, nullptr))
+        err = -1;
+    if (err < 0)
+    {
+        std::cerr << "Repeated or missing sections/items are not handled as ini_map_c does." << std::endl;
+        goto TEST_END;
+    }
+
+    try
+    {
+        if (32 != map.get<int>("typed", "number") || 0.25 != map.get<double>("typed", "ratio")
+            || !map.get<bool>("typed", "enabled") || 1500 != map.get<std::chrono::milliseconds>("typed", "timeout").count()
+            || 64 * 1024 != map.get_size("typed", "buffer") || 32 != map.get<unsigned char>("typed", "number"))
+            err = -1;
+        map.get<int>("section0", "key0");
+        err = -1;
+    }
+    catch (const std::invalid_argument &e)
+    {
+        if (nullptr == strstr(e.what(), "value0"))
+            err = -1;
+    }
+    // Bytes of UTF-8 text are beyond ASCII, and must be classified as nothing of a boolean, a unit or a size.
+    if (!throws_invalid([&map]{ map.get<bool>("typed", "label"); })
+        || !throws_invalid([&map]{ map.get<std::chrono::seconds>("typed", "label"); })
+        || !throws_invalid([&map]{ map.get_size("typed", "label"); }))
+        err = -1;
+    if (err < 0)
+    {
+        std::cerr << "Typed accessors of ini_map_c returned unexpected results." << std::endl;
+        goto TEST_END;
+    }
+
+    if ((err = hot_reload_test<ini_map_c>("test_ini_hot_config.ini")) < 0
+        || (err = hot_reload_test<ini_flat_map_c>("test_ini_hot_config.ini")) < 0)
+    {
+        std::cerr << "Hot reloading test of ini_hot_config_c failed." << std::endl;
+        goto TEST_END;
+    }
+
+    nanoseconds[0] = benchmark(map, keys, &checksums[0]);
+    nanoseconds[1] = benchmark(flat_map, keys, &checksums[1]);
+    if (checksums[0] != checksums[1])
+    {
+        std::cerr << "Checksums mismatched: " << checksums[0] << " vs " << checksums[1] << std::endl;
+        err = -1;
+        goto TEST_END;
+    }
+
+    std::cout << "Look-ups: " << keys.size() * ROUNDS << std::endl;
+    std::cout << "ini_map_c:      " << (double)nanoseconds[0] / (keys.size() * ROUNDS) << " ns/look-up" << std::endl;
+    std::cout << "ini_flat_map_c: " << (double)nanoseconds[1] / (keys.size() * ROUNDS) << " ns/look-up" << std::endl;
+
+TEST_END:
+
+    return err;
+}
+
+int main(int argc, char **argv)
+{
+    std::string text = make_ini_text();
+    std::vector<char> buf(text.begin(), text.end());
+    ini_summary_t summary;
+    ini_doc_t *doc = ini_parse_from_buffer(buf.data(), buf.size(), INI_PARSE_STRIP_BLANKS, &summary);
+    int err = 0;
+
+    if (nullptr == doc)
+    {
+        std::cerr << "Failed to parse the generated text: " << ini_error(summary.error_code) << std::endl;
+
+        return -1;
+    }
+
+    err = map_test(doc);
+    ini_destroy(doc);
+
+    if (0 == err && (err = sync_test()) < 0)
+        std::cerr << "ini_map_c::sync() does not match a full rebuild." << std::endl;
+
+    return err;
+}
+
+/*
+ * ================
+ *   CHANGE LOG
+ * ================
+ *
+ * >>> 2026-10-18, Man Hung-Coeng:
+ *  01. Create.
+ *  02. Add a test of ini_map_c::sync(), and destroy maps ahead of their document.
+ *  03. Call typed accessors concurrently in the hot reloading test. *  04. Test syncing several maps of the same document.
+ *  05. Test typed accessors on UTF-8 values.
+ */